@@ -0,0 +1,66 @@
+#include "AssetCache.h"
+
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+#ifdef _WIN32
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
+
+const std::string& AssetCache::directory() {
+	static const std::string cacheDirectory = "cache";
+	return cacheDirectory;
+}
+
+std::string AssetCache::pathFor(const std::string& sourcePath, const std::string& extension) {
+	std::error_code error;
+	std::filesystem::create_directories(directory(), error);
+
+	std::string flatName = sourcePath;
+	for (char& c : flatName) {
+		if (c == '/' || c == '\\' || c == ':') {
+			c = '_';
+		}
+	}
+
+	return directory() + "/" + flatName + extension;
+}
+
+bool AssetCache::writeFile(const std::string& path, const void* data, size_t size) {
+	// Svaki pisac ima svoj privremeni fajl (proces + nit), pa dva pisca istog kljuca ne skracuju
+	// jedan drugome fajl; rename objavljuje ceo fajl jednog od njih.
+	std::ostringstream temporaryName;
+	temporaryName << path << "." << getpid() << "." << std::hash<std::thread::id>()(std::this_thread::get_id()) << ".tmp";
+	std::string temporaryPath = temporaryName.str();
+	std::error_code error;
+
+	{
+		std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+		if (!file) {
+			std::cerr << "CACHE::ne mogu da otvorim za pisanje: " << temporaryPath << std::endl;
+			return false;
+		}
+		file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+		file.close();
+		if (!file) {
+			std::cerr << "CACHE::pisanje nije uspelo: " << temporaryPath << std::endl;
+			std::filesystem::remove(temporaryPath, error);
+			return false;
+		}
+	}
+
+	std::filesystem::rename(temporaryPath, path, error);
+	if (error) {
+		std::cerr << "CACHE::rename nije uspeo: " << path << " (" << error.message() << ")" << std::endl;
+		std::filesystem::remove(temporaryPath, error);
+		return false;
+	}
+	return true;
+}
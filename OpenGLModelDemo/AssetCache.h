@@ -0,0 +1,24 @@
+#ifndef _MOJ_ASSET_CACHE_H_
+#define _MOJ_ASSET_CACHE_H_
+
+#include <cstddef>
+#include <string>
+
+// Folder u kome se cuvaju "skuvani" (cooked) asset-i izvedeni iz izvornih fajlova.
+// Sve se moze obrisati u svakom trenutku, regenerise se pri sledecem ucitavanju.
+class AssetCache {
+public:
+
+	// cache/<putanja izvora sa '/' zamenjenim sa '_'><extension>
+	// Pravi cache folder ako jos ne postoji.
+	static std::string pathFor(const std::string& sourcePath, const std::string& extension);
+
+	// Writes into a temporary file unique to this process and thread, then renames it over the target,
+	// so a crash, a concurrent reader or another writer of the same path never sees a half written file.
+	static bool writeFile(const std::string& path, const void* data, size_t size);
+
+	static const std::string& directory();
+
+};
+
+#endif
@@ -0,0 +1,83 @@
+#ifndef _MOJ_BOUNDS_H_
+#define _MOJ_BOUNDS_H_
+
+#include "glm/glm.hpp"
+
+#include <cfloat>
+
+// Osno poravnata kutija (AABB). Prazna kutija ima min > max i ne sece nista.
+struct AABB {
+	glm::vec3 min = glm::vec3(FLT_MAX);
+	glm::vec3 max = glm::vec3(-FLT_MAX);
+
+	bool empty() const { return min.x > max.x; }
+
+	void expand(const glm::vec3& point) {
+		min = glm::min(min, point);
+		max = glm::max(max, point);
+	}
+
+	void expand(const AABB& other) {
+		min = glm::min(min, other.min);
+		max = glm::max(max, other.max);
+	}
+
+	// Kutija oko transformisane kutije: centar ide kroz matricu, poluprecnik kroz |M| (Arvo),
+	// bez transformisanja svih 8 temena.
+	AABB transformed(const glm::mat4& m) const {
+		if (empty()) return AABB();
+
+		glm::vec3 center = (min + max) * 0.5f;
+		glm::vec3 extent = (max - min) * 0.5f;
+
+		glm::vec3 newCenter = glm::vec3(m * glm::vec4(center, 1.0f));
+		glm::vec3 newExtent = glm::abs(glm::vec3(m[0])) * extent.x
+			+ glm::abs(glm::vec3(m[1])) * extent.y
+			+ glm::abs(glm::vec3(m[2])) * extent.z;
+
+		AABB result;
+		result.min = newCenter - newExtent;
+		result.max = newCenter + newExtent;
+		return result;
+	}
+};
+
+// Six planes of a view-projection matrix (Gribb/Hartmann), normals pointing inwards.
+struct Frustum {
+	glm::vec4 planes[6];
+
+	Frustum() = default;
+
+	explicit Frustum(const glm::mat4& viewProjection) {
+		// glm je column-major, red i je (m[0][i], m[1][i], m[2][i], m[3][i])
+		glm::vec4 row0(viewProjection[0][0], viewProjection[1][0], viewProjection[2][0], viewProjection[3][0]);
+		glm::vec4 row1(viewProjection[0][1], viewProjection[1][1], viewProjection[2][1], viewProjection[3][1]);
+		glm::vec4 row2(viewProjection[0][2], viewProjection[1][2], viewProjection[2][2], viewProjection[3][2]);
+		glm::vec4 row3(viewProjection[0][3], viewProjection[1][3], viewProjection[2][3], viewProjection[3][3]);
+
+		planes[0] = row3 + row0; // levo
+		planes[1] = row3 - row0; // desno
+		planes[2] = row3 + row1; // dole
+		planes[3] = row3 - row1; // gore
+		planes[4] = row3 + row2; // blizu
+		planes[5] = row3 - row2; // daleko
+	}
+
+	// False only when the box is certainly outside: entirely behind one of the planes.
+	// Conservative near the frustum corners, which only costs an extra draw.
+	bool intersects(const AABB& box) const {
+		if (box.empty()) return false;
+
+		for (const glm::vec4& plane : planes) {
+			// teme kutije najdalje u smeru normale
+			glm::vec3 positive(
+				plane.x >= 0.0f ? box.max.x : box.min.x,
+				plane.y >= 0.0f ? box.max.y : box.min.y,
+				plane.z >= 0.0f ? box.max.z : box.min.z);
+			if (glm::dot(glm::vec3(plane), positive) + plane.w < 0.0f) return false;
+		}
+		return true;
+	}
+};
+
+#endif
@@ -133,6 +133,22 @@ void Camera::processKeyboardCamMovement(bool forward, bool backward, bool left,
 	this->cameraPos += velocity * direction;
 }
 
+void Camera::lookAt(const glm::vec3& position, const glm::vec3& target) {
+	glm::vec3 direction = glm::normalize(target - position);
+
+	this->cameraPos = position;
+	this->pitch = glm::degrees(asin(glm::clamp(direction.y, -1.0f, 1.0f)));
+	this->yaw = glm::degrees(atan2(direction.z, direction.x));
+
+	if (this->pitch > 89.0f) {
+		this->pitch = 89.0f;
+	}
+	else if (this->pitch < -89.0f) {
+		this->pitch = -89.0f;
+	}
+
+	updateCameraVectors();
+}
 
 void Camera::updateCameraVectors() {
 	glm::vec3 frontDirection = glm::vec3(1);
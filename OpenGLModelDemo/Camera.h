@@ -65,6 +65,9 @@ public:
 	// pomeranje koje je iste brzine i po dijagonalama. koristiti ovo umesto processkeyboardmovement
 	void processKeyboardCamMovement(bool forward, bool backward, bool left, bool right, float deltaTime);
 
+	// places the camera at position and points it at target (used by the benchmark camera path)
+	void lookAt(const glm::vec3& position, const glm::vec3& target);
+
 private:
 	
 	void updateCameraVectors();
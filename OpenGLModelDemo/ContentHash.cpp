@@ -0,0 +1,113 @@
+#include "ContentHash.h"
+#include "MappedFile.h"
+
+#include <cstring>
+
+static const uint64_t PRIME1 = 11400714785074694791ULL;
+static const uint64_t PRIME2 = 14029467366897019727ULL;
+static const uint64_t PRIME3 = 1609587929392839161ULL;
+static const uint64_t PRIME4 = 9650029242287828579ULL;
+static const uint64_t PRIME5 = 2870177450012600261ULL;
+
+static inline uint64_t rotl(uint64_t x, int r) {
+	return (x << r) | (x >> (64 - r));
+}
+
+static inline uint64_t read64(const unsigned char* p) {
+	uint64_t v;
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+static inline uint32_t read32(const unsigned char* p) {
+	uint32_t v;
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+static inline uint64_t xxhRound(uint64_t acc, uint64_t input) {
+	acc += input * PRIME2;
+	acc = rotl(acc, 31);
+	return acc * PRIME1;
+}
+
+static inline uint64_t xxhMergeRound(uint64_t acc, uint64_t val) {
+	acc ^= xxhRound(0, val);
+	return acc * PRIME1 + PRIME4;
+}
+
+uint64_t contentHash64(const void* data, size_t size, uint64_t seed) {
+	const unsigned char* p = static_cast<const unsigned char*>(data);
+	const unsigned char* end = p + size;
+	uint64_t h;
+
+	if (size >= 32) {
+		const unsigned char* limit = end - 32;
+		uint64_t v1 = seed + PRIME1 + PRIME2;
+		uint64_t v2 = seed + PRIME2;
+		uint64_t v3 = seed;
+		uint64_t v4 = seed - PRIME1;
+
+		do {
+			v1 = xxhRound(v1, read64(p)); p += 8;
+			v2 = xxhRound(v2, read64(p)); p += 8;
+			v3 = xxhRound(v3, read64(p)); p += 8;
+			v4 = xxhRound(v4, read64(p)); p += 8;
+		} while (p <= limit);
+
+		h = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+		h = xxhMergeRound(h, v1);
+		h = xxhMergeRound(h, v2);
+		h = xxhMergeRound(h, v3);
+		h = xxhMergeRound(h, v4);
+	}
+	else {
+		h = seed + PRIME5;
+	}
+
+	h += static_cast<uint64_t>(size);
+
+	while (p + 8 <= end) {
+		h ^= xxhRound(0, read64(p));
+		h = rotl(h, 27) * PRIME1 + PRIME4;
+		p += 8;
+	}
+
+	if (p + 4 <= end) {
+		h ^= static_cast<uint64_t>(read32(p)) * PRIME1;
+		h = rotl(h, 23) * PRIME2 + PRIME3;
+		p += 4;
+	}
+
+	while (p < end) {
+		h ^= (*p) * PRIME5;
+		h = rotl(h, 11) * PRIME1;
+		p++;
+	}
+
+	h ^= h >> 33;
+	h *= PRIME2;
+	h ^= h >> 29;
+	h *= PRIME3;
+	h ^= h >> 32;
+	return h;
+}
+
+bool hashFile(const std::string& path, uint64_t& hash) {
+	MappedFile file(path);
+	if (!file.isOpen()) {
+		return false;
+	}
+	hash = contentHash64(file.data(), file.size());
+	return true;
+}
+
+std::string hashToHex(uint64_t hash) {
+	static const char digits[] = "0123456789abcdef";
+	std::string hex(16, '0');
+	for (int i = 15; i >= 0; i--) {
+		hex[i] = digits[hash & 0xF];
+		hash >>= 4;
+	}
+	return hex;
+}
@@ -0,0 +1,17 @@
+#ifndef _MOJ_CONTENT_HASH_H_
+#define _MOJ_CONTENT_HASH_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// 64-bit xxHash (XXH64) sadrzaja, koristi se za invalidaciju kesiranih asset-a.
+uint64_t contentHash64(const void* data, size_t size, uint64_t seed = 0);
+
+// hash celog fajla, false ako fajl ne moze da se procita
+bool hashFile(const std::string& path, uint64_t& hash);
+
+// 16 hex cifara, za imena fajlova u kesu
+std::string hashToHex(uint64_t hash);
+
+#endif
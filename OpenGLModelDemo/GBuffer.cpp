@@ -0,0 +1,125 @@
+#include "GBuffer.h"
+#include "RenderStats.h"
+
+#include <iostream>
+
+// tekstura bez mipmapa, cita se samo texelFetch-om
+static GLuint createTarget() {
+	GLuint texture;
+	glGenTextures(1, &texture);
+	glBindTexture(GL_TEXTURE_2D, texture);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	return texture;
+}
+
+GBuffer::GBuffer(const LightBuffer& lights) {
+	diffuseTexture = createTarget();
+	specularTexture = createTarget();
+	normalTexture = createTarget();
+	depthTexture = createTarget();
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	glGenFramebuffers(1, &fbo);
+	glGenVertexArrays(1, &emptyVAO);
+
+	lightingShader = new Shader("shaders/deferred.vs", "shaders/deferred.fs");
+	lights.attach(*lightingShader);
+
+	lightingShader->use();
+	lightingShader->setInt("gDiffuse", DIFFUSE_UNIT);
+	lightingShader->setInt("gSpecular", SPECULAR_UNIT);
+	lightingShader->setInt("gNormal", NORMAL_UNIT);
+	lightingShader->setInt("gDepth", DEPTH_UNIT);
+	inverseProjectionUniform = lightingShader->uniform("inverseProjection"_uniform);
+	pixelSizeUniform = lightingShader->uniform("pixelSize"_uniform);
+}
+
+GBuffer::~GBuffer() {
+	delete lightingShader;
+
+	GLuint textures[] = { diffuseTexture, specularTexture, normalTexture, depthTexture };
+	glDeleteTextures(4, textures);
+	glDeleteFramebuffers(1, &fbo);
+	glDeleteVertexArrays(1, &emptyVAO);
+}
+
+void GBuffer::allocate(int newWidth, int newHeight) {
+	width = newWidth;
+	height = newHeight;
+
+	// normale u half float-u; boje su iz 8-bitnih tekstura, pa im vise od RGBA8 ne treba
+	glBindTexture(GL_TEXTURE_2D, diffuseTexture);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+	glBindTexture(GL_TEXTURE_2D, specularTexture);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+	glBindTexture(GL_TEXTURE_2D, normalTexture);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, width, height, 0, GL_RGBA, GL_HALF_FLOAT, NULL);
+	// isti format kao dubina prozora i HeadlessContext-a, inace glBlitFramebuffer ne kopira dubinu
+	glBindTexture(GL_TEXTURE_2D, depthTexture);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH24_STENCIL8, width, height, 0, GL_DEPTH_STENCIL, GL_UNSIGNED_INT_24_8, NULL);
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, diffuseTexture, 0);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, specularTexture, 0);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT2, GL_TEXTURE_2D, normalTexture, 0);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_TEXTURE_2D, depthTexture, 0);
+
+	const GLenum drawBuffers[] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1, GL_COLOR_ATTACHMENT2 };
+	glDrawBuffers(3, drawBuffers);
+
+	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+		std::cout << "GBUFFER::framebuffer nije kompletan (" << width << "x" << height << ")" << std::endl;
+	}
+}
+
+void GBuffer::begin(int newWidth, int newHeight) {
+	glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &targetFramebuffer);
+
+	if (newWidth != width || newHeight != height) {
+		allocate(newWidth, newHeight);
+	}
+
+	glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+	// boje ne treba cistiti: resolve() cita samo piksele koje je nesto nacrtalo (dubina < 1)
+	glClear(GL_DEPTH_BUFFER_BIT);
+}
+
+void GBuffer::resolve(const glm::mat4& projection) {
+	glBindFramebuffer(GL_FRAMEBUFFER, targetFramebuffer);
+
+	glActiveTexture(GL_TEXTURE0 + DIFFUSE_UNIT);
+	glBindTexture(GL_TEXTURE_2D, diffuseTexture);
+	glActiveTexture(GL_TEXTURE0 + SPECULAR_UNIT);
+	glBindTexture(GL_TEXTURE_2D, specularTexture);
+	glActiveTexture(GL_TEXTURE0 + NORMAL_UNIT);
+	glBindTexture(GL_TEXTURE_2D, normalTexture);
+	glActiveTexture(GL_TEXTURE0 + DEPTH_UNIT);
+	glBindTexture(GL_TEXTURE_2D, depthTexture);
+	glActiveTexture(GL_TEXTURE0);
+
+	lightingShader->use();
+	lightingShader->setMat4(inverseProjectionUniform, glm::inverse(projection));
+	lightingShader->setVec2(pixelSizeUniform, glm::vec2(1.0f / width, 1.0f / height));
+
+	// prvo dubina scene, pa trougao na dalekoj ravni prolazi test samo gde je nesto nacrtano;
+	// pozadina se odbacuje pre shadera, a discard u shaderu ne bi ustedeo nista na llvmpipe-u
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo);
+	glBlitFramebuffer(0, 0, width, height, 0, 0, width, height, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+	glBindFramebuffer(GL_FRAMEBUFFER, targetFramebuffer);
+
+	glDepthFunc(GL_GREATER);
+	glDepthMask(GL_FALSE);
+	glBindVertexArray(emptyVAO);
+	glDrawArrays(GL_TRIANGLES, 0, 3);
+	glBindVertexArray(0);
+	glDepthMask(GL_TRUE);
+	glDepthFunc(GL_LESS);
+
+	RenderStats& stats = RenderStats::getInstance();
+	stats.drawCalls++;
+	stats.triangles++;
+}
@@ -0,0 +1,60 @@
+#ifndef _MOJ_GBUFFER_H_
+#define _MOJ_GBUFFER_H_
+
+#include "glad/glad.h"
+#include "glm/glm.hpp"
+
+#include "LightBuffer.h"
+#include "Shader.h"
+
+// Deferred shading. Mape se crtaju GBUFFER varijantama shadera u teksture ovog FBO-a (raspored je
+// u shaders/gbuffer.glsl): difuzna boja, specular boja i shininess, view-space normala, dubina.
+// resolve() onda jednim trouglom preko ekrana racuna svetla za svaki piksel tacno jednom,
+// sa istim klasterima point svetala kao forward put, pa cena ne zavisi od preklapanja geometrije.
+// Providni draw-ovi ne mogu u G-buffer; oni bi se crtali forward, posle resolve().
+class GBuffer {
+	typedef unsigned int uint;
+public:
+
+	// unit-i G-buffer tekstura u deferred.fs; unit-e materijala RenderQueue ponovo vezuje u sledecem submit-u
+	static const uint DIFFUSE_UNIT = 0;
+	static const uint SPECULAR_UNIT = 1;
+	static const uint NORMAL_UNIT = 2;
+	static const uint DEPTH_UNIT = 3;
+
+	// Kompajlira deferred.vs/.fs i vezuje ga za svetla; zahteva aktivan OpenGL kontekst.
+	explicit GBuffer(const LightBuffer& lights);
+
+	~GBuffer();
+
+	GBuffer(const GBuffer&) = delete;
+	GBuffer& operator=(const GBuffer&) = delete;
+
+	// Pamti framebuffer u koji se crta, binduje G-buffer (teksture prate velicinu viewport-a) i cisti mu dubinu.
+	void begin(int width, int height);
+
+	// Kopira dubinu scene u framebuffer zapamcen u begin() i racuna svetla samo gde je nesto nacrtano:
+	// pozadina ostaje ociscena, a ono sto se crta posle se testira kao posle forward prolaza.
+	void resolve(const glm::mat4& projection);
+
+private:
+
+	uint fbo = 0;
+	uint diffuseTexture = 0, specularTexture = 0, normalTexture = 0, depthTexture = 0;
+
+	// deferred.vs ne cita verteks-e, ali core profil trazi vezan VAO
+	uint emptyVAO = 0;
+
+	int width = 0, height = 0;
+
+	GLint targetFramebuffer = 0;
+
+	Shader* lightingShader;
+	Uniform inverseProjectionUniform, pixelSizeUniform;
+
+	// (ponovo) pravi teksture za novu velicinu
+	void allocate(int newWidth, int newHeight);
+
+};
+
+#endif
@@ -0,0 +1,146 @@
+#include "HeadlessContext.h"
+#include "Shader.h"
+
+// bez X11 zaglavlja, ne trebaju nam i prljaju namespace (None, Status, Bool...)
+#define EGL_NO_X11
+#define MESA_EGL_NO_X11_HEADERS
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#include <iostream>
+
+#ifndef EGL_PLATFORM_SURFACELESS_MESA
+#define EGL_PLATFORM_SURFACELESS_MESA 0x31DD
+#endif
+
+HeadlessContext::HeadlessContext(int width, int height) : fbWidth(width), fbHeight(height) {
+	if (!createContext()) {
+		return;
+	}
+
+	if (!gladLoadGLLoader((GLADloadproc)eglGetProcAddress)) {
+		std::cerr << "HEADLESS::glad nije uspeo da ucita OpenGL funkcije" << std::endl;
+		return;
+	}
+	Shader::loadProgramBinarySupport((GLADloadproc)eglGetProcAddress);
+
+	if (!createFramebuffer()) {
+		return;
+	}
+
+	valid = true;
+}
+
+HeadlessContext::~HeadlessContext() {
+	if (fbo) {
+		glDeleteFramebuffers(1, &fbo);
+		glDeleteRenderbuffers(1, &colorRenderbuffer);
+		glDeleteRenderbuffers(1, &depthRenderbuffer);
+	}
+
+	EGLDisplay eglDisplay = static_cast<EGLDisplay>(display);
+	if (eglDisplay != EGL_NO_DISPLAY) {
+		eglMakeCurrent(eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+		if (context) eglDestroyContext(eglDisplay, static_cast<EGLContext>(context));
+		if (surface) eglDestroySurface(eglDisplay, static_cast<EGLSurface>(surface));
+		eglTerminate(eglDisplay);
+	}
+}
+
+bool HeadlessContext::createContext() {
+	EGLDisplay eglDisplay = EGL_NO_DISPLAY;
+
+	// Mesa surfaceless: nije potreban ni X ni DRM uredjaj
+	PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+		(PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+	if (getPlatformDisplay) {
+		eglDisplay = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+	}
+
+	EGLint major, minor;
+	bool surfaceless = eglDisplay != EGL_NO_DISPLAY && eglInitialize(eglDisplay, &major, &minor);
+	if (!surfaceless) {
+		eglDisplay = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+		if (eglDisplay == EGL_NO_DISPLAY || !eglInitialize(eglDisplay, &major, &minor)) {
+			std::cerr << "HEADLESS::EGL display nije dostupan, error: 0x" << std::hex << eglGetError() << std::dec << std::endl;
+			return false;
+		}
+	}
+	display = eglDisplay;
+
+	if (!eglBindAPI(EGL_OPENGL_API)) {
+		std::cerr << "HEADLESS::EGL ne podrzava desktop OpenGL" << std::endl;
+		return false;
+	}
+
+	const EGLint configAttribs[] = {
+		EGL_SURFACE_TYPE, surfaceless ? 0 : EGL_PBUFFER_BIT,
+		EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+		EGL_RED_SIZE, 8,
+		EGL_GREEN_SIZE, 8,
+		EGL_BLUE_SIZE, 8,
+		EGL_NONE
+	};
+
+	EGLConfig config = nullptr;
+	EGLint numConfigs = 0;
+	eglChooseConfig(eglDisplay, configAttribs, &config, 1, &numConfigs);
+
+	const EGLint contextAttribs[] = {
+		EGL_CONTEXT_MAJOR_VERSION, 3,
+		EGL_CONTEXT_MINOR_VERSION, 3,
+		EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+		EGL_NONE
+	};
+
+	EGLContext eglContext = eglCreateContext(eglDisplay, numConfigs > 0 ? config : (EGLConfig)0, EGL_NO_CONTEXT, contextAttribs);
+	if (eglContext == EGL_NO_CONTEXT) {
+		std::cerr << "HEADLESS::kreiranje GL 3.3 core konteksta nije uspelo, error: 0x" << std::hex << eglGetError() << std::dec << std::endl;
+		return false;
+	}
+	context = eglContext;
+
+	EGLSurface eglSurface = EGL_NO_SURFACE;
+	if (!surfaceless && numConfigs > 0) {
+		// pbuffer je samo tu da bi makeCurrent prosao, crta se u FBO
+		const EGLint pbufferAttribs[] = { EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE };
+		eglSurface = eglCreatePbufferSurface(eglDisplay, config, pbufferAttribs);
+		surface = eglSurface;
+	}
+
+	if (!eglMakeCurrent(eglDisplay, eglSurface, eglSurface, eglContext)) {
+		std::cerr << "HEADLESS::eglMakeCurrent nije uspeo, error: 0x" << std::hex << eglGetError() << std::dec << std::endl;
+		return false;
+	}
+
+	return true;
+}
+
+bool HeadlessContext::createFramebuffer() {
+	glGenFramebuffers(1, &fbo);
+	glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+
+	glGenRenderbuffers(1, &colorRenderbuffer);
+	glBindRenderbuffer(GL_RENDERBUFFER, colorRenderbuffer);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, fbWidth, fbHeight);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorRenderbuffer);
+
+	glGenRenderbuffers(1, &depthRenderbuffer);
+	glBindRenderbuffer(GL_RENDERBUFFER, depthRenderbuffer);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, fbWidth, fbHeight);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depthRenderbuffer);
+
+	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+		std::cerr << "HEADLESS::framebuffer nije kompletan" << std::endl;
+		return false;
+	}
+
+	glViewport(0, 0, fbWidth, fbHeight);
+	return true;
+}
+
+std::string HeadlessContext::rendererName() const {
+	const char* renderer = reinterpret_cast<const char*>(glGetString(GL_RENDERER));
+	const char* version = reinterpret_cast<const char*>(glGetString(GL_VERSION));
+	return std::string(renderer ? renderer : "unknown") + " | " + std::string(version ? version : "unknown");
+}
@@ -0,0 +1,50 @@
+#ifndef _HEADLESS_CONTEXT_H_
+#define _HEADLESS_CONTEXT_H_
+
+#include "glad/glad.h"
+
+#include <string>
+
+// OpenGL 3.3 core kontekst bez prozora (EGL).
+// Prvo probava Mesa surfaceless platformu (radi i sa llvmpipe na masinama bez GPU-a),
+// a ako nje nema, podrazumevani EGL display sa malim pbuffer-om.
+// Crta se u FBO velicine width x height koji se binduje umesto default framebuffer-a.
+class HeadlessContext {
+	typedef unsigned int uint;
+public:
+
+	HeadlessContext(int width, int height);
+
+	~HeadlessContext();
+
+	bool isValid() const { return valid; }
+
+	// framebuffer koji zamenjuje prozor
+	uint framebuffer() const { return fbo; }
+
+	int width() const { return fbWidth; }
+
+	int height() const { return fbHeight; }
+
+	// GL_RENDERER / GL_VERSION, for reports
+	std::string rendererName() const;
+
+private:
+
+	bool valid = false;
+
+	// EGLDisplay, EGLContext, EGLSurface. Kept opaque so EGL headers stay out of this header.
+	void* display = nullptr;
+	void* context = nullptr;
+	void* surface = nullptr;
+
+	int fbWidth, fbHeight;
+	uint fbo = 0, colorRenderbuffer = 0, depthRenderbuffer = 0;
+
+	bool createContext();
+
+	bool createFramebuffer();
+
+};
+
+#endif
@@ -0,0 +1,333 @@
+#include "Ktx2.h"
+#include "AssetCache.h"
+#include "MappedFile.h"
+
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+static const unsigned char KTX2_IDENTIFIER[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+
+// VkFormat
+static const uint32_t VK_FORMAT_R8_UNORM = 9;
+static const uint32_t VK_FORMAT_R8G8_UNORM = 16;
+static const uint32_t VK_FORMAT_R8G8B8_UNORM = 23;
+static const uint32_t VK_FORMAT_R8G8B8A8_UNORM = 37;
+static const uint32_t VK_FORMAT_BC1_RGB_UNORM_BLOCK = 131;
+static const uint32_t VK_FORMAT_BC3_UNORM_BLOCK = 137;
+static const uint32_t VK_FORMAT_BC4_UNORM_BLOCK = 139;
+
+// Khronos Data Format, basic descriptor block
+static const uint32_t KHR_DF_MODEL_RGBSDA = 1;
+static const uint32_t KHR_DF_MODEL_BC1A = 128;
+static const uint32_t KHR_DF_MODEL_BC3 = 130;
+static const uint32_t KHR_DF_MODEL_BC4 = 131;
+static const uint32_t KHR_DF_PRIMARIES_BT709 = 1;
+static const uint32_t KHR_DF_TRANSFER_LINEAR = 1;
+static const uint32_t KHR_DF_CHANNEL_BC3_ALPHA = 15;
+static const uint32_t KHR_DF_CHANNEL_RGBSDA_ALPHA = 15;
+
+static const char SOURCE_KEY_NAME[] = "OGLDemoSourceKey";
+static const char WRITER_NAME[] = "KTXwriter";
+static const char WRITER_VALUE[] = "OpenGLModelDemo";
+
+struct Ktx2Header {
+	unsigned char identifier[12];
+	uint32_t vkFormat;
+	uint32_t typeSize;
+	uint32_t pixelWidth;
+	uint32_t pixelHeight;
+	uint32_t pixelDepth;
+	uint32_t layerCount;
+	uint32_t faceCount;
+	uint32_t levelCount;
+	uint32_t supercompressionScheme;
+	uint32_t dfdByteOffset;
+	uint32_t dfdByteLength;
+	uint32_t kvdByteOffset;
+	uint32_t kvdByteLength;
+	uint64_t sgdByteOffset;
+	uint64_t sgdByteLength;
+};
+
+struct Ktx2Level {
+	uint64_t byteOffset;
+	uint64_t byteLength;
+	uint64_t uncompressedByteLength;
+};
+
+static_assert(sizeof(Ktx2Header) == 80, "KTX2 header is 80 bytes");
+static_assert(sizeof(Ktx2Level) == 24, "KTX2 level index entry is 24 bytes");
+
+static uint32_t vkFormatFor(BlockFormat format) {
+	switch (format) {
+	case BlockFormat::BC3: return VK_FORMAT_BC3_UNORM_BLOCK;
+	case BlockFormat::BC4: return VK_FORMAT_BC4_UNORM_BLOCK;
+	default: return VK_FORMAT_BC1_RGB_UNORM_BLOCK;
+	}
+}
+
+static bool blockFormatFor(uint32_t vkFormat, BlockFormat& format) {
+	switch (vkFormat) {
+	case VK_FORMAT_BC1_RGB_UNORM_BLOCK: format = BlockFormat::BC1; return true;
+	case VK_FORMAT_BC3_UNORM_BLOCK: format = BlockFormat::BC3; return true;
+	case VK_FORMAT_BC4_UNORM_BLOCK: format = BlockFormat::BC4; return true;
+	default: return false;
+	}
+}
+
+// nekompresovani nivoi: 8 bita po kanalu, 1-4 kanala
+static uint32_t vkFormatFor(int channels) {
+	switch (channels) {
+	case 1: return VK_FORMAT_R8_UNORM;
+	case 2: return VK_FORMAT_R8G8_UNORM;
+	case 3: return VK_FORMAT_R8G8B8_UNORM;
+	default: return VK_FORMAT_R8G8B8A8_UNORM;
+	}
+}
+
+static int channelsFor(uint32_t vkFormat) {
+	switch (vkFormat) {
+	case VK_FORMAT_R8_UNORM: return 1;
+	case VK_FORMAT_R8G8_UNORM: return 2;
+	case VK_FORMAT_R8G8B8_UNORM: return 3;
+	case VK_FORMAT_R8G8B8A8_UNORM: return 4;
+	default: return 0;
+	}
+}
+
+static void put32(std::vector<unsigned char>& target, uint32_t value) {
+	const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&value);
+	target.insert(target.end(), bytes, bytes + sizeof(value));
+}
+
+static void align(std::vector<unsigned char>& target, size_t alignment) {
+	target.resize((target.size() + alignment - 1) / alignment * alignment, 0);
+}
+
+// dfdTotalSize + jedan basic blok; BC3 ima dva uzorka (alfa pa boja), ostali jedan od 64 bita
+static std::vector<unsigned char> dataFormatDescriptor(BlockFormat format) {
+	uint32_t sampleCount = format == BlockFormat::BC3 ? 2 : 1;
+	uint32_t blockBytes = 24 + 16 * sampleCount;
+	uint32_t model = format == BlockFormat::BC3 ? KHR_DF_MODEL_BC3 : format == BlockFormat::BC4 ? KHR_DF_MODEL_BC4 : KHR_DF_MODEL_BC1A;
+
+	std::vector<unsigned char> dfd;
+	put32(dfd, 4 + blockBytes);
+	put32(dfd, 0); // vendorId = Khronos, descriptorType = basic
+	put32(dfd, 2 | (blockBytes << 16)); // versionNumber 1.3
+	put32(dfd, model | (KHR_DF_PRIMARIES_BT709 << 8) | (KHR_DF_TRANSFER_LINEAR << 16));
+	put32(dfd, 3 | (3 << 8)); // 4x4 blok (dimenzija - 1)
+	put32(dfd, static_cast<uint32_t>(CompressedTexture::blockSize(format)));
+	put32(dfd, 0);
+
+	for (uint32_t s = 0; s < sampleCount; s++) {
+		uint32_t channel = (format == BlockFormat::BC3 && s == 0) ? KHR_DF_CHANNEL_BC3_ALPHA : 0;
+		put32(dfd, (s * 64) | (63 << 16) | (channel << 24));
+		put32(dfd, 0);
+		put32(dfd, 0);
+		put32(dfd, 0xFFFFFFFFu);
+	}
+	return dfd;
+}
+
+// Isto za nekompresovane nivoe: texel 1x1, jedan uzorak od 8 bita po kanalu. Kod 2 i 4 kanala
+// poslednji je alfa, kao i u buildMipChain.
+static std::vector<unsigned char> dataFormatDescriptor(int channels) {
+	uint32_t blockBytes = 24 + 16 * channels;
+
+	std::vector<unsigned char> dfd;
+	put32(dfd, 4 + blockBytes);
+	put32(dfd, 0); // vendorId = Khronos, descriptorType = basic
+	put32(dfd, 2 | (blockBytes << 16)); // versionNumber 1.3
+	put32(dfd, KHR_DF_MODEL_RGBSDA | (KHR_DF_PRIMARIES_BT709 << 8) | (KHR_DF_TRANSFER_LINEAR << 16));
+	put32(dfd, 0); // 1x1 texel
+	put32(dfd, static_cast<uint32_t>(channels));
+	put32(dfd, 0);
+
+	for (int c = 0; c < channels; c++) {
+		bool alpha = (channels == 2 || channels == 4) && c == channels - 1;
+		uint32_t channel = alpha ? KHR_DF_CHANNEL_RGBSDA_ALPHA : static_cast<uint32_t>(c);
+		put32(dfd, (c * 8) | (7 << 16) | (channel << 24));
+		put32(dfd, 0);
+		put32(dfd, 0);
+		put32(dfd, 255);
+	}
+	return dfd;
+}
+
+static void keyValue(std::vector<unsigned char>& kvd, const char* key, const void* value, size_t valueSize) {
+	size_t keySize = strlen(key) + 1;
+	put32(kvd, static_cast<uint32_t>(keySize + valueSize));
+	kvd.insert(kvd.end(), key, key + keySize);
+	const unsigned char* bytes = static_cast<const unsigned char*>(value);
+	kvd.insert(kvd.end(), bytes, bytes + valueSize);
+	align(kvd, 4);
+}
+
+struct LevelBytes {
+	const unsigned char* data;
+	size_t size;
+};
+
+// Zajednicki deo oba write-a; levels[0] je puna velicina, svaki nivo poravnat na alignment.
+static bool writeFile(const std::string& path, uint64_t sourceKey, uint32_t vkFormat, const std::vector<unsigned char>& dfd,
+	int width, int height, const std::vector<LevelBytes>& levels, size_t alignment) {
+	size_t levelCount = levels.size();
+
+	Ktx2Header header = {};
+	memcpy(header.identifier, KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER));
+	header.vkFormat = vkFormat;
+	header.typeSize = 1;
+	header.pixelWidth = static_cast<uint32_t>(width);
+	header.pixelHeight = static_cast<uint32_t>(height);
+	header.faceCount = 1;
+	header.levelCount = static_cast<uint32_t>(levelCount);
+
+	// kljucevi moraju biti sortirani po bajtovima
+	std::vector<unsigned char> kvd;
+	keyValue(kvd, WRITER_NAME, WRITER_VALUE, sizeof(WRITER_VALUE));
+	keyValue(kvd, SOURCE_KEY_NAME, &sourceKey, sizeof(sourceKey));
+
+	size_t dfdOffset = sizeof(Ktx2Header) + levelCount * sizeof(Ktx2Level);
+	header.dfdByteOffset = static_cast<uint32_t>(dfdOffset);
+	header.dfdByteLength = static_cast<uint32_t>(dfd.size());
+	header.kvdByteOffset = static_cast<uint32_t>(dfdOffset + dfd.size());
+	header.kvdByteLength = static_cast<uint32_t>(kvd.size());
+
+	std::vector<unsigned char> file(dfdOffset);
+	memcpy(file.data(), &header, sizeof(header));
+	file.insert(file.end(), dfd.begin(), dfd.end());
+	file.insert(file.end(), kvd.begin(), kvd.end());
+
+	// nivoi idu od najmanjeg ka najvecem
+	std::vector<Ktx2Level> levelIndex(levelCount);
+	for (size_t l = levelCount; l-- > 0;) {
+		align(file, alignment);
+		levelIndex[l] = { file.size(), levels[l].size, levels[l].size };
+		file.insert(file.end(), levels[l].data, levels[l].data + levels[l].size);
+	}
+	memcpy(file.data() + sizeof(Ktx2Header), levelIndex.data(), levelCount * sizeof(Ktx2Level));
+
+	return AssetCache::writeFile(path, file.data(), file.size());
+}
+
+bool Ktx2::write(const std::string& path, uint64_t sourceKey, const CompressedTexture& texture) {
+	if (texture.empty()) return false;
+
+	std::vector<LevelBytes> levels;
+	for (const CompressedLevel& level : texture.levels) {
+		levels.push_back({ texture.data.data() + level.offset, level.size });
+	}
+	// poravnanje na blok (8 ili 16), sto je vec deljivo sa 4
+	return writeFile(path, sourceKey, vkFormatFor(texture.format), dataFormatDescriptor(texture.format),
+		texture.levels[0].width, texture.levels[0].height, levels, CompressedTexture::blockSize(texture.format));
+}
+
+bool Ktx2::write(const std::string& path, uint64_t sourceKey, const std::vector<MipLevel>& mipLevels, int channels) {
+	if (mipLevels.empty() || channels < 1 || channels > 4) return false;
+
+	std::vector<LevelBytes> levels;
+	for (const MipLevel& level : mipLevels) {
+		levels.push_back({ level.pixels.data(), level.pixels.size() });
+	}
+	// KTX2 trazi poravnanje na lcm(velicina texela, 4)
+	size_t alignment = channels == 3 ? 12 : 4;
+	return writeFile(path, sourceKey, vkFormatFor(channels), dataFormatDescriptor(channels),
+		mipLevels[0].width, mipLevels[0].height, levels, alignment);
+}
+
+bool Ktx2::read(const std::string& path, uint64_t sourceKey, CompressedTexture& texture, std::vector<MipLevel>& levels) {
+	MappedFile mapping(path);
+	if (!mapping.isOpen() || mapping.size() < sizeof(Ktx2Header)) {
+		return false;
+	}
+
+	Ktx2Header header;
+	memcpy(&header, mapping.data(), sizeof(header));
+
+	BlockFormat format = BlockFormat::BC1;
+	bool compressed = blockFormatFor(header.vkFormat, format);
+	int channels = channelsFor(header.vkFormat);
+	if (memcmp(header.identifier, KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER)) != 0 ||
+		(!compressed && channels == 0) ||
+		header.supercompressionScheme != 0 || header.pixelDepth != 0 || header.layerCount > 1 || header.faceCount != 1 ||
+		header.levelCount == 0 || header.levelCount > 32 || header.pixelWidth == 0 || header.pixelHeight == 0) {
+		std::cout << "KTX2::nepodrzan fajl, ponovo se kompresuje: " << path << std::endl;
+		return false;
+	}
+
+	size_t levelIndexEnd = sizeof(Ktx2Header) + size_t(header.levelCount) * sizeof(Ktx2Level);
+	if (levelIndexEnd > mapping.size() || uint64_t(header.kvdByteOffset) + header.kvdByteLength > mapping.size()) {
+		std::cout << "KTX2::ostecen fajl: " << path << std::endl;
+		return false;
+	}
+
+	// kljuc izvora iz key/value dela
+	bool keyFound = false;
+	uint64_t storedKey = 0;
+	const unsigned char* kvd = mapping.data() + header.kvdByteOffset;
+	for (size_t cursor = 0; cursor + 4 <= header.kvdByteLength;) {
+		uint32_t length;
+		memcpy(&length, kvd + cursor, sizeof(length));
+		cursor += 4;
+		if (length > header.kvdByteLength - cursor) break;
+
+		const char* key = reinterpret_cast<const char*>(kvd + cursor);
+		size_t keySize = strnlen(key, length) + 1;
+		if (keySize <= length && strcmp(key, SOURCE_KEY_NAME) == 0 && length - keySize == sizeof(storedKey)) {
+			memcpy(&storedKey, kvd + cursor + keySize, sizeof(storedKey));
+			keyFound = true;
+		}
+		cursor = (cursor + length + 3) / 4 * 4;
+	}
+	if (!keyFound || storedKey != sourceKey) {
+		std::cout << "KTX2::izvorna slika ili enkoder promenjen, ponovo se kompresuje: " << path << std::endl;
+		return false;
+	}
+
+	CompressedTexture loaded;
+	loaded.format = format;
+	std::vector<MipLevel> loadedLevels;
+	size_t blockSize = CompressedTexture::blockSize(format);
+
+	int width = static_cast<int>(header.pixelWidth), height = static_cast<int>(header.pixelHeight);
+	for (uint32_t l = 0; l < header.levelCount; l++) {
+		Ktx2Level entry;
+		memcpy(&entry, mapping.data() + sizeof(Ktx2Header) + l * sizeof(Ktx2Level), sizeof(entry));
+
+		CompressedLevel level;
+		level.offset = loaded.data.size();
+		level.size = compressed ? size_t((width + 3) / 4) * ((height + 3) / 4) * blockSize : size_t(width) * height * channels;
+		level.width = width;
+		level.height = height;
+
+		if (entry.byteLength != level.size || entry.byteOffset > mapping.size() || entry.byteLength > mapping.size() - entry.byteOffset) {
+			std::cout << "KTX2::ostecen fajl: " << path << std::endl;
+			return false;
+		}
+
+		const unsigned char* bytes = mapping.data() + entry.byteOffset;
+		if (compressed) {
+			loaded.data.insert(loaded.data.end(), bytes, bytes + entry.byteLength);
+			loaded.levels.push_back(level);
+		}
+		else {
+			MipLevel mip;
+			mip.width = width;
+			mip.height = height;
+			mip.pixels.assign(bytes, bytes + entry.byteLength);
+			loadedLevels.push_back(std::move(mip));
+		}
+
+		width = width > 1 ? width / 2 : 1;
+		height = height > 1 ? height / 2 : 1;
+	}
+
+	if (compressed) {
+		texture = std::move(loaded);
+	}
+	else {
+		levels = std::move(loadedLevels);
+	}
+	return true;
+}
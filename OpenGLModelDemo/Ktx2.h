@@ -0,0 +1,32 @@
+#ifndef _MOJ_KTX2_H_
+#define _MOJ_KTX2_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "MipChain.h"
+#include "TextureCompression.h"
+
+// KTX 2.0 kontejner za mip lance tekstura (bez supercompression-a, jedan sloj, jedno lice):
+// blok-kompresovane (BC1/BC3/BC4) ili nekompresovane, 8 bita po kanalu (R8/RG8/RGB8/RGBA8).
+//
+// header | level index | DFD | key/value | mip nivoi, od najmanjeg do najveceg
+//
+// Fajlovi su standardni (vkFormat BC1_RGB / BC3 / BC4 / R8..R8G8B8A8_UNORM), pa ih otvaraju i obicni KTX alati.
+// Kljuc izvora (hash izvorne slike + opcije dekodiranja) ide u key/value deo; read() ne prihvata
+// fajl sa drugim kljucem, pa se tekstura tada ponovo kompresuje iz izvora.
+class Ktx2 {
+public:
+
+	static bool write(const std::string& path, uint64_t sourceKey, const CompressedTexture& texture);
+
+	// nekompresovani nivoi iz buildMipChain (bez kompresije, ili slika sa 2 kanala)
+	static bool write(const std::string& path, uint64_t sourceKey, const std::vector<MipLevel>& levels, int channels);
+
+	// Posle uspeha je popunjeno tacno jedno: texture za kompresovan fajl, levels za nekompresovan.
+	static bool read(const std::string& path, uint64_t sourceKey, CompressedTexture& texture, std::vector<MipLevel>& levels);
+
+};
+
+#endif
@@ -0,0 +1,213 @@
+#include "LightBuffer.h"
+#include "RenderStats.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+static_assert(sizeof(PointLightData) == 64, "PointLightData is read as 4 RGBA32F texels (pointLight() in lights.glsl)");
+static_assert(sizeof(DirectionLightData) == 64, "DirectionLightData must match the std140 DirectionLight layout");
+static_assert(sizeof(SpotLightData) == 96, "SpotLightData must match the std140 SpotLight layout");
+
+static_assert(sizeof(glm::uvec2) == 8, "cluster cells are uploaded as RG32UI");
+
+// texture buffer nad novim buffer-om, vezan na unit jednom za ceo zivot LightBuffer-a
+static void createTextureBuffer(GLenum format, GLuint unit, GLuint& buffer, GLuint& texture) {
+	glGenBuffers(1, &buffer);
+	glBindBuffer(GL_TEXTURE_BUFFER, buffer);
+	glBufferData(GL_TEXTURE_BUFFER, 16, NULL, GL_STREAM_DRAW);
+	glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+	glGenTextures(1, &texture);
+	glActiveTexture(GL_TEXTURE0 + unit);
+	glBindTexture(GL_TEXTURE_BUFFER, texture);
+	glTexBuffer(GL_TEXTURE_BUFFER, format, buffer);
+	glActiveTexture(GL_TEXTURE0);
+}
+
+LightBuffer::LightBuffer() {
+	block = LightBlock();
+
+	glGenBuffers(1, &ubo);
+	glBindBuffer(GL_UNIFORM_BUFFER, ubo);
+	glBufferData(GL_UNIFORM_BUFFER, sizeof(LightBlock), &block, GL_DYNAMIC_DRAW);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+	// binding point se postavlja jednom, svi shaderi citaju iz njega
+	glBindBufferBase(GL_UNIFORM_BUFFER, BINDING_POINT, ubo);
+
+	dirtyBegin = sizeof(LightBlock);
+	dirtyEnd = 0;
+
+	createTextureBuffer(GL_RGBA32F, POINT_LIGHT_UNIT, pointLightBuffer, pointLightTexture);
+	createTextureBuffer(GL_RG32UI, CLUSTER_CELL_UNIT, clusterCellBuffer, clusterCellTexture);
+	createTextureBuffer(GL_R16UI, CLUSTER_LIGHT_UNIT, clusterLightBuffer, clusterLightTexture);
+
+	glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &maxTextureBufferTexels);
+}
+
+LightBuffer::~LightBuffer() {
+	glDeleteBuffers(1, &ubo);
+
+	GLuint buffers[] = { pointLightBuffer, clusterCellBuffer, clusterLightBuffer };
+	GLuint textures[] = { pointLightTexture, clusterCellTexture, clusterLightTexture };
+	glDeleteBuffers(3, buffers);
+	glDeleteTextures(3, textures);
+}
+
+void LightBuffer::attach(const Shader& shader) const {
+	shader.bindUniformBlock("Lights", BINDING_POINT);
+
+	shader.use();
+	shader.setInt("pointLightData", POINT_LIGHT_UNIT);
+	shader.setInt("clusterCells", CLUSTER_CELL_UNIT);
+	shader.setInt("clusterLights", CLUSTER_LIGHT_UNIT);
+
+	GLuint blockIndex = glGetUniformBlockIndex(shader.programID, "Lights");
+	if (blockIndex == GL_INVALID_INDEX) {
+		std::cout << "LIGHTS::shader nema Lights blok" << std::endl;
+		return;
+	}
+
+	GLint blockSize = 0;
+	glGetActiveUniformBlockiv(shader.programID, blockIndex, GL_UNIFORM_BLOCK_DATA_SIZE, &blockSize);
+
+	// nekoliko clanova iz svakog dela bloka, za slucaj da se lights.glsl i ove strukture razidju
+	const GLchar* names[] = { "directionLight.direction", "spotLight.on", "clusterScale" };
+	const GLint expected[] = {
+		(GLint)(offsetof(LightBlock, directionLight) + offsetof(DirectionLightData, direction)),
+		(GLint)(offsetof(LightBlock, spotLight) + offsetof(SpotLightData, on)),
+		(GLint)offsetof(LightBlock, clusterScale)
+	};
+	GLuint indices[3];
+	GLint offsets[3] = { -1, -1, -1 };
+	glGetUniformIndices(shader.programID, 3, names, indices);
+	for (int i = 0; i < 3; i++) {
+		if (indices[i] != GL_INVALID_INDEX) {
+			glGetActiveUniformsiv(shader.programID, 1, &indices[i], GL_UNIFORM_OFFSET, &offsets[i]);
+		}
+	}
+
+	bool layoutMatches = blockSize == (GLint)sizeof(LightBlock);
+	for (int i = 0; i < 3; i++) {
+		// neaktivne clanove kompajler izbaci, njih ne proveravamo
+		if (indices[i] != GL_INVALID_INDEX && offsets[i] != expected[i]) layoutMatches = false;
+	}
+	if (!layoutMatches) {
+		std::cout << "LIGHTS::raspored Lights bloka se ne slaze sa LightBuffer-om (" << blockSize
+			<< " umesto " << sizeof(LightBlock) << " bajtova)" << std::endl;
+	}
+}
+
+void LightBuffer::write(size_t offset, const void* data, size_t size) {
+	unsigned char* target = reinterpret_cast<unsigned char*>(&block) + offset;
+	if (memcmp(target, data, size) == 0) return;
+
+	memcpy(target, data, size);
+	dirtyBegin = std::min(dirtyBegin, offset);
+	dirtyEnd = std::max(dirtyEnd, offset + size);
+}
+
+// Padding se nulira, da neinicijalizovani bajtovi ne bi izgledali kao promena.
+
+void LightBuffer::setDirectionLight(const DirectionLightData& light) {
+	DirectionLightData clean = light;
+	clean.padding0 = clean.padding1 = clean.padding2 = clean.padding3 = 0.0f;
+	write(offsetof(LightBlock, directionLight), &clean, sizeof(clean));
+}
+
+void LightBuffer::setSpotLight(const SpotLightData& light) {
+	SpotLightData clean = light;
+	clean.padding[0] = clean.padding[1] = clean.padding[2] = 0.0f;
+	write(offsetof(LightBlock, spotLight), &clean, sizeof(clean));
+}
+
+void LightBuffer::setPointLightCount(int count) {
+	// 4 texela po svetlu moraju da stanu u texture buffer
+	count = std::min(std::max(count, 0), std::min(MAX_POINT_LIGHTS, maxTextureBufferTexels / 4));
+	if (count == (int)pointLights.size()) return;
+
+	pointLights.resize(count, PointLightData());
+	pointLightSpheres.resize(count, glm::vec4(0.0f));
+	pointLightsDirty = true;
+}
+
+void LightBuffer::setPointLight(int index, const PointLightData& light) {
+	if (index < 0 || index >= (int)pointLights.size()) return;
+	PointLightData clean = light;
+	clean.radius = LightClusters::attenuationRadius(light.constant, light.linear, light.quadratic, ATTENUATION_CUTOFF);
+	if (memcmp(&pointLights[index], &clean, sizeof(clean)) == 0) return;
+
+	pointLights[index] = clean;
+	pointLightSpheres[index] = glm::vec4(clean.position, clean.radius);
+	pointLightsDirty = true;
+}
+
+void LightBuffer::setProjection(const glm::mat4& projection, float nearPlane, float farPlane, int width, int height) {
+	if (projection == this->projection && nearPlane == this->nearPlane && farPlane == this->farPlane &&
+		width == viewportWidth && height == viewportHeight) return;
+
+	this->projection = projection;
+	this->nearPlane = nearPlane;
+	this->farPlane = farPlane;
+	viewportWidth = std::max(width, 1);
+	viewportHeight = std::max(height, 1);
+	clustersDirty = true;
+}
+
+void LightBuffer::uploadBuffer(uint buffer, const void* data, size_t size) {
+	glBindBuffer(GL_TEXTURE_BUFFER, buffer);
+	glBufferData(GL_TEXTURE_BUFFER, std::max<size_t>(size, 16), NULL, GL_STREAM_DRAW);
+	if (size > 0) glBufferSubData(GL_TEXTURE_BUFFER, 0, size, data);
+	glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+void LightBuffer::upload() {
+	if (pointLightsDirty || clustersDirty) {
+		lightClusters.build(pointLightSpheres.data(), pointLightSpheres.size(), projection, nearPlane, farPlane);
+
+		glm::vec4 clusterScale = glm::vec4((float)LightClusters::TILES_X / viewportWidth, (float)LightClusters::TILES_Y / viewportHeight,
+			lightClusters.sliceScale(), lightClusters.sliceBias());
+		write(offsetof(LightBlock, clusterScale), &clusterScale, sizeof(clusterScale));
+
+		const std::vector<uint16_t>& indices = lightClusters.lightIndices();
+		const std::vector<glm::uvec2>* cells = &lightClusters.cells();
+		size_t indexCount = indices.size();
+		if (indexCount > (size_t)maxTextureBufferTexels) {
+			if (!indexLimitReported) {
+				std::cout << "LIGHTS::" << indexCount << " indeksa svetala u klasterima, GPU cita najvise " << maxTextureBufferTexels
+					<< "; klasteri preko granice gube svetla" << std::endl;
+				indexLimitReported = true;
+			}
+			// texelFetch van buffer-a vraca 0, tj. svetlo 0; klasteri se skracuju da citaju samo ono sto je poslato
+			indexCount = (size_t)maxTextureBufferTexels;
+			clampedCells = *cells;
+			for (glm::uvec2& cell : clampedCells) {
+				cell.y = cell.x >= indexCount ? 0u : (unsigned int)std::min<size_t>(cell.y, indexCount - cell.x);
+			}
+			cells = &clampedCells;
+		}
+
+		if (pointLightsDirty) {
+			uploadBuffer(pointLightBuffer, pointLights.data(), pointLights.size() * sizeof(PointLightData));
+		}
+		uploadBuffer(clusterCellBuffer, cells->data(), cells->size() * sizeof(glm::uvec2));
+		uploadBuffer(clusterLightBuffer, indices.data(), indexCount * sizeof(uint16_t));
+
+		pointLightsDirty = false;
+		clustersDirty = false;
+	}
+
+	RenderStats& stats = RenderStats::getInstance();
+	stats.pointLights = (unsigned int)pointLights.size();
+	stats.clusterLightIndices = (unsigned int)lightClusters.lightIndices().size();
+
+	if (dirtyBegin >= dirtyEnd) return;
+
+	glBindBuffer(GL_UNIFORM_BUFFER, ubo);
+	glBufferSubData(GL_UNIFORM_BUFFER, dirtyBegin, dirtyEnd - dirtyBegin, reinterpret_cast<unsigned char*>(&block) + dirtyBegin);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+	dirtyBegin = sizeof(LightBlock);
+	dirtyEnd = 0;
+}
@@ -0,0 +1,164 @@
+#ifndef _MOJ_LIGHT_BUFFER_H_
+#define _MOJ_LIGHT_BUFFER_H_
+
+#include "glad/glad.h"
+#include "glm/glm.hpp"
+
+#include <cstddef>
+#include <vector>
+
+#include "LightClusters.h"
+#include "RenderQueue.h"
+#include "Shader.h"
+
+// Directional i spot svetlo su u std140 uniform bloku "Lights" (shaders/lights.glsl); setters only
+// mark what actually changed and upload() sends the dirty byte range with a single glBufferSubData.
+// Point svetala moze biti hiljade, pa su u texture buffer-ima: podaci svetala, i po klasteru pogleda
+// lista svetala koja ga dodiruju (LightClusters), pa fragment racuna samo ta svetla.
+// Structs mirror the std140 layout, vec3 + float per 16 bytes.
+
+struct PointLightData {
+	glm::vec3 position;
+	float constant;
+
+	glm::vec3 ambient;
+	float linear;
+
+	glm::vec3 diffuse;
+	float quadratic;
+
+	glm::vec3 specular;
+	// dalje od ovoga svetlo se ne racuna; postavlja ga LightBuffer iz slabljenja
+	float radius;
+};
+
+struct DirectionLightData {
+	glm::vec3 ambient;
+	float padding0;
+
+	glm::vec3 diffuse;
+	float padding1;
+
+	glm::vec3 specular;
+	float padding2;
+
+	glm::vec3 direction;
+	float padding3;
+};
+
+struct SpotLightData {
+	glm::vec3 position;
+	float constant;
+
+	glm::vec3 direction;
+	float linear;
+
+	glm::vec3 ambient;
+	float quadratic;
+
+	glm::vec3 diffuse;
+	float innerCosAngle;
+
+	glm::vec3 specular;
+	float outerCosAngle;
+
+	// GLSL bool u std140 zauzima 4 bajta
+	int on;
+	float padding[3];
+};
+
+class LightBuffer {
+	typedef unsigned int uint;
+public:
+
+	// indeksi svetala u klasterima su 16-bitni
+	static const int MAX_POINT_LIGHTS = (int)LightClusters::MAX_LIGHTS;
+
+	// svetlo se ne racuna tamo gde mu slabljenje padne ispod ovoga (manje od koraka 8-bitne boje)
+	static constexpr float ATTENUATION_CUTOFF = 1.0f / 256.0f;
+
+	// uniform buffer binding point bloka "Lights"
+	static const uint BINDING_POINT = 0;
+
+	// texture unit-i buffer-a svetala, posle unit-a materijala, pa ih RenderQueue ne dira
+	static const uint POINT_LIGHT_UNIT = TextureSet::MAX_UNITS;
+	static const uint CLUSTER_CELL_UNIT = TextureSet::MAX_UNITS + 1;
+	static const uint CLUSTER_LIGHT_UNIT = TextureSet::MAX_UNITS + 2;
+
+	LightBuffer();
+
+	~LightBuffer();
+
+	LightBuffer(const LightBuffer&) = delete;
+	LightBuffer& operator=(const LightBuffer&) = delete;
+
+	// Connects the shader's Lights block and light samplers to this buffer and checks that the block layout matches LightBlock.
+	void attach(const Shader& shader) const;
+
+	void setDirectionLight(const DirectionLightData& light);
+
+	void setSpotLight(const SpotLightData& light);
+
+	// koliko point svetala shader vidi; nova su ugasena dok ih setPointLight ne postavi
+	void setPointLightCount(int count);
+
+	int pointLightCount() const { return (int)pointLights.size(); }
+
+	// position je u view space-u
+	void setPointLight(int index, const PointLightData& light);
+
+	// Projekcija kamere i velicina viewport-a u pikselima; klasteri se prave za njih.
+	void setProjection(const glm::mat4& projection, float nearPlane, float farPlane, int width, int height);
+
+	// Salje promenjen deo bloka, a posle promene point svetala ili projekcije ponovo pravi klastere.
+	void upload();
+
+	// klasteri poslednjeg upload()-a
+	const LightClusters& clusters() const { return lightClusters; }
+
+private:
+
+	struct LightBlock {
+		DirectionLightData directionLight;
+		SpotLightData spotLight;
+		// xy: plocica po pikselu (TILES_X / sirina, TILES_Y / visina), zw: sliceScale i sliceBias
+		glm::vec4 clusterScale;
+	};
+
+	LightBlock block;
+
+	uint ubo;
+
+	// [dirtyBegin, dirtyEnd) u bajtovima, prazno kad je dirtyBegin >= dirtyEnd
+	size_t dirtyBegin;
+	size_t dirtyEnd;
+
+	std::vector<PointLightData> pointLights;
+	// xyz pozicija, w radius, za LightClusters
+	std::vector<glm::vec4> pointLightSpheres;
+	bool pointLightsDirty = false;
+
+	glm::mat4 projection = glm::mat4(1.0f);
+	float nearPlane = 0.1f, farPlane = 100.0f;
+	int viewportWidth = 1, viewportHeight = 1;
+	bool clustersDirty = true;
+
+	LightClusters lightClusters;
+
+	// texture buffer-i: podaci svetala (RGBA32F, 4 texela po svetlu), klasteri (RG32UI), indeksi (R16UI)
+	uint pointLightBuffer, clusterCellBuffer, clusterLightBuffer;
+	uint pointLightTexture, clusterCellTexture, clusterLightTexture;
+
+	GLint maxTextureBufferTexels = 0;
+	// klasteri sa brojem svetala skracenim na maxTextureBufferTexels indeksa, samo kad ih ima vise
+	std::vector<glm::uvec2> clampedCells;
+	bool indexLimitReported = false;
+
+	void write(size_t offset, const void* data, size_t size);
+
+	// orphaning pa glBufferSubData, kao instance VBO-i scene
+	static void uploadBuffer(uint buffer, const void* data, size_t size);
+
+};
+
+#endif
@@ -0,0 +1,118 @@
+// Microbenchmark i provera za LightClusters.
+// Bins random view-space point lights into the cluster grid, times build() and checks the result
+// against brute force: for random points in the view frustum, every light whose sphere contains
+// the point must be in the list of the point's cluster. Prints JSON.
+//
+//   light_cluster_bench [--lights N] [--samples N] [--repeats N]
+//
+// build_ms is the best of --repeats runs. missed_lights must be 0; the exit code is 1 otherwise.
+
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "LightClusters.h"
+#include "ThreadPool.h"
+
+typedef std::chrono::steady_clock Clock;
+
+static const float NEAR_PLANE = 0.1f;
+static const float FAR_PLANE = 100.0f;
+
+// Svetla ravnomerno po zapremini frustuma (i malo oko njega) do 60 jedinica daleko; radius kao malo svetlo na mapi 1
+// (slabljenje 1, 2, 20), svako 256. sa dometom neonke (1, 0.09, 0.032), koja pokriva ceo pogled.
+static std::vector<glm::vec4> makeLights(size_t count, const glm::mat4& projection) {
+	std::mt19937 random(1234);
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+	float smallRadius = LightClusters::attenuationRadius(1.0f, 2.0f, 20.0f, 1.0f / 256.0f);
+	float largeRadius = LightClusters::attenuationRadius(1.0f, 0.09f, 0.032f, 1.0f / 256.0f);
+
+	std::vector<glm::vec4> lights;
+	for (size_t i = 0; i < count; i++) {
+		float depth = std::max(1.0f, 60.0f * std::cbrt(unit(random)));
+		float x = (unit(random) * 2.4f - 1.2f) * depth / projection[0][0];
+		float y = (unit(random) * 2.4f - 1.2f) * depth / projection[1][1];
+		float radius = (i % 256 == 0) ? largeRadius : smallRadius;
+		lights.push_back(glm::vec4(x, y, -depth, radius));
+	}
+	return lights;
+}
+
+int main(int argc, char** argv) {
+	size_t lightCount = 4096;
+	size_t samples = 20000;
+	int repeats = 20;
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		if (arg == "--lights" && i + 1 < argc) lightCount = std::min((size_t)std::max(1, atoi(argv[++i])), LightClusters::MAX_LIGHTS);
+		else if (arg == "--samples" && i + 1 < argc) samples = (size_t)std::max(1, atoi(argv[++i]));
+		else if (arg == "--repeats" && i + 1 < argc) repeats = std::max(1, atoi(argv[++i]));
+		else {
+			std::cerr << "usage: light_cluster_bench [--lights N] [--samples N] [--repeats N]" << std::endl;
+			return 1;
+		}
+	}
+
+	glm::mat4 projection = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, NEAR_PLANE, FAR_PLANE);
+	std::vector<glm::vec4> lights = makeLights(lightCount, projection);
+
+	LightClusters clusters;
+	double best = 1e30;
+	for (int r = 0; r < repeats; r++) {
+		Clock::time_point start = Clock::now();
+		clusters.build(lights.data(), lights.size(), projection, NEAR_PLANE, FAR_PLANE);
+		best = std::min(best, std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+	}
+
+	const std::vector<glm::uvec2>& cells = clusters.cells();
+	const std::vector<uint16_t>& indices = clusters.lightIndices();
+	unsigned int maxPerCluster = 0;
+	for (const glm::uvec2& cell : cells) maxPerCluster = std::max(maxPerCluster, cell.y);
+
+	// tacke ravnomerno po ekranu, dubina ravnomerno po logaritmu (kao slojevi)
+	std::mt19937 random(99);
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+	size_t missed = 0, visited = 0, touching = 0;
+	for (size_t s = 0; s < samples; s++) {
+		float ndcX = unit(random) * 2.0f - 1.0f, ndcY = unit(random) * 2.0f - 1.0f;
+		float depth = NEAR_PLANE * std::pow(FAR_PLANE / NEAR_PLANE, unit(random));
+		glm::vec3 point = glm::vec3(ndcX * depth / projection[0][0], ndcY * depth / projection[1][1], -depth);
+
+		const glm::uvec2& cell = cells[clusters.clusterAt(ndcX, ndcY, depth)];
+		visited += cell.y;
+		const uint16_t* first = indices.data() + cell.x;
+		const uint16_t* last = first + cell.y;
+
+		for (size_t light = 0; light < lights.size(); light++) {
+			glm::vec3 offset = glm::vec3(lights[light]) - point;
+			if (glm::dot(offset, offset) > lights[light].w * lights[light].w) continue;
+
+			touching++;
+			// indeksi u klasteru su rastuci
+			if (!std::binary_search(first, last, (uint16_t)light)) missed++;
+		}
+	}
+
+	std::cout << "{" << std::endl;
+	std::cout << "  \"lights\": " << lightCount << "," << std::endl;
+	std::cout << "  \"threads\": " << ThreadPool::getInstance().workerCount() << "," << std::endl;
+	std::cout << "  \"clusters\": " << LightClusters::CLUSTER_COUNT << "," << std::endl;
+	std::cout << "  \"build_ms\": " << best << "," << std::endl;
+	std::cout << "  \"light_indices\": " << indices.size() << "," << std::endl;
+	std::cout << "  \"max_lights_per_cluster\": " << maxPerCluster << "," << std::endl;
+	std::cout << "  \"lights_per_sample\": { \"looped\": " << (double)visited / samples
+		<< ", \"touching\": " << (double)touching / samples << ", \"without_clusters\": " << lightCount << " }," << std::endl;
+	std::cout << "  \"missed_lights\": " << missed << std::endl;
+	std::cout << "}" << std::endl;
+
+	return missed == 0 ? 0 : 1;
+}
@@ -0,0 +1,184 @@
+#include "LightClusters.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LIGHT_CLUSTERS_SSE2
+#include <emmintrin.h>
+#endif
+
+// koliko svetala po komadu za ThreadPool::parallelFor; deljivo sa 4
+static const size_t LIGHTS_PER_CHUNK = 1024;
+
+// Ekranski pravougaonik svetla, u NDC. Sfera je unutar kutije [c - r, c + r] x [dn, df] (po dubini),
+// a x / dubina je na kutiji najmanje i najvece u njenim uglovima, pa su dovoljna dva deljenja po strani.
+// Van ekrana je prazan opseg (min > max).
+static void tileRange(float ndcMin, float ndcMax, int tiles, int& first, int& last) {
+	if (ndcMax < -1.0f || ndcMin > 1.0f) {
+		first = 1;
+		last = 0;
+		return;
+	}
+	ndcMin = std::max(ndcMin, -1.0f);
+	ndcMax = std::min(ndcMax, 1.0f);
+	first = std::min(tiles - 1, (int)((ndcMin * 0.5f + 0.5f) * tiles));
+	last = std::min(tiles - 1, (int)((ndcMax * 0.5f + 0.5f) * tiles));
+}
+
+int LightClusters::sliceAt(float depth) const {
+	float slice = std::floor(std::log(depth) * depthScale + depthBias);
+	return (int)std::min(std::max(slice, 0.0f), (float)(SLICES - 1));
+}
+
+int LightClusters::clusterAt(float ndcX, float ndcY, float depth) const {
+	int tileX = std::min(TILES_X - 1, std::max(0, (int)((ndcX * 0.5f + 0.5f) * TILES_X)));
+	int tileY = std::min(TILES_Y - 1, std::max(0, (int)((ndcY * 0.5f + 0.5f) * TILES_Y)));
+	return clusterIndex(tileX, tileY, sliceAt(depth));
+}
+
+float LightClusters::attenuationRadius(float constant, float linear, float quadratic, float threshold) {
+	// quadratic * d^2 + linear * d + constant = 1 / threshold
+	float target = 1.0f / threshold - constant;
+	if (target <= 0.0f) return 0.0f;
+	if (quadratic > 0.0f) return (-linear + std::sqrt(linear * linear + 4.0f * quadratic * target)) / (2.0f * quadratic);
+	if (linear > 0.0f) return target / linear;
+	return std::numeric_limits<float>::max();
+}
+
+void LightClusters::computeRanges(const glm::vec4* spheres, size_t first, size_t count, const glm::mat4& projection, float nearPlane, float farPlane) {
+	float scaleX = projection[0][0], scaleY = projection[1][1];
+	size_t i = first, end = first + count;
+
+	// ndc min/max po x i y, i granice dubine, za 4 svetla
+	float bounds[6][4];
+
+#ifdef LIGHT_CLUSTERS_SSE2
+	__m128 nearV = _mm_set1_ps(nearPlane), farV = _mm_set1_ps(farPlane);
+	__m128 scaleXV = _mm_set1_ps(scaleX), scaleYV = _mm_set1_ps(scaleY);
+
+	for (; i + 4 <= end; i += 4) {
+		// 4 sfere (x, y, z, r) u 4 registra po komponenti
+		__m128 x = _mm_loadu_ps(&spheres[i].x), y = _mm_loadu_ps(&spheres[i + 1].x);
+		__m128 z = _mm_loadu_ps(&spheres[i + 2].x), r = _mm_loadu_ps(&spheres[i + 3].x);
+		_MM_TRANSPOSE4_PS(x, y, z, r);
+
+		// dubina je -z; kutija sfere po dubini, odsecena na [near, far]
+		__m128 depth = _mm_sub_ps(_mm_setzero_ps(), z);
+		__m128 dn = _mm_max_ps(_mm_sub_ps(depth, r), nearV);
+		__m128 df = _mm_max_ps(_mm_min_ps(_mm_add_ps(depth, r), farV), nearV);
+		__m128 invNear = _mm_div_ps(_mm_set1_ps(1.0f), dn), invFar = _mm_div_ps(_mm_set1_ps(1.0f), df);
+
+		__m128 left = _mm_sub_ps(x, r), right = _mm_add_ps(x, r);
+		__m128 bottom = _mm_sub_ps(y, r), top = _mm_add_ps(y, r);
+		_mm_storeu_ps(bounds[0], _mm_mul_ps(scaleXV, _mm_min_ps(_mm_mul_ps(left, invNear), _mm_mul_ps(left, invFar))));
+		_mm_storeu_ps(bounds[1], _mm_mul_ps(scaleXV, _mm_max_ps(_mm_mul_ps(right, invNear), _mm_mul_ps(right, invFar))));
+		_mm_storeu_ps(bounds[2], _mm_mul_ps(scaleYV, _mm_min_ps(_mm_mul_ps(bottom, invNear), _mm_mul_ps(bottom, invFar))));
+		_mm_storeu_ps(bounds[3], _mm_mul_ps(scaleYV, _mm_max_ps(_mm_mul_ps(top, invNear), _mm_mul_ps(top, invFar))));
+		_mm_storeu_ps(bounds[4], _mm_sub_ps(depth, r));
+		_mm_storeu_ps(bounds[5], _mm_add_ps(depth, r));
+
+		for (int k = 0; k < 4; k++) {
+			LightRange& range = ranges[i + k];
+			tileRange(bounds[0][k], bounds[1][k], TILES_X, range.tileX0, range.tileX1);
+			tileRange(bounds[2][k], bounds[3][k], TILES_Y, range.tileY0, range.tileY1);
+
+			bool visible = bounds[5][k] >= nearPlane && bounds[4][k] <= farPlane && range.tileX0 <= range.tileX1 && range.tileY0 <= range.tileY1;
+			range.sliceBegin = visible ? sliceAt(std::max(bounds[4][k], nearPlane)) : 1;
+			range.sliceEnd = visible ? sliceAt(std::min(bounds[5][k], farPlane)) : 0;
+		}
+	}
+#endif
+
+	// SCALAR - ostatak, ili ceo opseg bez SSE2; isti izrazi
+	for (; i < end; i++) {
+		const glm::vec4& s = spheres[i];
+		float depth = -s.z;
+		float dn = std::max(depth - s.w, nearPlane);
+		float df = std::max(std::min(depth + s.w, farPlane), nearPlane);
+
+		bounds[0][0] = scaleX * std::min((s.x - s.w) / dn, (s.x - s.w) / df);
+		bounds[1][0] = scaleX * std::max((s.x + s.w) / dn, (s.x + s.w) / df);
+		bounds[2][0] = scaleY * std::min((s.y - s.w) / dn, (s.y - s.w) / df);
+		bounds[3][0] = scaleY * std::max((s.y + s.w) / dn, (s.y + s.w) / df);
+
+		LightRange& range = ranges[i];
+		tileRange(bounds[0][0], bounds[1][0], TILES_X, range.tileX0, range.tileX1);
+		tileRange(bounds[2][0], bounds[3][0], TILES_Y, range.tileY0, range.tileY1);
+
+		bool visible = depth + s.w >= nearPlane && depth - s.w <= farPlane && range.tileX0 <= range.tileX1 && range.tileY0 <= range.tileY1;
+		range.sliceBegin = visible ? sliceAt(std::max(depth - s.w, nearPlane)) : 1;
+		range.sliceEnd = visible ? sliceAt(std::min(depth + s.w, farPlane)) : 0;
+	}
+}
+
+void LightClusters::binSlice(int slice) {
+	glm::uvec2* cells = clusterCells.data() + clusterIndex(0, 0, slice);
+	std::vector<uint16_t>& out = sliceIndices[slice];
+
+	// prvo broj svetala po klasteru, pa pomeraji, pa indeksi; svetla ostaju po redu
+	for (const LightRange& range : ranges) {
+		if (slice < range.sliceBegin || slice > range.sliceEnd) continue;
+		for (int y = range.tileY0; y <= range.tileY1; y++) {
+			for (int x = range.tileX0; x <= range.tileX1; x++) {
+				cells[y * TILES_X + x].y++;
+			}
+		}
+	}
+
+	unsigned int cursor[TILES_X * TILES_Y];
+	unsigned int total = 0;
+	for (int c = 0; c < TILES_X * TILES_Y; c++) {
+		cells[c].x = total;
+		cursor[c] = total;
+		total += cells[c].y;
+	}
+
+	out.resize(total);
+	for (size_t light = 0; light < ranges.size(); light++) {
+		const LightRange& range = ranges[light];
+		if (slice < range.sliceBegin || slice > range.sliceEnd) continue;
+		for (int y = range.tileY0; y <= range.tileY1; y++) {
+			for (int x = range.tileX0; x <= range.tileX1; x++) {
+				out[cursor[y * TILES_X + x]++] = (uint16_t)light;
+			}
+		}
+	}
+}
+
+void LightClusters::build(const glm::vec4* spheres, size_t count, const glm::mat4& projection, float nearPlane, float farPlane) {
+	count = std::min(count, MAX_LIGHTS);
+
+	depthScale = SLICES / std::log(farPlane / nearPlane);
+	depthBias = -std::log(nearPlane) * depthScale;
+
+	ThreadPool& pool = ThreadPool::getInstance();
+
+	ranges.resize(count);
+	pool.parallelFor(count, LIGHTS_PER_CHUNK, [&](size_t begin, size_t end) {
+		computeRanges(spheres, begin, end - begin, projection, nearPlane, farPlane);
+	});
+
+	// svaki sloj ima svoje klastere i svoju listu indeksa, pa niti ne dele nista
+	clusterCells.assign(CLUSTER_COUNT, glm::uvec2(0));
+	sliceIndices.resize(SLICES);
+	pool.parallelFor(SLICES, 1, [&](size_t begin, size_t end) {
+		for (size_t slice = begin; slice < end; slice++) binSlice((int)slice);
+	});
+
+	// slojevi jedan za drugim
+	size_t total = 0;
+	for (const std::vector<uint16_t>& slice : sliceIndices) total += slice.size();
+	indices.resize(total);
+
+	unsigned int offset = 0;
+	for (int slice = 0; slice < SLICES; slice++) {
+		glm::uvec2* cells = clusterCells.data() + clusterIndex(0, 0, slice);
+		for (int c = 0; c < TILES_X * TILES_Y; c++) cells[c].x += offset;
+
+		std::copy(sliceIndices[slice].begin(), sliceIndices[slice].end(), indices.begin() + offset);
+		offset += (unsigned int)sliceIndices[slice].size();
+	}
+}
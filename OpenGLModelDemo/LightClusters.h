@@ -0,0 +1,81 @@
+#ifndef _MOJ_LIGHT_CLUSTERS_H_
+#define _MOJ_LIGHT_CLUSTERS_H_
+
+#include "glm/glm.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Point svetla rasporedjena po klasterima pogleda (froxel): ekran je podeljen na TILES_X x TILES_Y
+// plocica, a dubina izmedju near i far na SLICES slojeva koji eksponencijalno rastu.
+// Fragment trazi samo svetla svog klastera, pa cena ne raste sa brojem svetala u celoj sceni.
+// Ne dira OpenGL; bafere za shader pravi LightBuffer.
+class LightClusters {
+public:
+
+	// moraju da se slazu sa CLUSTER_TILES_X/Y i CLUSTER_SLICES u lights.glsl
+	static const int TILES_X = 16;
+	static const int TILES_Y = 9;
+	static const int SLICES = 24;
+	static const int CLUSTER_COUNT = TILES_X * TILES_Y * SLICES;
+
+	// indeksi svetala su 16-bitni
+	static const size_t MAX_LIGHTS = 65536;
+
+	// Sorts the lights into clusters. spheres: view-space center (xyz) and radius (w) of every light,
+	// projection: symmetric perspective (glm::perspective) between nearPlane and farPlane.
+	// Svetla se obradjuju po 4 (SSE2), slojevi dubine paralelno na ThreadPool-u.
+	void build(const glm::vec4* spheres, size_t count, const glm::mat4& projection, float nearPlane, float farPlane);
+
+	// po klasteru: prvi indeks u lightIndices() i broj svetala
+	const std::vector<glm::uvec2>& cells() const { return clusterCells; }
+
+	// indeksi svetala, klaster za klasterom
+	const std::vector<uint16_t>& lightIndices() const { return indices; }
+
+	// sloj = floor(log(dubina) * sliceScale + sliceBias), isto racuna shader
+	float sliceScale() const { return depthScale; }
+	float sliceBias() const { return depthBias; }
+
+	// Klaster tacke na ekranu; ndc x/y u [-1, 1], depth je udaljenost ispred kamere (-z u view space-u).
+	int clusterAt(float ndcX, float ndcY, float depth) const;
+
+	static int clusterIndex(int tileX, int tileY, int slice) {
+		return (slice * TILES_Y + tileY) * TILES_X + tileX;
+	}
+
+	// Udaljenost na kojoj 1 / (constant + linear * d + quadratic * d^2) padne na threshold;
+	// svetlo dalje od nje se ne racuna.
+	static float attenuationRadius(float constant, float linear, float quadratic, float threshold);
+
+private:
+
+	// opseg klastera jednog svetla, prazan kad je sliceBegin > sliceEnd
+	struct LightRange {
+		int tileX0, tileX1, tileY0, tileY1;
+		int sliceBegin, sliceEnd;
+	};
+
+	std::vector<glm::uvec2> clusterCells;
+	std::vector<uint16_t> indices;
+
+	std::vector<LightRange> ranges;
+
+	// svetla po sloju dubine, pre spajanja u indices
+	std::vector<std::vector<uint16_t>> sliceIndices;
+
+	float depthScale = 0.0f;
+	float depthBias = 0.0f;
+
+	int sliceAt(float depth) const;
+
+	// plocice i slojevi za svetla [first, first + count)
+	void computeRanges(const glm::vec4* spheres, size_t first, size_t count, const glm::mat4& projection, float nearPlane, float farPlane);
+
+	// popunjava sliceIndices[slice] i broj svetala u clusterCells za taj sloj
+	void binSlice(int slice);
+
+};
+
+#endif
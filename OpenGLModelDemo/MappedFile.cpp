@@ -0,0 +1,82 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::string& path) {
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE) {
+		return;
+	}
+	fileHandle = file;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size)) {
+		return;
+	}
+	if (size.QuadPart == 0) {
+		opened = true;
+		return;
+	}
+
+	HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (!mapping) {
+		return;
+	}
+	mappingHandle = mapping;
+
+	mapped = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (mapped) {
+		fileSize = static_cast<size_t>(size.QuadPart);
+		opened = true;
+	}
+}
+
+MappedFile::~MappedFile() {
+	if (mapped) UnmapViewOfFile(mapped);
+	if (mappingHandle) CloseHandle(mappingHandle);
+	if (fileHandle) CloseHandle(fileHandle);
+}
+
+#else
+
+MappedFile::MappedFile(const std::string& path) {
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0) {
+		return;
+	}
+
+	struct stat info;
+	if (fstat(fd, &info) == 0) {
+		if (info.st_size == 0) {
+			opened = true;
+		}
+		else {
+			void* view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+			if (view != MAP_FAILED) {
+				mapped = view;
+				fileSize = static_cast<size_t>(info.st_size);
+				opened = true;
+			}
+		}
+	}
+
+	// mapiranje ostaje vazece i posle zatvaranja deskriptora
+	close(fd);
+}
+
+MappedFile::~MappedFile() {
+	if (mapped) munmap(mapped, fileSize);
+}
+
+#endif
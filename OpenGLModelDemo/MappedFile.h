@@ -0,0 +1,39 @@
+#ifndef _MOJ_MAPPED_FILE_H_
+#define _MOJ_MAPPED_FILE_H_
+
+#include <cstddef>
+#include <string>
+
+// Read-only memory mapping celog fajla (mmap / MapViewOfFile).
+// Pokazivac iz data() vazi dok god objekat postoji.
+class MappedFile {
+public:
+
+	MappedFile(const std::string& path);
+
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	// prazan fajl je otvoren, ali data() je nullptr
+	bool isOpen() const { return opened; }
+
+	const unsigned char* data() const { return static_cast<const unsigned char*>(mapped); }
+
+	size_t size() const { return fileSize; }
+
+private:
+
+	void* mapped = nullptr;
+	size_t fileSize = 0;
+	bool opened = false;
+
+#ifdef _WIN32
+	void* fileHandle = nullptr;
+	void* mappingHandle = nullptr;
+#endif
+
+};
+
+#endif
@@ -0,0 +1,48 @@
+#include "Material.h"
+
+static_assert(Material::SPECULAR_UNIT + Material::MAX_SAMPLERS_PER_TYPE <= TextureSet::MAX_UNITS, "material slots must fit in a TextureSet");
+
+// Imena samplera kao hash-evi izracunati pri kompajliranju.
+static constexpr UniformName diffuseSamplers[] = {
+	"material.texture_diffuse1", "material.texture_diffuse2", "material.texture_diffuse3", "material.texture_diffuse4"
+};
+static constexpr UniformName specularSamplers[] = {
+	"material.texture_specular1", "material.texture_specular2", "material.texture_specular3", "material.texture_specular4"
+};
+
+Material Material::fromTextures(const std::vector<Texture>& textures, bool arrays) {
+	int numberOfDiffuse = 0;
+	int numberOfSpecular = 0;
+
+	Material material;
+	for (const Texture& texture : textures) {
+		int unit = -1;
+		if (texture.type == "texture_diffuse" && numberOfDiffuse < MAX_SAMPLERS_PER_TYPE) {
+			unit = DIFFUSE_UNIT + numberOfDiffuse++;
+		}
+		else if (texture.type == "texture_specular" && numberOfSpecular < MAX_SAMPLERS_PER_TYPE) {
+			unit = SPECULAR_UNIT + numberOfSpecular++;
+		}
+		if (unit < 0) continue;
+
+		material.textures.ids[unit] = texture.id;
+		material.layers[unit] = texture.layer;
+	}
+
+	if (arrays) {
+		for (int i = 0; i < MAX_SAMPLERS_PER_TYPE; i++) {
+			material.textures.arrayUnits |= (1u << (DIFFUSE_UNIT + i)) | (1u << (SPECULAR_UNIT + i));
+		}
+	}
+
+	material.textureSet = RenderQueue::getInstance().registerTextureSet(material.textures);
+	return material;
+}
+
+void Material::bindSamplers(const Shader& shader) {
+	shader.use();
+	for (int i = 0; i < MAX_SAMPLERS_PER_TYPE; i++) {
+		shader.setInt(shader.uniform(diffuseSamplers[i]), DIFFUSE_UNIT + i);
+		shader.setInt(shader.uniform(specularSamplers[i]), SPECULAR_UNIT + i);
+	}
+}
@@ -0,0 +1,46 @@
+#ifndef _MOJ_MATERIAL_H_
+#define _MOJ_MATERIAL_H_
+
+#include <string>
+#include <vector>
+
+#include "RenderQueue.h"
+#include "Shader.h"
+
+struct Texture {
+	unsigned int id;
+	// Name, like texture_diffuse or texture_specular. Will be followed by a number (texture_diffuse1)
+	std::string type;
+	// Ako je tekstura embedded tipa, ovo je Filename.
+	std::string path;
+	// sloj, kad je id GL_TEXTURE_2D_ARRAY
+	unsigned int layer = 0;
+};
+
+// Teksture materijala rasporedjene po slotovima, jednom pri ucitavanju modela.
+// texture_diffuseN je uvek na unit-u DIFFUSE_UNIT + N - 1, texture_specularN na SPECULAR_UNIT + N - 1,
+// pa se sampleri postavljaju jednom po programu, a draw samo binduje teksture.
+struct Material {
+	static const int DIFFUSE_UNIT = 0;
+	static const int SPECULAR_UNIT = 4;
+	static const int MAX_SAMPLERS_PER_TYPE = 4;
+
+	// id teksture po unit-u, 0 = prazan slot
+	TextureSet textures;
+
+	// sloj po unit-u, za teksture koje su u nizu (textures.arrayUnits)
+	unsigned int layers[TextureSet::MAX_UNITS] = {};
+
+	// textures registrovan u RenderQueue-u
+	unsigned int textureSet = 0;
+
+	// Sorts the textures into their slots (extra ones of a type are dropped) and registers the set.
+	// arrays: the ids are GL_TEXTURE_2D_ARRAYs and the shader samples sampler2DArray; empty slots are
+	// then bound as array 0 too, so they do not keep the previous material's array.
+	static Material fromTextures(const std::vector<Texture>& textures, bool arrays = false);
+
+	// points material.texture_diffuseN / texture_specularN of the program at the fixed units
+	static void bindSamplers(const Shader& shader);
+};
+
+#endif
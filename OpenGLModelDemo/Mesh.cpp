@@ -1,55 +1,52 @@
 #include "Mesh.h"
 
-void Mesh::draw(Shader& shader, glm::mat4 transform) {
-	int numberOfDiffuse = 1;
-	int numberOfSpecular = 1;
-
-	for (int i = 0; i < this->textures.size(); i++) {
-
-		std::string samplerIndex = "material.";
-
-		if (textures[i].type == "texture_diffuse") {
-			samplerIndex += textures[i].type + std::to_string(numberOfDiffuse++);
-		}
-		else if (textures[i].type == "texture_specular") {
-			samplerIndex += textures[i].type + std::to_string(numberOfSpecular++);
-		}
-
-		shader.setInt(samplerIndex.c_str(), i);
-
-		glActiveTexture(GL_TEXTURE0 + i);
-		glBindTexture(GL_TEXTURE_2D, textures[i].id);
-		
-	}
-	glActiveTexture(GL_TEXTURE0);
-
-	shader.use();
-	shader.setMat4("model", transform);
+MeshUniforms MeshUniforms::resolve(const Shader& shader) {
+	MeshUniforms uniforms;
+	uniforms.model = shader.uniform("model"_uniform);
+	uniforms.positionOffset = shader.uniform("positionOffset"_uniform);
+	uniforms.positionScale = shader.uniform("positionScale"_uniform);
+	return uniforms;
+}
 
-	glBindVertexArray(VAO);
-	glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
-	glBindVertexArray(0);
+void Mesh::draw(RenderQueue& queue, Shader& shader, const MeshUniforms& uniforms, const glm::mat4& transform, float depth, uint lod) const {
+	uint indexSize = indexType == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(unsigned int);
+
+	DrawCommand command;
+	command.shader = &shader;
+	command.VAO = VAO;
+	command.indexOffset = indexOffset + lods[lod].firstIndex * indexSize;
+	command.indexCount = lods[lod].indexCount;
+	command.indexType = indexType;
+	command.baseVertex = baseVertex;
+	command.textureSet = material.textureSet;
+	command.modelUniform = uniforms.model;
+	command.model = transform;
+	command.positionOffsetUniform = uniforms.positionOffset;
+	command.positionScaleUniform = uniforms.positionScale;
+	command.positionOffset = quantization.offset;
+	command.positionScale = quantization.scale;
+	command.depth = depth;
+
+	queue.add(command);
 }
 
-void Mesh::setupMesh() {
-	glGenVertexArrays(1, &VAO);
-	glGenBuffers(1, &VBO);
-	glGenBuffers(1, &EBO);
+size_t Mesh::vertexSize(VertexFormat format) {
+	return format == VertexFormat::Packed ? sizeof(PackedVertex) : sizeof(Vertex);
+}
 
-	glBindVertexArray(VAO);
-	glBindBuffer(GL_ARRAY_BUFFER, VBO);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(Vertex) * this->vertices.size(), &vertices[0], GL_STATIC_DRAW);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
-	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, Normal));
-	glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, TexCoords));
+void Mesh::setupVertexAttributes(VertexFormat format) {
+	if (format == VertexFormat::Packed) {
+		glVertexAttribPointer(0, 3, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, position));
+		glVertexAttribPointer(1, 2, GL_SHORT, GL_TRUE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, normal));
+		glVertexAttribPointer(2, 2, GL_HALF_FLOAT, GL_FALSE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, texCoords));
+	}
+	else {
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
+		glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, Normal));
+		glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, TexCoords));
+	}
 
 	glEnableVertexAttribArray(0);
 	glEnableVertexAttribArray(1);
 	glEnableVertexAttribArray(2);
-
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(uint) * this->indices.size(), &indices[0], GL_STATIC_DRAW);
-
-	glBindVertexArray(0);
-	
 }
@@ -8,7 +8,11 @@
 #include "vector"
 #include "string"
 
+#include "Bounds.h"
+#include "Material.h"
+#include "RenderQueue.h"
 #include "Shader.h"
+#include "VertexPacking.h"
 
 struct Vertex {
 	glm::vec3 Position;
@@ -16,34 +20,77 @@ struct Vertex {
 	glm::vec2 TexCoords;
 };
 
-struct Texture {
-	unsigned int id;
-	// Name, like texture_diffuse or texture_specular. Will be followed by a number (texture_diffuse1)
-	std::string type;
-	// Ako je tekstura embedded tipa, ovo je Filename.
-	std::string path;
+// Full: Vertex, 32 bajta. Packed: PackedVertex (VertexPacking.h), 16 bajta, shader sa PACKED_VERTICES.
+enum class VertexFormat { Full, Packed };
+
+// Jedan nivo detalja: indexCount indeksa od firstIndex-og indeksa mesh-a, nad istim verteksima.
+struct MeshLod {
+	unsigned int firstIndex = 0;
+	unsigned int indexCount = 0;
+
+	// najveca udaljenost od pune povrsine, u jedinicama mesh-a (0 za pun mesh)
+	float error = 0.0f;
+};
+
+// uniformi koje koristi draw mesh-a, razreseni jednom po modelu
+struct MeshUniforms {
+	Uniform model, positionOffset, positionScale;
+
+	static MeshUniforms resolve(const Shader& shader);
 };
 
+// Deo deljenih bafera modela: indexCount indeksa tipa indexType od bajta indexOffset u index buffer-u,
+// koji pokazuju na verteks-e od baseVertex nadalje. GL objekte drzi Model, jedan VAO za sve mesh-eve.
 class Mesh {
 	typedef unsigned int uint;
 public:
+	static const uint MAX_LODS = 4;
+
+	// slojevi difuzne i specular teksture u nizovima materijala, 2 x GL_UNSIGNED_BYTE po verteksu,
+	// iz posebnog bafera modela (shaderi sa MATERIAL_LAYERS)
+	static const uint MATERIAL_LAYERS_ATTRIBUTE = 11;
+
+	// VAO modela kome mesh pripada
 	uint VAO;
 
-	std::vector<Vertex> vertices;
-	std::vector<uint> indices;
-	std::vector<Texture> textures;
+	uint indexOffset;
+	uint indexCount;
+	GLenum indexType;
+	int baseVertex;
+
+	// pozicija = offset + aPos * scale, samo za pakovane verteks-e
+	PositionQuantization quantization;
+
+	Material material;
 
-	Mesh(std::vector<Vertex> Vertices, std::vector<uint> Indices, std::vector<Texture> Textures) : vertices(Vertices), indices(Indices), textures(Textures) {
-		setupMesh();
+	// u prostoru mesh-a, za frustum culling
+	AABB bounds;
+
+	// lods[0] je ceo mesh (indexCount indeksa), sledeci su sve grublji, sa sve vecom greskom
+	MeshLod lods[MAX_LODS];
+	uint lodCount = 1;
+
+	Mesh(uint ModelVAO, uint IndexOffset, uint IndexCount, GLenum IndexType, int BaseVertex, const Material& MeshMaterial)
+		: VAO(ModelVAO), indexOffset(IndexOffset), indexCount(IndexCount), indexType(IndexType), baseVertex(BaseVertex), material(MeshMaterial) {
+		lods[0].indexCount = IndexCount;
 	}
 
-	void draw(Shader& shader, glm::mat4 transform);
+	// Najgrublji LOD cija greska ne prelazi jedan piksel; pixelsPerUnit je koliko piksela pokriva
+	// jedinica mesh-a na udaljenosti na kojoj se crta, vec podeljeno dozvoljenom greskom.
+	uint selectLod(float pixelsPerUnit) const {
+		uint lod = 0;
+		while (lod + 1 < lodCount && lods[lod + 1].error * pixelsPerUnit <= 1.0f) lod++;
+		return lod;
+	}
 
-private:
+	// Records the draw into the queue; depth is the distance from the camera, for sorting.
+	// The uniforms are resolved once by the caller, not per mesh.
+	void draw(RenderQueue& queue, Shader& shader, const MeshUniforms& uniforms, const glm::mat4& transform, float depth, uint lod = 0) const;
 
-	uint VBO, EBO;
+	// Vertex layout (pozicija, normala, tex. koordinate) za VAO u koji je vezan vertex buffer.
+	static void setupVertexAttributes(VertexFormat format);
 
-	void setupMesh();
+	static size_t vertexSize(VertexFormat format);
 
 };
 
@@ -0,0 +1,301 @@
+#include "MeshOptimizer.h"
+#include "Mesh.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// velicina cache-a koju Forsyth pretpostavlja pri bodovanju; pravi cache je obicno manji ili isti
+static const int SCORE_CACHE_SIZE = 32;
+
+// FIFO cache za hard/soft granice klastera
+static const unsigned int CLUSTER_CACHE_SIZE = 16;
+
+// Forsyth, "Linear-Speed Vertex Cache Optimisation": verteks pri vrhu cache-a i verteks kome je ostalo
+// malo trouglova (da ne ostanu usamljeni trouglovi za kraj) imaju vise bodova.
+static float vertexScore(int cachePosition, unsigned int remaining) {
+	if (remaining == 0) return -1.0f;
+
+	float score = 0.0f;
+	if (cachePosition >= 0) {
+		// poslednji trougao: namerno fiksno, inace bi sledeci uvek delio ivicu sa njim i isao u traku
+		if (cachePosition < 3) score = 0.75f;
+		else score = std::pow(1.0f - (cachePosition - 3) / float(SCORE_CACHE_SIZE - 3), 1.5f);
+	}
+	return score + 2.0f * std::pow(float(remaining), -0.5f);
+}
+
+VertexCacheStats analyzeVertexCache(const unsigned int* indices, size_t indexCount, size_t vertexCount, unsigned int cacheSize) {
+	VertexCacheStats stats;
+	if (indexCount < 3 || vertexCount == 0) return stats;
+
+	// verteks je u FIFO-u dok od njegovog ulaska nije uslo jos cacheSize drugih
+	std::vector<unsigned int> timestamps(vertexCount, 0);
+	unsigned int time = cacheSize + 1;
+	size_t misses = 0;
+
+	for (size_t i = 0; i < indexCount; i++) {
+		unsigned int vertex = indices[i];
+		if (time - timestamps[vertex] > cacheSize) {
+			timestamps[vertex] = time++;
+			misses++;
+		}
+	}
+
+	stats.acmr = float(misses) / float(indexCount / 3);
+	stats.atvr = float(misses) / float(vertexCount);
+	return stats;
+}
+
+void optimizeVertexCache(unsigned int* indices, size_t indexCount, size_t vertexCount) {
+	size_t triangleCount = indexCount / 3;
+	if (triangleCount == 0) return;
+
+	// trouglovi svakog verteksa (CSR); prvih remaining[v] u listi jos nisu izbaceni
+	std::vector<unsigned int> remaining(vertexCount, 0);
+	for (size_t i = 0; i < triangleCount * 3; i++) {
+		remaining[indices[i]]++;
+	}
+
+	std::vector<unsigned int> offsets(vertexCount + 1, 0);
+	for (size_t v = 0; v < vertexCount; v++) {
+		offsets[v + 1] = offsets[v] + remaining[v];
+	}
+
+	std::vector<unsigned int> adjacency(triangleCount * 3);
+	std::vector<unsigned int> fill(offsets.begin(), offsets.end() - 1);
+	for (size_t t = 0; t < triangleCount; t++) {
+		for (int k = 0; k < 3; k++) {
+			adjacency[fill[indices[t * 3 + k]]++] = static_cast<unsigned int>(t);
+		}
+	}
+
+	std::vector<int> cachePositions(vertexCount, -1);
+	std::vector<float> vertexScores(vertexCount);
+	for (size_t v = 0; v < vertexCount; v++) {
+		vertexScores[v] = vertexScore(-1, remaining[v]);
+	}
+
+	std::vector<float> triangleScores(triangleCount);
+	std::vector<char> emitted(triangleCount, 0);
+
+	long best = 0;
+	for (size_t t = 0; t < triangleCount; t++) {
+		const unsigned int* triangle = indices + t * 3;
+		triangleScores[t] = vertexScores[triangle[0]] + vertexScores[triangle[1]] + vertexScores[triangle[2]];
+		if (triangleScores[t] > triangleScores[best]) best = static_cast<long>(t);
+	}
+
+	std::vector<unsigned int> output;
+	output.reserve(triangleCount * 3);
+
+	unsigned int cache[SCORE_CACHE_SIZE + 3];
+	unsigned int newCache[SCORE_CACHE_SIZE + 3];
+	size_t cacheCount = 0;
+
+	// kad u cache-u nema vise kandidata, sledeci neiskorisceni trougao u ulaznom redosledu
+	size_t cursor = 0;
+
+	while (output.size() < triangleCount * 3) {
+		if (best < 0) {
+			while (emitted[cursor]) cursor++;
+			best = static_cast<long>(cursor);
+		}
+
+		const unsigned int* triangle = indices + best * 3;
+		output.insert(output.end(), triangle, triangle + 3);
+		emitted[best] = 1;
+
+		for (int k = 0; k < 3; k++) {
+			unsigned int vertex = triangle[k];
+			unsigned int* list = &adjacency[offsets[vertex]];
+			unsigned int count = remaining[vertex];
+			for (unsigned int j = 0; j < count; j++) {
+				if (list[j] == static_cast<unsigned int>(best)) {
+					list[j] = list[count - 1];
+					break;
+				}
+			}
+			remaining[vertex]--;
+		}
+
+		// verteksi trougla idu na vrh cache-a, ostali se pomeraju (LRU)
+		size_t newCount = 0;
+		for (int k = 0; k < 3; k++) {
+			if (std::find(newCache, newCache + newCount, triangle[k]) == newCache + newCount) {
+				newCache[newCount++] = triangle[k];
+			}
+		}
+		for (size_t j = 0; j < cacheCount; j++) {
+			unsigned int vertex = cache[j];
+			if (vertex != triangle[0] && vertex != triangle[1] && vertex != triangle[2]) {
+				newCache[newCount++] = vertex;
+			}
+		}
+
+		// bodovi se menjaju samo verteksima koji su bili ili jesu u cache-u, i njihovim trouglovima
+		for (size_t j = 0; j < newCount; j++) {
+			unsigned int vertex = newCache[j];
+			cachePositions[vertex] = j < SCORE_CACHE_SIZE ? static_cast<int>(j) : -1;
+			vertexScores[vertex] = vertexScore(cachePositions[vertex], remaining[vertex]);
+		}
+
+		best = -1;
+		float bestScore = -1.0f;
+		for (size_t j = 0; j < newCount; j++) {
+			unsigned int vertex = newCache[j];
+			const unsigned int* list = &adjacency[offsets[vertex]];
+			for (unsigned int a = 0; a < remaining[vertex]; a++) {
+				unsigned int t = list[a];
+				const unsigned int* other = indices + t * 3;
+				triangleScores[t] = vertexScores[other[0]] + vertexScores[other[1]] + vertexScores[other[2]];
+				if (triangleScores[t] > bestScore) {
+					bestScore = triangleScores[t];
+					best = static_cast<long>(t);
+				}
+			}
+		}
+
+		cacheCount = std::min<size_t>(newCount, SCORE_CACHE_SIZE);
+		memcpy(cache, newCache, cacheCount * sizeof(unsigned int));
+	}
+
+	memcpy(indices, output.data(), output.size() * sizeof(unsigned int));
+}
+
+void optimizeOverdraw(unsigned int* indices, size_t indexCount, const Vertex* vertices, size_t vertexCount, float threshold) {
+	size_t triangleCount = indexCount / 3;
+	if (triangleCount == 0) return;
+
+	std::vector<unsigned int> timestamps(vertexCount, 0);
+	unsigned int time = CLUSTER_CACHE_SIZE + 1;
+
+	auto misses = [&](size_t t) {
+		unsigned int count = 0;
+		for (int k = 0; k < 3; k++) {
+			unsigned int vertex = indices[t * 3 + k];
+			if (time - timestamps[vertex] > CLUSTER_CACHE_SIZE) {
+				timestamps[vertex] = time++;
+				count++;
+			}
+		}
+		return count;
+	};
+	// posle ovoga nijedan verteks nije u cache-u
+	auto flush = [&]() {
+		time += CLUSTER_CACHE_SIZE + 1;
+	};
+
+	// Hard boundaries: cache optimizacija je tu ionako krenula ispocetka (nijedan verteks trougla
+	// nije bio u cache-u), pa premestanje tog dela ne kosta nista.
+	std::vector<size_t> hardStarts;
+	for (size_t t = 0; t < triangleCount; t++) {
+		if (misses(t) == 3 || t == 0) hardStarts.push_back(t);
+	}
+
+	// Soft boundaries (Sander et al., Tipsify): unutar dela, novi klaster cim ACMR tekuceg klastera
+	// padne ispod threshold * ACMR celog dela. Svaki klaster krece sa praznim cache-om.
+	std::vector<size_t> clusterStarts;
+	for (size_t h = 0; h < hardStarts.size(); h++) {
+		size_t start = hardStarts[h];
+		size_t end = h + 1 < hardStarts.size() ? hardStarts[h + 1] : triangleCount;
+
+		flush();
+		size_t partMisses = 0;
+		for (size_t t = start; t < end; t++) {
+			partMisses += misses(t);
+		}
+		float limit = threshold * float(partMisses) / float(end - start);
+
+		flush();
+		clusterStarts.push_back(start);
+		size_t clusterStart = start;
+		size_t clusterMisses = 0;
+		for (size_t t = start; t + 1 < end; t++) {
+			clusterMisses += misses(t);
+			if (float(clusterMisses) / float(t + 1 - clusterStart) <= limit) {
+				clusterStarts.push_back(t + 1);
+				clusterStart = t + 1;
+				clusterMisses = 0;
+				flush();
+			}
+		}
+	}
+
+	// centar mreze i za svaki klaster centar i normala, sve tezinski po povrsini
+	size_t clusterCount = clusterStarts.size();
+	std::vector<glm::vec3> clusterCentroids(clusterCount), clusterNormals(clusterCount);
+	glm::vec3 meshCentroid(0.0f);
+	float meshArea = 0.0f;
+
+	for (size_t c = 0; c < clusterCount; c++) {
+		size_t end = c + 1 < clusterCount ? clusterStarts[c + 1] : triangleCount;
+
+		glm::vec3 centroid(0.0f), normal(0.0f);
+		float area = 0.0f;
+		for (size_t t = clusterStarts[c]; t < end; t++) {
+			const glm::vec3& p0 = vertices[indices[t * 3 + 0]].Position;
+			const glm::vec3& p1 = vertices[indices[t * 3 + 1]].Position;
+			const glm::vec3& p2 = vertices[indices[t * 3 + 2]].Position;
+
+			glm::vec3 cross = glm::cross(p1 - p0, p2 - p0);
+			float triangleArea = glm::length(cross) * 0.5f;
+
+			centroid += (p0 + p1 + p2) * (triangleArea / 3.0f);
+			normal += cross;
+			area += triangleArea;
+		}
+
+		meshCentroid += centroid;
+		meshArea += area;
+		clusterCentroids[c] = area > 0.0f ? centroid / area : centroid;
+		clusterNormals[c] = normal;
+	}
+	if (meshArea > 0.0f) meshCentroid /= meshArea;
+
+	// Klasteri okrenuti ka spolja prvi: oni zaklanjaju unutrasnje, pa ovi padaju na depth testu.
+	std::vector<float> keys(clusterCount, 0.0f);
+	for (size_t c = 0; c < clusterCount; c++) {
+		float length = glm::length(clusterNormals[c]);
+		if (length > 0.0f) {
+			keys[c] = glm::dot(clusterCentroids[c] - meshCentroid, clusterNormals[c] / length);
+		}
+	}
+
+	std::vector<size_t> order(clusterCount);
+	for (size_t c = 0; c < clusterCount; c++) order[c] = c;
+	std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return keys[a] > keys[b]; });
+
+	std::vector<unsigned int> output;
+	output.reserve(triangleCount * 3);
+	for (size_t c : order) {
+		size_t end = c + 1 < clusterCount ? clusterStarts[c + 1] : triangleCount;
+		output.insert(output.end(), indices + clusterStarts[c] * 3, indices + end * 3);
+	}
+
+	memcpy(indices, output.data(), output.size() * sizeof(unsigned int));
+}
+
+size_t optimizeVertexFetch(Vertex* vertices, size_t vertexCount, unsigned int* indices, size_t indexCount) {
+	std::vector<unsigned int> remap(vertexCount, ~0u);
+	unsigned int next = 0;
+
+	for (size_t i = 0; i < indexCount; i++) {
+		unsigned int& index = indices[i];
+		if (remap[index] == ~0u) remap[index] = next++;
+		index = remap[index];
+	}
+
+	std::vector<Vertex> original(vertices, vertices + vertexCount);
+	for (size_t v = 0; v < vertexCount; v++) {
+		if (remap[v] != ~0u) vertices[remap[v]] = original[v];
+	}
+
+	return next;
+}
+
+size_t optimizeMesh(Vertex* vertices, size_t vertexCount, unsigned int* indices, size_t indexCount) {
+	optimizeVertexCache(indices, indexCount, vertexCount);
+	optimizeOverdraw(indices, indexCount, vertices, vertexCount);
+	return optimizeVertexFetch(vertices, vertexCount, indices, indexCount);
+}
@@ -0,0 +1,39 @@
+#ifndef _MOJ_MESH_OPTIMIZER_H_
+#define _MOJ_MESH_OPTIMIZER_H_
+
+#include <cstddef>
+
+// Redosled trouglova i verteksa jednog indeksiranog mesh-a (lista trouglova), pri importu.
+// Svaka funkcija samo menja redosled; skup trouglova i namotaj svakog trougla ostaju isti.
+//
+//   optimizeVertexCache  - Forsyth: trouglovi redom tako da verteksi ostanu u post-transform cache-u
+//   optimizeOverdraw     - Tipsify-style: deli taj redosled na klastere i crta prvo one okrenute ka spolja
+//   optimizeVertexFetch  - verteksi redom prvog koriscenja, da se VBO cita sekvencijalno
+//
+// Redom kojim su navedene; overdraw pazi da ne pokvari cache vise od threshold puta.
+
+struct Vertex;
+
+struct VertexCacheStats {
+	// promasaji cache-a po trouglu: 0.5 je idealno za veliku mrezu, 3 najgore
+	float acmr = 0.0f;
+	// transformisani verteksi po verteksu mesh-a: 1 je idealno
+	float atvr = 0.0f;
+};
+
+// Simulira FIFO post-transform cache od cacheSize verteksa.
+VertexCacheStats analyzeVertexCache(const unsigned int* indices, size_t indexCount, size_t vertexCount, unsigned int cacheSize = 16);
+
+void optimizeVertexCache(unsigned int* indices, size_t indexCount, size_t vertexCount);
+
+// threshold: koliko klasteri smeju da povecaju ACMR (1.05 = 5%). Ocekuje vec optimizovan cache redosled.
+void optimizeOverdraw(unsigned int* indices, size_t indexCount, const Vertex* vertices, size_t vertexCount, float threshold = 1.05f);
+
+// Renumbers vertices in order of first use and rewrites indices to match. Unreferenced vertices
+// are dropped; returns the new vertex count.
+size_t optimizeVertexFetch(Vertex* vertices, size_t vertexCount, unsigned int* indices, size_t indexCount);
+
+// Sve tri, redom kojim ih radi import; vraca novi broj verteksa.
+size_t optimizeMesh(Vertex* vertices, size_t vertexCount, unsigned int* indices, size_t indexCount);
+
+#endif
@@ -0,0 +1,175 @@
+// Report za MeshOptimizer, bez GL konteksta i bez Assimp-a.
+// Builds a grid and a UV sphere, each in exporter order (row by row) and with shuffled triangles,
+// runs the same optimizeMesh() and generateLods() the model import runs and prints JSON:
+//
+//   mesh_optimizer_bench [--resolution N] [--lod-error F]
+//
+// ACMR (cache misses per triangle) is given for a 16 and a 32 entry FIFO cache, ATVR (transformed
+// vertices per vertex) for 16. "valid" checks that every triangle is still there, with the same winding.
+// "lods" lists [triangles, error] per level; --lod-error is the error limit as a fraction of the
+// bounding box diagonal (Model::LOD_MAX_ERROR).
+
+#include "glm/glm.hpp"
+#include "glm/gtc/constants.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Mesh.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+
+typedef std::chrono::steady_clock Clock;
+
+struct TestMesh {
+	std::string name;
+	std::vector<Vertex> vertices;
+	std::vector<unsigned int> indices;
+};
+
+static void addQuad(std::vector<unsigned int>& indices, unsigned int a, unsigned int b, unsigned int c, unsigned int d) {
+	indices.insert(indices.end(), { a, b, c, a, c, d });
+}
+
+// (n+1)^2 verteksa u ravni y = 0, trouglovi red po red
+static TestMesh makeGrid(unsigned int n) {
+	TestMesh mesh;
+	mesh.name = "grid";
+	for (unsigned int y = 0; y <= n; y++) {
+		for (unsigned int x = 0; x <= n; x++) {
+			glm::vec2 uv(float(x) / n, float(y) / n);
+			mesh.vertices.push_back({ glm::vec3(uv.x, 0.0f, uv.y), glm::vec3(0.0f, 1.0f, 0.0f), uv });
+		}
+	}
+	for (unsigned int y = 0; y < n; y++) {
+		for (unsigned int x = 0; x < n; x++) {
+			unsigned int i = y * (n + 1) + x;
+			addQuad(mesh.indices, i, i + n + 1, i + n + 2, i + 1);
+		}
+	}
+	return mesh;
+}
+
+// zatvorena, pa overdraw redosled ima sta da radi; sav na jednici, normala = pozicija
+static TestMesh makeSphere(unsigned int n) {
+	TestMesh mesh;
+	mesh.name = "sphere";
+	unsigned int rings = n / 2, segments = n;
+	for (unsigned int r = 0; r <= rings; r++) {
+		for (unsigned int s = 0; s <= segments; s++) {
+			glm::vec2 uv(float(s) / segments, float(r) / rings);
+			float theta = uv.y * glm::pi<float>(), phi = uv.x * glm::two_pi<float>();
+			glm::vec3 position(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi));
+			mesh.vertices.push_back({ position, position, uv });
+		}
+	}
+	for (unsigned int r = 0; r < rings; r++) {
+		for (unsigned int s = 0; s < segments; s++) {
+			unsigned int i = r * (segments + 1) + s;
+			addQuad(mesh.indices, i, i + 1, i + segments + 2, i + segments + 1);
+		}
+	}
+	return mesh;
+}
+
+static TestMesh shuffled(TestMesh mesh) {
+	std::mt19937 random(1234);
+	std::vector<std::array<unsigned int, 3>> triangles(mesh.indices.size() / 3);
+	for (size_t t = 0; t < triangles.size(); t++) {
+		triangles[t] = { mesh.indices[t * 3], mesh.indices[t * 3 + 1], mesh.indices[t * 3 + 2] };
+	}
+	std::shuffle(triangles.begin(), triangles.end(), random);
+	for (size_t t = 0; t < triangles.size(); t++) {
+		std::copy(triangles[t].begin(), triangles[t].end(), mesh.indices.begin() + t * 3);
+	}
+	mesh.name += "_shuffled";
+	return mesh;
+}
+
+// trouglovi kao pozicije, zarotirani da pocinju najmanjim temenom (isti namotaj = isti niz)
+static std::vector<std::array<float, 9>> triangleSet(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices) {
+	std::vector<std::array<float, 9>> triangles;
+	for (size_t t = 0; t + 2 < indices.size(); t += 3) {
+		std::array<std::array<float, 3>, 3> corners;
+		for (int k = 0; k < 3; k++) {
+			const glm::vec3& p = vertices[indices[t + k]].Position;
+			corners[k] = { p.x, p.y, p.z };
+		}
+		std::rotate(corners.begin(), std::min_element(corners.begin(), corners.end()), corners.end());
+
+		std::array<float, 9> triangle;
+		for (int k = 0; k < 9; k++) triangle[k] = corners[k / 3][k % 3];
+		triangles.push_back(triangle);
+	}
+	std::sort(triangles.begin(), triangles.end());
+	return triangles;
+}
+
+static void report(const TestMesh& input, float lodError, bool last) {
+	TestMesh mesh = input;
+
+	VertexCacheStats before16 = analyzeVertexCache(mesh.indices.data(), mesh.indices.size(), mesh.vertices.size(), 16);
+	VertexCacheStats before32 = analyzeVertexCache(mesh.indices.data(), mesh.indices.size(), mesh.vertices.size(), 32);
+
+	Clock::time_point start = Clock::now();
+	mesh.vertices.resize(optimizeMesh(mesh.vertices.data(), mesh.vertices.size(), mesh.indices.data(), mesh.indices.size()));
+	double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+	VertexCacheStats after16 = analyzeVertexCache(mesh.indices.data(), mesh.indices.size(), mesh.vertices.size(), 16);
+	VertexCacheStats after32 = analyzeVertexCache(mesh.indices.data(), mesh.indices.size(), mesh.vertices.size(), 32);
+
+	bool valid = triangleSet(input.vertices, input.indices) == triangleSet(mesh.vertices, mesh.indices);
+
+	AABB bounds;
+	for (const Vertex& vertex : mesh.vertices) bounds.expand(vertex.Position);
+	std::vector<MeshLod> lods;
+	start = Clock::now();
+	generateLods(mesh.indices, mesh.vertices, lodError * glm::length(bounds.max - bounds.min), lods);
+	double lodMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+	std::cout << "    { \"mesh\": \"" << input.name << "\", \"triangles\": " << lods[0].indexCount / 3 << ", \"vertices\": " << mesh.vertices.size()
+		<< ", \"acmr16\": [" << before16.acmr << ", " << after16.acmr << "], \"acmr32\": [" << before32.acmr << ", " << after32.acmr
+		<< "], \"atvr16\": [" << before16.atvr << ", " << after16.atvr << "], \"optimize_ms\": " << ms
+		<< ", \"valid\": " << (valid ? "true" : "false") << ", \"lods\": [";
+	for (size_t l = 0; l < lods.size(); l++) {
+		std::cout << (l ? ", " : "") << "[" << lods[l].indexCount / 3 << ", " << lods[l].error << "]";
+	}
+	std::cout << "], \"lod_ms\": " << lodMs << " }" << (last ? "" : ",") << std::endl;
+}
+
+int main(int argc, char** argv) {
+	unsigned int resolution = 128;
+	float lodError = 0.02f;
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		if (arg == "--resolution" && i + 1 < argc) resolution = (unsigned int)std::max(2, atoi(argv[++i]));
+		else if (arg == "--lod-error" && i + 1 < argc) lodError = (float)atof(argv[++i]);
+		else {
+			std::cerr << "usage: mesh_optimizer_bench [--resolution N] [--lod-error F]" << std::endl;
+			return 1;
+		}
+	}
+
+	std::vector<TestMesh> meshes;
+	meshes.push_back(makeGrid(resolution));
+	meshes.push_back(shuffled(meshes.back()));
+	meshes.push_back(makeSphere(resolution));
+	meshes.push_back(shuffled(meshes.back()));
+
+	// svaki par je [pre, posle]
+	std::cout << "{" << std::endl;
+	std::cout << "  \"resolution\": " << resolution << "," << std::endl;
+	std::cout << "  \"meshes\": [" << std::endl;
+	for (size_t i = 0; i < meshes.size(); i++) {
+		report(meshes[i], lodError, i + 1 == meshes.size());
+	}
+	std::cout << "  ]" << std::endl << "}" << std::endl;
+
+	return 0;
+}
@@ -0,0 +1,252 @@
+#include "MeshSimplifier.h"
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+
+// Simetricna 4x4 matrica ravni (a2 ab ac ad b2 bc bd c2 cd d2) i zbir povrsina koje je cine.
+// Greska u tacki je tezinski zbir kvadrata udaljenosti do ravni; deljena tezinom je kvadrat udaljenosti.
+struct Quadric {
+	double a2 = 0, ab = 0, ac = 0, ad = 0, b2 = 0, bc = 0, bd = 0, c2 = 0, cd = 0, d2 = 0;
+	double weight = 0;
+
+	void addPlane(const glm::dvec3& normal, double distance, double planeWeight) {
+		a2 += normal.x * normal.x * planeWeight;
+		ab += normal.x * normal.y * planeWeight;
+		ac += normal.x * normal.z * planeWeight;
+		ad += normal.x * distance * planeWeight;
+		b2 += normal.y * normal.y * planeWeight;
+		bc += normal.y * normal.z * planeWeight;
+		bd += normal.y * distance * planeWeight;
+		c2 += normal.z * normal.z * planeWeight;
+		cd += normal.z * distance * planeWeight;
+		d2 += distance * distance * planeWeight;
+		weight += planeWeight;
+	}
+
+	void add(const Quadric& other) {
+		a2 += other.a2; ab += other.ab; ac += other.ac; ad += other.ad;
+		b2 += other.b2; bc += other.bc; bd += other.bd;
+		c2 += other.c2; cd += other.cd; d2 += other.d2;
+		weight += other.weight;
+	}
+
+	// kvadrat prosecne udaljenosti tacke od ravni
+	double error(const glm::vec3& point) const {
+		double x = point.x, y = point.y, z = point.z;
+		double value = a2 * x * x + 2 * ab * x * y + 2 * ac * x * z + 2 * ad * x
+			+ b2 * y * y + 2 * bc * y * z + 2 * bd * y
+			+ c2 * z * z + 2 * cd * z + d2;
+		return weight > 0 ? std::fabs(value) / weight : 0.0;
+	}
+};
+
+// najveci nagib trougla jednim skupljanjem, kao kosinus (oko 75 stepeni)
+static const float MIN_NORMAL_COSINE = 0.25f;
+
+struct Collapse {
+	unsigned int from, to;
+	double cost;
+};
+
+static uint64_t edgeKey(unsigned int a, unsigned int b) {
+	return a < b ? (uint64_t(a) << 32) | b : (uint64_t(b) << 32) | a;
+}
+
+// verteksi sa istom pozicijom dobijaju isti id (najmanji indeks medju njima)
+static std::vector<unsigned int> weldPositions(const Vertex* vertices, size_t vertexCount) {
+	struct PositionHash {
+		size_t operator()(const glm::vec3& p) const {
+			uint32_t bits[3];
+			memcpy(bits, &p, sizeof(bits));
+			return (bits[0] * 73856093u) ^ (bits[1] * 19349663u) ^ (bits[2] * 83492791u);
+		}
+	};
+
+	std::unordered_map<glm::vec3, unsigned int, PositionHash> first;
+	first.reserve(vertexCount);
+
+	std::vector<unsigned int> positions(vertexCount);
+	for (size_t v = 0; v < vertexCount; v++) {
+		positions[v] = first.emplace(vertices[v].Position, static_cast<unsigned int>(v)).first->second;
+	}
+	return positions;
+}
+
+size_t simplifyMesh(unsigned int* destination, const unsigned int* indices, size_t indexCount, const Vertex* vertices, size_t vertexCount,
+	size_t targetIndexCount, float targetError, float* resultError) {
+
+	std::vector<unsigned int> triangles(indices, indices + indexCount / 3 * 3);
+	double maxCost = 0.0;
+
+	std::vector<unsigned int> positions = weldPositions(vertices, vertexCount);
+
+	// Sastav: vise verteksa na istoj poziciji. Ivica po pozicijama koju ne dele tacno dva trougla
+	// je granica (ili nije mnogostrukost). Takvi verteksi ostaju gde jesu.
+	std::vector<unsigned int> wedges(vertexCount, 0);
+	for (size_t v = 0; v < vertexCount; v++) {
+		wedges[positions[v]]++;
+	}
+
+	std::unordered_map<uint64_t, unsigned int> edgeUses;
+	edgeUses.reserve(triangles.size());
+	for (size_t i = 0; i < triangles.size(); i += 3) {
+		for (int k = 0; k < 3; k++) {
+			unsigned int a = positions[triangles[i + k]], b = positions[triangles[i + (k + 1) % 3]];
+			if (a != b) edgeUses[edgeKey(a, b)]++;
+		}
+	}
+
+	std::vector<char> locked(vertexCount, 0);
+	for (const auto& edge : edgeUses) {
+		if (edge.second != 2) {
+			locked[edge.first >> 32] = 1;
+			locked[edge.first & 0xFFFFFFFFu] = 1;
+		}
+	}
+	for (size_t v = 0; v < vertexCount; v++) {
+		// locked je do sada po poziciji, sad ide na svaki verteks
+		locked[v] = locked[positions[v]] || wedges[positions[v]] > 1;
+	}
+
+	// quadric po poziciji, od ravni svih trouglova oko nje, tezinski po povrsini
+	std::vector<Quadric> quadrics(vertexCount);
+	for (size_t i = 0; i < triangles.size(); i += 3) {
+		glm::dvec3 p0 = vertices[triangles[i]].Position, p1 = vertices[triangles[i + 1]].Position, p2 = vertices[triangles[i + 2]].Position;
+		glm::dvec3 normal = glm::cross(p1 - p0, p2 - p0);
+		double length = glm::length(normal);
+		if (length == 0.0) continue;
+
+		normal /= length;
+		double distance = -glm::dot(normal, p0);
+		for (int k = 0; k < 3; k++) {
+			quadrics[positions[triangles[i + k]]].addPlane(normal, distance, length * 0.5);
+		}
+	}
+
+	double errorLimit = double(targetError) * double(targetError);
+	std::vector<unsigned int> remap(vertexCount);
+	std::vector<char> touched(vertexCount);
+	std::vector<unsigned int> offsets(vertexCount + 1), adjacency;
+	std::vector<Collapse> collapses;
+
+	// Prolazi: sve ivice po ceni, pa redom skupljanje dok ne dodje do verteksa koji je vec diran
+	// u ovom prolazu (njegova okolina se promenila). Posle prolaza se trouglovi prepisuju.
+	while (triangles.size() > targetIndexCount) {
+		size_t triangleCount = triangles.size() / 3;
+
+		std::fill(offsets.begin(), offsets.end(), 0);
+		for (unsigned int vertex : triangles) offsets[vertex + 1]++;
+		for (size_t v = 0; v < vertexCount; v++) offsets[v + 1] += offsets[v];
+		adjacency.resize(triangles.size());
+		std::vector<unsigned int> fill(offsets.begin(), offsets.end() - 1);
+		for (size_t i = 0; i < triangles.size(); i++) {
+			adjacency[fill[triangles[i]]++] = static_cast<unsigned int>(i / 3);
+		}
+
+		collapses.clear();
+		for (size_t i = 0; i < triangles.size(); i += 3) {
+			for (int k = 0; k < 3; k++) {
+				unsigned int a = triangles[i + k], b = triangles[i + (k + 1) % 3];
+				// svaka ivica se vidi iz oba trougla; jednom je dovoljno, iz smera a < b
+				if (a > b) continue;
+
+				Quadric combined = quadrics[positions[a]];
+				combined.add(quadrics[positions[b]]);
+
+				if (!locked[a]) collapses.push_back({ a, b, combined.error(vertices[b].Position) });
+				if (!locked[b]) collapses.push_back({ b, a, combined.error(vertices[a].Position) });
+			}
+		}
+		std::sort(collapses.begin(), collapses.end(), [](const Collapse& x, const Collapse& y) { return x.cost < y.cost; });
+
+		for (size_t v = 0; v < vertexCount; v++) remap[v] = static_cast<unsigned int>(v);
+		std::fill(touched.begin(), touched.end(), 0);
+		size_t collapsed = 0;
+
+		for (const Collapse& collapse : collapses) {
+			if (collapse.cost > errorLimit || triangleCount * 3 <= targetIndexCount) break;
+			if (touched[collapse.from] || touched[collapse.to]) continue;
+
+			const glm::vec3& target = vertices[collapse.to].Position;
+			bool valid = true;
+			size_t removed = 0;
+
+			for (unsigned int a = offsets[collapse.from]; a < offsets[collapse.from + 1] && valid; a++) {
+				const unsigned int* triangle = &triangles[adjacency[a] * 3];
+				if (triangle[0] == collapse.to || triangle[1] == collapse.to || triangle[2] == collapse.to) {
+					removed++;
+					continue;
+				}
+
+				glm::vec3 before[3], after[3];
+				for (int k = 0; k < 3; k++) {
+					// drugi verteks iste pozicije kao cilj bi dao trougao nulte povrsine preko sastava
+					if (positions[triangle[k]] == positions[collapse.to]) valid = false;
+					before[k] = vertices[triangle[k]].Position;
+					after[k] = triangle[k] == collapse.from ? target : before[k];
+				}
+
+				// trougao ne sme da se okrene, ni da se mnogo nagne (vise takvih koraka bi ga okrenulo)
+				glm::vec3 normalBefore = glm::cross(before[1] - before[0], before[2] - before[0]);
+				glm::vec3 normalAfter = glm::cross(after[1] - after[0], after[2] - after[0]);
+				if (glm::dot(normalBefore, normalAfter) <= MIN_NORMAL_COSINE * glm::length(normalBefore) * glm::length(normalAfter)) valid = false;
+			}
+			if (!valid) continue;
+
+			remap[collapse.from] = collapse.to;
+			quadrics[positions[collapse.to]].add(quadrics[positions[collapse.from]]);
+			for (unsigned int a = offsets[collapse.from]; a < offsets[collapse.from + 1]; a++) {
+				const unsigned int* triangle = &triangles[adjacency[a] * 3];
+				touched[triangle[0]] = touched[triangle[1]] = touched[triangle[2]] = 1;
+			}
+
+			triangleCount -= removed;
+			maxCost = std::max(maxCost, collapse.cost);
+			collapsed++;
+		}
+
+		if (collapsed == 0) break;
+
+		// cilj skupljanja je diran, pa u istom prolazu nije i sam skupljen: remap ima samo jedan korak
+		size_t kept = 0;
+		for (size_t i = 0; i < triangles.size(); i += 3) {
+			unsigned int a = remap[triangles[i]], b = remap[triangles[i + 1]], c = remap[triangles[i + 2]];
+			if (a == b || b == c || a == c) continue;
+			triangles[kept++] = a;
+			triangles[kept++] = b;
+			triangles[kept++] = c;
+		}
+		triangles.resize(kept);
+	}
+
+	if (resultError) *resultError = float(std::sqrt(maxCost));
+
+	std::copy(triangles.begin(), triangles.end(), destination);
+	return triangles.size();
+}
+
+void generateLods(std::vector<unsigned int>& indices, const std::vector<Vertex>& vertices, float maxError, std::vector<MeshLod>& lods) {
+	size_t fullCount = indices.size() / 3 * 3;
+
+	lods.clear();
+	lods.push_back({ 0, static_cast<unsigned int>(fullCount), 0.0f });
+
+	std::vector<unsigned int> simplified(fullCount);
+	while (lods.size() < Mesh::MAX_LODS) {
+		size_t previous = lods.back().indexCount;
+
+		// uvek od punog mesh-a, da greska bude merena prema pravoj povrsini
+		float error = 0.0f;
+		size_t count = simplifyMesh(simplified.data(), indices.data(), fullCount, vertices.data(), vertices.size(), previous / 6 * 3, maxError, &error);
+		if (count == 0 || count > previous * 3 / 4) break;
+
+		optimizeVertexCache(simplified.data(), count, vertices.size());
+
+		lods.push_back({ static_cast<unsigned int>(indices.size()), static_cast<unsigned int>(count), error });
+		indices.insert(indices.end(), simplified.begin(), simplified.begin() + count);
+	}
+}
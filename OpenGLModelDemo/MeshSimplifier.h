@@ -0,0 +1,27 @@
+#ifndef _MOJ_MESH_SIMPLIFIER_H_
+#define _MOJ_MESH_SIMPLIFIER_H_
+
+#include <cstddef>
+#include <vector>
+
+#include "Mesh.h"
+
+// Pojednostavljivanje mreze skupljanjem ivica po quadric greski (Garland/Heckbert).
+// Verteks se uvek skuplja u postojeceg suseda, pa rezultat je samo nova lista indeksa nad istim
+// verteksima: svi LOD-ovi jednog mesh-a dele njegov vertex buffer.
+//
+// Verteksi na ivici otvorene mreze i na sastavima (ista pozicija, druga normala ili UV) se ne pomeraju,
+// da se ne otvore rupe i ne razvuku teksture.
+
+// Writes at most indexCount indices to destination and returns how many. Stops once targetIndexCount
+// is reached or when the next collapse would move the surface further than targetError (mesh units).
+// resultError gets the largest error actually introduced.
+size_t simplifyMesh(unsigned int* destination, const unsigned int* indices, size_t indexCount, const Vertex* vertices, size_t vertexCount,
+	size_t targetIndexCount, float targetError, float* resultError);
+
+// LOD 0 je ceo mesh (prvih lods[0].indexCount indeksa). Svaki sledeci nivo cilja pola trouglova prethodnog,
+// sa greskom do maxError; indeksi mu se dodaju na kraj indices. Staje na Mesh::MAX_LODS nivoa ili kad
+// nivo ne bi ustedeo bar cetvrtinu trouglova.
+void generateLods(std::vector<unsigned int>& indices, const std::vector<Vertex>& vertices, float maxError, std::vector<MeshLod>& lods);
+
+#endif
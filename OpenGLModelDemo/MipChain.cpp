@@ -0,0 +1,168 @@
+#include "MipChain.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MIP_CHAIN_SSE2
+#include <emmintrin.h>
+#endif
+
+// otprilike toliko piksela po komadu za ThreadPool::parallelFor
+static const size_t PIXELS_PER_CHUNK = 16384;
+
+// sRGB <-> linearno preko tabela; 4096 linearnih koraka je dovoljno da greska ostane ispod pola bajta
+struct SrgbTables {
+	static const int ENCODE_STEPS = 4096;
+
+	float decode[256];
+	unsigned char encode[ENCODE_STEPS];
+
+	SrgbTables() {
+		for (int i = 0; i < 256; i++) {
+			float c = i / 255.0f;
+			decode[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+		}
+		for (int i = 0; i < ENCODE_STEPS; i++) {
+			float l = i / float(ENCODE_STEPS - 1);
+			float c = l <= 0.0031308f ? l * 12.92f : 1.055f * std::pow(l, 1.0f / 2.4f) - 0.055f;
+			encode[i] = static_cast<unsigned char>(std::clamp(c * 255.0f + 0.5f, 0.0f, 255.0f));
+		}
+	}
+
+	static const SrgbTables& get() {
+		static const SrgbTables tables;
+		return tables;
+	}
+};
+
+// koji kanali su boja (idu kroz sRGB); alfa je poslednji kanal kod 2 i 4 kanala
+static void colorChannels(int channels, ColorSpace colorSpace, bool color[4]) {
+	bool hasAlpha = channels == 2 || channels == 4;
+	for (int c = 0; c < 4; c++) {
+		color[c] = colorSpace == ColorSpace::SRGB && c < channels && !(hasAlpha && c == channels - 1);
+	}
+}
+
+// bajt -> linearna vrednost za svaki kanal; kanal koji slika nema je 0
+struct ByteDecoder {
+	float linear[256];
+	const float* channel[4];
+
+	ByteDecoder(int channels, const bool color[4]) {
+		static const float zero[256] = {};
+		for (int i = 0; i < 256; i++) {
+			linear[i] = i / 255.0f;
+		}
+		for (int c = 0; c < 4; c++) {
+			channel[c] = c >= channels ? zero : color[c] ? SrgbTables::get().decode : linear;
+		}
+	}
+};
+
+// Prvi nivo pravo iz bajtova izvora, par redova po izlaznom redu: izvor se nikad ne prepisuje u float,
+// pa float bafer postoji tek za nivo 1 (cetvrtina broja piksela). Isti redosled sabiranja kao downsample().
+static void downsampleBytes(const unsigned char* pixels, int width, int height, int channels, const ByteDecoder& decoder,
+	int outWidth, size_t rowBegin, size_t rowEnd, float* out) {
+	for (size_t y = rowBegin; y < rowEnd; y++) {
+		const unsigned char* row0 = pixels + std::min<size_t>(y * 2, height - 1) * width * channels;
+		const unsigned char* row1 = pixels + std::min<size_t>(y * 2 + 1, height - 1) * width * channels;
+		float* target = out + y * outWidth * 4;
+
+		for (int x = 0; x < outWidth; x++) {
+			size_t x0 = size_t(std::min(x * 2, width - 1)) * channels;
+			size_t x1 = size_t(std::min(x * 2 + 1, width - 1)) * channels;
+			for (int c = 0; c < 4; c++) {
+				const float* decode = decoder.channel[c];
+				int k = std::min(c, channels - 1);
+				target[x * 4 + c] = ((decode[row0[x0 + k]] + decode[row0[x1 + k]]) + (decode[row1[x0 + k]] + decode[row1[x1 + k]])) * 0.25f;
+			}
+		}
+	}
+}
+
+static void toBytes(const float* linear, int width, int channels, const bool color[4], size_t rowBegin, size_t rowEnd, unsigned char* out) {
+	const SrgbTables& tables = SrgbTables::get();
+	for (size_t y = rowBegin; y < rowEnd; y++) {
+		for (int x = 0; x < width; x++) {
+			size_t pixel = y * width + x;
+			for (int c = 0; c < channels; c++) {
+				float value = std::clamp(linear[pixel * 4 + c], 0.0f, 1.0f);
+				out[pixel * channels + c] = color[c]
+					? tables.encode[int(value * (SrgbTables::ENCODE_STEPS - 1) + 0.5f)]
+					: static_cast<unsigned char>(value * 255.0f + 0.5f);
+			}
+		}
+	}
+}
+
+// 2x2 box filter nad float RGBA, redovi [rowBegin, rowEnd) izlaza
+static void downsample(const float* source, int width, int height, int outWidth, size_t rowBegin, size_t rowEnd, float* out) {
+	for (size_t y = rowBegin; y < rowEnd; y++) {
+		const float* row0 = source + std::min<size_t>(y * 2, height - 1) * width * 4;
+		const float* row1 = source + std::min<size_t>(y * 2 + 1, height - 1) * width * 4;
+		float* target = out + y * outWidth * 4;
+
+		for (int x = 0; x < outWidth; x++) {
+			size_t x0 = size_t(std::min(x * 2, width - 1)) * 4;
+			size_t x1 = size_t(std::min(x * 2 + 1, width - 1)) * 4;
+#ifdef MIP_CHAIN_SSE2
+			__m128 sum = _mm_add_ps(_mm_add_ps(_mm_loadu_ps(row0 + x0), _mm_loadu_ps(row0 + x1)),
+				_mm_add_ps(_mm_loadu_ps(row1 + x0), _mm_loadu_ps(row1 + x1)));
+			_mm_storeu_ps(target + x * 4, _mm_mul_ps(sum, _mm_set1_ps(0.25f)));
+#else
+			for (int c = 0; c < 4; c++) {
+				target[x * 4 + c] = (row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c]) * 0.25f;
+			}
+#endif
+		}
+	}
+}
+
+std::vector<MipLevel> buildMipChain(const unsigned char* pixels, int width, int height, int channels, ColorSpace colorSpace) {
+	std::vector<MipLevel> levels;
+	if (!pixels || width <= 0 || height <= 0 || channels < 1 || channels > 4) return levels;
+
+	bool color[4];
+	colorChannels(channels, colorSpace, color);
+	ThreadPool& pool = ThreadPool::getInstance();
+
+	MipLevel base;
+	base.width = width;
+	base.height = height;
+	base.pixels.assign(pixels, pixels + size_t(width) * height * channels);
+	levels.push_back(std::move(base));
+
+	ByteDecoder decoder(channels, color);
+	std::vector<float> current, next;
+
+	int w = width, h = height;
+	while (w > 1 || h > 1) {
+		int outWidth = std::max(1, w / 2), outHeight = std::max(1, h / 2);
+		size_t grain = std::max<size_t>(1, PIXELS_PER_CHUNK / outWidth);
+
+		next.resize(size_t(outWidth) * outHeight * 4);
+		MipLevel level;
+		level.width = outWidth;
+		level.height = outHeight;
+		level.pixels.resize(size_t(outWidth) * outHeight * channels);
+
+		pool.parallelFor(outHeight, grain, [&](size_t begin, size_t end) {
+			if (current.empty()) {
+				downsampleBytes(pixels, w, h, channels, decoder, outWidth, begin, end, next.data());
+			}
+			else {
+				downsample(current.data(), w, h, outWidth, begin, end, next.data());
+			}
+			toBytes(next.data(), outWidth, channels, color, begin, end, level.pixels.data());
+		});
+
+		levels.push_back(std::move(level));
+		current.swap(next);
+		w = outWidth;
+		h = outHeight;
+	}
+
+	return levels;
+}
@@ -0,0 +1,29 @@
+#ifndef _MOJ_MIP_CHAIN_H_
+#define _MOJ_MIP_CHAIN_H_
+
+#include <vector>
+
+// Mip lanac na CPU-u, umesto glGenerateMipmap na GL niti.
+//
+// Svaki nivo je 2x2 box filter prethodnog (neparna strana ponavlja poslednji red/kolonu), do 1x1.
+// Nivo 1 se racuna pravo iz bajtova izvora (kroz sRGB tabelu), a svaki sledeci u float RGBA iz
+// prethodnog float nivoa, ne iz zaokruzenih bajtova, pa se greska ne sabira kroz nivoe. Redovi se dele na ThreadPool, unutrasnja petlja je SSE2 (jedan piksel po registru).
+
+enum class ColorSpace {
+	// podaci (specular, maske): usrednjava se bajt kakav jeste
+	Linear,
+	// boja: sRGB -> linearno, usrednji, -> sRGB; alfa uvek linearno
+	SRGB
+};
+
+struct MipLevel {
+	int width = 0;
+	int height = 0;
+	// channels bajtova po pikselu, redovi bez razmaka
+	std::vector<unsigned char> pixels;
+};
+
+// levels[0] je kopija izvora. Radi za 1-4 kanala.
+std::vector<MipLevel> buildMipChain(const unsigned char* pixels, int width, int height, int channels, ColorSpace colorSpace);
+
+#endif
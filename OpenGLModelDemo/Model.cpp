@@ -1,115 +1,373 @@
 #include "Model.h"
+#include "AssetCache.h"
+#include "ContentHash.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+#include "ModelCooker.h"
+#include "ThreadPool.h"
+
+#include "assimp/DefaultIOSystem.h"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+
+void Model::draw(RenderQueue& queue, Shader& shader, const glm::mat4& viewProjection, float lodScale) {
+	// model koji nije uspesno ucitan nema sta da crta
+	if (this->nodes.empty()) return;
+
+	// samo podstabla cvorova pomerenih preko nodes.setLocalTransform(), pa njihove kutije
+	this->nodes.updateWorldTransforms();
+	this->nodes.updateBounds(this->meshes);
+	this->nodes.draw(queue, shader, this->meshes, viewProjection, lodScale);
+}
 
-void Model::draw(Shader& shader) {
-	this->rootNode->draw(shader, this->meshes);
+Model::~Model() {
+	glDeleteVertexArrays(1, &VAO);
+	glDeleteBuffers(1, &VBO);
+	glDeleteBuffers(1, &EBO);
+	glDeleteBuffers(1, &layerVBO);
 }
 
-bool Model::loadModel(const std::string& path) {
-	Assimp::Importer importer;
+// bajtovi indeksa mesh-a u EBO-u; svaki mesh pocinje poravnat na 4, da bi i 32-bit indeksi bili poravnati
+static size_t indexBytes(const MeshData& mesh) {
+	size_t size = (size_t)mesh.indexSize * mesh.indexCount;
+	return (size + 3) & ~(size_t)3;
+}
 
-	const aiScene* scene = importer.ReadFile(path, 
-		aiProcess_JoinIdenticalVertices |
-		aiProcess_GenNormals |
-		aiProcess_ValidateDataStructure |
-		aiProcess_Triangulate |
-		aiProcess_FlipUVs
-	);
+// specular mape su podaci, ne boja; mipmape im se usrednjavaju linearno
+static ColorSpace colorSpaceFor(const std::string& textureType) {
+	return textureType == "texture_specular" ? ColorSpace::Linear : ColorSpace::SRGB;
+}
 
-	if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) {
-		std::cout << "Error occured while loading model at path: " << path << std::endl;
-		std::cout << "Error message is: " << importer.GetErrorString() << std::endl;
-		return false;
+void Model::prepareVertexData(ModelData& data, VertexFormat format) {
+	AABB bounds;
+	for (const MeshData& mesh : data.meshes) {
+		bounds.expand(mesh.bounds);
+	}
+	data.quantization = PositionQuantization::fromBounds(bounds);
+	data.vertexFormat = format;
+
+	for (MeshData& mesh : data.meshes) {
+		mesh.uploadVertices = mesh.vertices;
+		if (format == VertexFormat::Packed) {
+			mesh.packedVertices.resize(mesh.vertexCount);
+			packVertices(mesh.vertices, mesh.vertexCount, data.quantization, mesh.packedVertices.data());
+			mesh.uploadVertices = mesh.packedVertices.data();
+		}
+
+		// indeksi su lokalni za mesh, pa 16 bita dovoljno cim mesh ima manje od 65536 verteksa
+		mesh.uploadIndices = mesh.indices;
+		mesh.indexSize = sizeof(unsigned int);
+		if (mesh.vertexCount < 65536) {
+			mesh.shortIndices.assign(mesh.indices, mesh.indices + mesh.indexCount);
+			mesh.uploadIndices = mesh.shortIndices.data();
+			mesh.indexSize = sizeof(uint16_t);
+		}
+	}
+}
+
+void Model::setupBuffers(const ModelData& data) {
+	size_t vertexCount = 0;
+	size_t indexSize = 0;
+	for (const MeshData& mesh : data.meshes) {
+		vertexCount += mesh.vertexCount;
+		indexSize += indexBytes(mesh);
+	}
+
+	glGenVertexArrays(1, &VAO);
+	glGenBuffers(1, &VBO);
+	glGenBuffers(1, &EBO);
+
+	// Jedan VBO i EBO za ceo model, popunjava ih streamIn() mesh po mesh.
+	// Indeksi ostaju lokalni za mesh, pomeraj do njegovih verteksa je baseVertex draw-a.
+	glBindVertexArray(VAO);
+	glBindBuffer(GL_ARRAY_BUFFER, VBO);
+	glBufferData(GL_ARRAY_BUFFER, Mesh::vertexSize(vertexFormat) * vertexCount, NULL, GL_STATIC_DRAW);
+	Mesh::setupVertexAttributes(vertexFormat);
+
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexSize, NULL, GL_STATIC_DRAW);
+
+	// Sloj difuzne i specular teksture svakog verteksa, iz materijala njegovog mesh-a. Materijali
+	// se razlikuju samo po slojevima, pa mesh-evi sa istim nizovima idu u isti draw.
+	std::vector<unsigned char> layers;
+	layers.reserve(vertexCount * 2);
+	for (const MeshData& mesh : data.meshes) {
+		const Material& material = meshMaterial(data, mesh);
+		for (unsigned int v = 0; v < mesh.vertexCount; v++) {
+			layers.push_back((unsigned char)material.layers[Material::DIFFUSE_UNIT]);
+			layers.push_back((unsigned char)material.layers[Material::SPECULAR_UNIT]);
+		}
 	}
 
+	glGenBuffers(1, &layerVBO);
+	glBindBuffer(GL_ARRAY_BUFFER, layerVBO);
+	glBufferData(GL_ARRAY_BUFFER, layers.size(), layers.data(), GL_STATIC_DRAW);
+	glVertexAttribPointer(Mesh::MATERIAL_LAYERS_ATTRIBUTE, 2, GL_UNSIGNED_BYTE, GL_FALSE, 2, (void*)0);
+	glEnableVertexAttribArray(Mesh::MATERIAL_LAYERS_ATTRIBUTE);
+
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+const Material& Model::meshMaterial(const ModelData& data, const MeshData& mesh) const {
+	return mesh.materialIndex < data.materials.size() ? this->materials[mesh.materialIndex] : this->materials.back();
+}
+
+void Model::startLoading(const std::string& path, VertexFormat format, bool async) {
+	this->path = path;
+	this->vertexFormat = format;
 	directory = path.substr(0, path.find_last_of('/'));
 
-	for (unsigned int i = 0; i < scene->mNumMaterials; i++) {
-		aiMaterial* mat = scene->mMaterials[i];
-		loadAllTexturesFromMaterialIntoCache(scene, mat);
+	loadingData = std::make_shared<ModelData>();
+
+	if (async) {
+		// posao drzi svoju kopiju shared_ptr-a, pa moze da se zavrsi i ako je model vec obrisan
+		std::shared_ptr<ModelData> data = loadingData;
+		importJob = ThreadPool::getInstance().submit([path, data, format]() {
+			return loadModelData(path, format, *data);
+		});
 	}
+	else {
+		std::promise<bool> imported;
+		imported.set_value(loadModelData(path, format, *loadingData));
+		importJob = imported.get_future();
+	}
+}
 
-	for (unsigned int i = 0; i < scene->mNumMeshes; i++) {
-		this->meshes.push_back(processMesh(scene->mMeshes[i], scene));
+void Model::streamIn(double budgetMs) {
+	if (isLoaded()) return;
+
+	bool blocking = budgetMs < 0.0;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	auto budgetSpent = [&]() {
+		return !blocking && std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() >= budgetMs;
+	};
+	auto finished = [&](auto& job) {
+		return blocking || job.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+	};
+
+	if (state == LoadState::Importing) {
+		if (!finished(importJob)) return;
+
+		if (!importJob.get()) {
+			loadingData.reset();
+			state = LoadState::Failed;
+			std::cout << "Failed loading model." << std::endl;
+			return;
+		}
+
+		loadAllTexturesFromMaterialIntoCache(loadingData->materials);
+		this->meshes.reserve(loadingData->meshes.size());
+		state = LoadState::Uploading;
 	}
 
-	for (unsigned int i = 0; i < scene->mRootNode->mNumChildren; i++) {
-		this->rootNode = processNode(scene->mRootNode, nullptr);
+	// Prvo teksture, jer ih materijali uzimaju iz textures. U nizove se grupisu tek kad su sve
+	// dekodirane (tad se znaju velicine); veliki niz moze da ide kroz vise frame-ova.
+	while (decodedTextures < pendingTextures.size()) {
+		PendingTexture& pending = pendingTextures[decodedTextures];
+		if (budgetSpent()) return;
+		if (!finished(pending.image)) return;
+		pending.decoded = pending.image.get();
+		decodedTextures++;
 	}
 
-	std::cout << "Struktura ovog modela: " << path << std::endl;
-	std::cout << this->rootNode->name << std::endl;
-	for (unsigned int i = 0; i < this->rootNode->numOfChildren; i++) {
-		std::cout << "    " << this->rootNode->children[i]->name << std::endl;
-		for (unsigned int j = 0; j < this->rootNode->children[i]->numOfChildren; j++) {
-			std::cout << "        " << this->rootNode->children[i]->children[j]->name << std::endl;
-			for (unsigned int k = 0; k < this->rootNode->children[i]->children[j]->numOfChildren; k++) {
-				std::cout << "            " << this->rootNode->children[i]->children[j]->children[k]->name << std::endl;
-			}
+	if (!texturesGrouped) {
+		groupTextureArrays();
+		texturesGrouped = true;
+	}
+
+	while (uploadedArrays < pendingArrays.size()) {
+		if (budgetSpent()) return;
+		if (!uploadPendingArray(pendingArrays[uploadedArrays], budgetSpent)) return;
+		uploadedArrays++;
+	}
+
+	const ModelData& data = *loadingData;
+
+	// Materijali se razresavaju jednom, ne za svaki mesh; teksture su vec u cache-u.
+	// Mesh bez materijala dobija prazan, pa ne nasledi teksture prethodnog draw-a.
+	if (this->materials.empty()) {
+		for (const PendingTexture& pending : pendingTextures) {
+			TextureHandle array = pending.resident ? pending.resident : pendingArrays[pending.array].handle;
+			textures[pending.texture.path] = { array, pending.layer };
+		}
+		for (const MaterialData& material : data.materials) {
+			this->materials.push_back(Material::fromTextures(processTextures(material), true));
 		}
+		this->materials.push_back(Material::fromTextures(std::vector<Texture>(), true));
 	}
 
+	if (VAO == 0) {
+		setupBuffers(data);
+	}
 
-	return true;
+	// svaki mesh u svoj deo deljenih bafera, nekoliko po frame-u
+	while (this->meshes.size() < data.meshes.size()) {
+		if (budgetSpent()) return;
+
+		const MeshData& meshData = data.meshes[this->meshes.size()];
+		const Material& material = meshMaterial(data, meshData);
+
+		size_t vertexSize = Mesh::vertexSize(vertexFormat);
+		bool shortIndices = meshData.indexSize == sizeof(uint16_t);
+
+		glBindBuffer(GL_ARRAY_BUFFER, VBO);
+		glBufferSubData(GL_ARRAY_BUFFER, vertexSize * (size_t)uploadedVertices, vertexSize * (size_t)meshData.vertexCount, meshData.uploadVertices);
+		glBindBuffer(GL_ARRAY_BUFFER, EBO);
+		glBufferSubData(GL_ARRAY_BUFFER, uploadedIndexBytes, (size_t)meshData.indexSize * meshData.indexCount, meshData.uploadIndices);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+		unsigned int fullCount = meshData.lods.empty() ? meshData.indexCount : meshData.lods[0].indexCount;
+		Mesh mesh(VAO, (unsigned int)uploadedIndexBytes, fullCount, shortIndices ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT, (int)uploadedVertices, material);
+		mesh.bounds = meshData.bounds;
+		if (!meshData.lods.empty()) {
+			mesh.lodCount = (unsigned int)std::min<size_t>(meshData.lods.size(), Mesh::MAX_LODS);
+			std::copy(meshData.lods.begin(), meshData.lods.begin() + mesh.lodCount, mesh.lods);
+		}
+		if (vertexFormat == VertexFormat::Packed) {
+			mesh.quantization = data.quantization;
+		}
+		this->meshes.push_back(mesh);
+
+		uploadedVertices += meshData.vertexCount;
+		uploadedIndexBytes += indexBytes(meshData);
+	}
+
+	this->nodes.build(data.nodes);
+	this->nodes.updateBounds(this->meshes);
+
+	// oslobadja i cooked mapiranje
+	loadingData.reset();
+	pendingTextures.clear();
+	pendingArrays.clear();
+
+	if (this->nodes.empty()) {
+		state = LoadState::Failed;
+		std::cout << "Failed loading model." << std::endl;
+		return;
+	}
+
+	std::cout << "Struktura ovog modela: " << path << std::endl;
+	this->nodes.printHierarchy(std::cout, 3);
+
+	state = LoadState::Ready;
 }
 
-void Model::loadAllTexturesFromMaterialIntoCache(const aiScene* scene, aiMaterial* mat) {
+bool Model::loadModelData(const std::string& path, VertexFormat format, ModelData& data) {
+	// Cooked fajl vazi samo za tacno ovaj sadrzaj izvornog fajla, i cuva verteks-e vec u formatu,
+	// pa svaki format ima svoj fajl.
+	uint64_t sourceHash = 0;
+	bool hashed = hashFile(path, sourceHash);
+	std::string cookedPath = AssetCache::pathFor(path, format == VertexFormat::Packed ? ".packed.cooked" : ".cooked");
 
-	processTexturesForCache(scene, mat, aiTextureType_DIFFUSE, "texture_diffuse");
+	if (hashed && ModelCooker::read(cookedPath, sourceHash, format, data)) {
+		std::cout << "COOK::ucitan cooked model: " << cookedPath << std::endl;
+		return true;
+	}
 
-	processTexturesForCache(scene, mat, aiTextureType_SPECULAR, "texture_specular");
+	if (!importWithAssimp(path, data)) {
+		return false;
+	}
+	prepareVertexData(data, format);
+	if (hashed && ModelCooker::write(cookedPath, sourceHash, data)) {
+		std::cout << "COOK::model skuvan u: " << cookedPath << std::endl;
+	}
 
+	return true;
 }
 
-Node* Model::processNode(aiNode* node, Node* callingNode) {
+// Obican IO sistem koji pamti svaki fajl koji import otvori, pa cooked fajl zna i za .mtl i slicne.
+class RecordingIOSystem : public Assimp::DefaultIOSystem {
+public:
+	std::vector<std::string> openedFiles;
+
+	Assimp::IOStream* Open(const char* file, const char* mode = "rb") override {
+		Assimp::IOStream* stream = Assimp::DefaultIOSystem::Open(file, mode);
+		if (stream) openedFiles.push_back(file);
+		return stream;
+	}
+};
 
-	if (!node) return nullptr;
+bool Model::importWithAssimp(const std::string& path, ModelData& data) {
+	Assimp::Importer importer;
+	// importer ga brise; vazi dok i importer
+	RecordingIOSystem* io = new RecordingIOSystem();
+	importer.SetIOHandler(io);
 
-	// da ne saljem svaki put parentTransform.
-	// Ako je rootnode True, onda cemo parentTransform staviti da bude glm::mat4(1.0f).
-	// U suprotnom, slobodno koristi parent->localTransform.
-	bool rootNode = false;
-	if (callingNode == nullptr) rootNode = true;
+	const aiScene* scene = importer.ReadFile(path, 
+		aiProcess_JoinIdenticalVertices |
+		aiProcess_GenNormals |
+		aiProcess_ValidateDataStructure |
+		aiProcess_Triangulate |
+		aiProcess_FlipUVs
+	);
 
-	glm::mat4 parentTransform;
-	if (rootNode) {
-		parentTransform = glm::mat4(1.0f);
+	if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) {
+		std::cout << "Error occured while loading model at path: " << path << std::endl;
+		std::cout << "Error message is: " << importer.GetErrorString() << std::endl;
+		return false;
 	}
-	else {
-		parentTransform = callingNode->transformMatrix;
+
+	for (unsigned int i = 0; i < scene->mNumMaterials; i++) {
+		data.materials.push_back(processMaterial(scene, scene->mMaterials[i]));
 	}
 
-	Node* myNode = new Node;
+	for (unsigned int i = 0; i < scene->mNumMeshes; i++) {
+		data.meshes.push_back(processMesh(scene->mMeshes[i]));
+	}
 
-	std::string nodeName = std::string(node->mName.C_Str());
-	myNode->name = nodeName;
+	processNode(scene->mRootNode, -1, data);
 
-	glm::mat4 localTransform = transformToGLMatrix(node->mTransformation);
-	myNode->transformMatrix = parentTransform * localTransform;
+	std::string modelFile = std::filesystem::path(path).lexically_normal().generic_string();
+	for (const std::string& file : io->openedFiles) {
+		SourceDependency dependency;
+		dependency.path = std::filesystem::path(file).lexically_normal().generic_string();
+		bool known = dependency.path == modelFile;
+		for (const SourceDependency& other : data.dependencies) {
+			if (other.path == dependency.path) known = true;
+		}
+		if (known || !hashFile(dependency.path, dependency.hash)) continue;
+		data.dependencies.push_back(dependency);
+	}
 
-	myNode->parent = callingNode;
+	return true;
+}
+
+void Model::processNode(aiNode* node, int parentIndex, ModelData& data) {
+
+	if (!node) return;
+
+	// Cvorovi se pamte ravno, depth-first, pa je roditelj uvek ispred deteta.
+	NodeData nodeData;
+	nodeData.name = std::string(node->mName.C_Str());
+	nodeData.localTransform = transformToGLMatrix(node->mTransformation);
+	nodeData.parent = parentIndex;
 
 	for (unsigned int i = 0; i < node->mNumMeshes; i++) {
-		myNode->meshIndices.push_back(node->mMeshes[i]);
+		nodeData.meshIndices.push_back(node->mMeshes[i]);
 	}
 
-	myNode->numOfChildren = node->mNumChildren;
-	myNode->numOfMeshIndices = node->mNumMeshes;
+	int myIndex = static_cast<int>(data.nodes.size());
+	data.nodes.push_back(nodeData);
 
 	if (node->mChildren) {
 		for (unsigned int i = 0; i < node->mNumChildren; i++) {
-			Node* childNode = processNode(node->mChildren[i], myNode);
-			myNode->children.push_back(childNode);
+			processNode(node->mChildren[i], myIndex, data);
 		}
 	}
-
-	return myNode;
 }
 
-Mesh Model::processMesh(aiMesh* mesh, const aiScene* scene) {
+MeshData Model::processMesh(aiMesh* mesh) {
 
-	std::vector<Vertex> vertices;
-	std::vector<unsigned int> indices;
-	std::vector<Texture> textures;
+	MeshData meshData;
+	std::vector<Vertex>& vertices = meshData.ownedVertices;
+	std::vector<unsigned int>& indices = meshData.ownedIndices;
+
+	vertices.reserve(mesh->mNumVertices);
+	indices.reserve(mesh->mNumFaces * 3);
 
 	for (unsigned int i = 0; i < mesh->mNumVertices; i++) {
 		Vertex vertex;
@@ -137,213 +395,256 @@ Mesh Model::processMesh(aiMesh* mesh, const aiScene* scene) {
 		}
 	}
 
+	// Redosled iz exportera je slucajan za GPU: trouglovi za post-transform cache i manje overdraw-a,
+	// verteksi redom kojim ih trouglovi citaju. Cooked fajl pamti vec sredjen redosled.
+	VertexCacheStats before = analyzeVertexCache(indices.data(), indices.size(), vertices.size());
+	vertices.resize(optimizeMesh(vertices.data(), vertices.size(), indices.data(), indices.size()));
+	VertexCacheStats after = analyzeVertexCache(indices.data(), indices.size(), vertices.size());
+	std::cout << "OPTIMIZE::" << mesh->mName.C_Str() << " ACMR " << before.acmr << " -> " << after.acmr
+		<< ", ATVR " << before.atvr << " -> " << after.atvr << std::endl;
 
-	if (mesh->mMaterialIndex >= 0) {
+	for (const Vertex& vertex : vertices) {
+		meshData.bounds.expand(vertex.Position);
+	}
 
-		aiMaterial *mat = scene->mMaterials[mesh->mMaterialIndex];
+	// grublji nivoi idu iza punog mesh-a u istom nizu indeksa, nad istim verteksima
+	float maxError = LOD_MAX_ERROR * glm::length(meshData.bounds.max - meshData.bounds.min);
+	generateLods(indices, vertices, maxError, meshData.lods);
+	std::cout << "LOD::" << mesh->mName.C_Str() << " trouglova po nivou:";
+	for (const MeshLod& lod : meshData.lods) {
+		std::cout << " " << lod.indexCount / 3 << " (" << lod.error << ")";
+	}
+	std::cout << std::endl;
 
-		std::vector<Texture> diffuseMaps = processTextures(scene, mat, aiTextureType_DIFFUSE, "texture_diffuse");
+	meshData.materialIndex = mesh->mMaterialIndex;
+	meshData.useOwnedData();
 
-		textures.insert(textures.end(), diffuseMaps.begin(), diffuseMaps.end());
+	return meshData;
+}
 
-		std::vector<Texture> specularMaps = processTextures(scene, mat, aiTextureType_SPECULAR, "texture_specular");
+MaterialData Model::processMaterial(const aiScene* scene, aiMaterial* mat) {
+	MaterialData material;
 
-		textures.insert(textures.end(), specularMaps.begin(), specularMaps.end());
-		
-	}
+	processTextureRefs(scene, mat, aiTextureType_DIFFUSE, "texture_diffuse", material);
 
-	return Mesh(vertices, indices, textures);
-}
-
-std::vector<Texture> Model::processTextures(const aiScene* scene, aiMaterial* mat, aiTextureType type, std::string name) {
+	processTextureRefs(scene, mat, aiTextureType_SPECULAR, "texture_specular", material);
 
-	std::vector<Texture> textures;
+	return material;
+}
 
+void Model::processTextureRefs(const aiScene* scene, aiMaterial* mat, aiTextureType type, std::string name, MaterialData& material) {
 	for (unsigned int i = 0; i < mat->GetTextureCount(type); i++) {
 
-		bool skip = false;
 		aiString str;
 		mat->GetTexture(type, i, &str);
 
+		TextureRef ref;
+		ref.type = name;
+
 		if (*str.C_Str() == '*') {
-			auto it = TextureCache::getCache().find(std::string(scene->GetEmbeddedTexture(str.C_Str())->mFilename.C_Str()));
-			if (it != TextureCache::getCache().end()) {
-				skip = true;
-				textures.push_back(it->second);
+			// Ovo je embedded format koji svoje materijale drzi unutar sebe, ne odvojeno.
+			// Bajtovi se kopiraju da bi mogli da se zapisu u cooked fajl.
+			const aiTexture* embeddedTexture = scene->GetEmbeddedTexture(str.C_Str());
+			if (!embeddedTexture) {
+				std::cerr << "Missing embedded texture: " << str.C_Str() << std::endl;
+				continue;
 			}
 
-			if (!skip) {
-				// Ovo je embedded format koji svoje materijale drzi unutar sebe, ne odvojeno.
-				const aiTexture* embeddedTexture = scene->GetEmbeddedTexture(str.C_Str());
-				Texture tex;
-				tex.type = name;
-				tex.path = std::string(embeddedTexture->mFilename.C_Str());
-				tex.id = loadEmbeddedTexture(embeddedTexture);
-				textures.push_back(tex);
-				TextureCache::getCache().emplace(tex.path, tex);
-			}
+			ref.embedded = true;
+			ref.path = std::string(embeddedTexture->mFilename.C_Str());
+			ref.embeddedWidth = embeddedTexture->mWidth;
+			ref.embeddedHeight = embeddedTexture->mHeight;
 
+			size_t byteCount = embeddedTexture->mHeight == 0
+				? embeddedTexture->mWidth
+				: sizeof(aiTexel) * embeddedTexture->mWidth * embeddedTexture->mHeight;
+			const unsigned char* bytes = reinterpret_cast<const unsigned char*>(embeddedTexture->pcData);
+			ref.embeddedData.assign(bytes, bytes + byteCount);
 		}
 		else {
-			auto it = TextureCache::getCache().find(std::string(str.C_Str()));
-			if (it != TextureCache::getCache().end()) {
-				skip = true;
-				textures.push_back(it->second);
-			}
-
-			if (!skip) {
-				Texture tex;
-				tex.type = name;
-				tex.path = std::string(str.C_Str());
-				tex.id = loadTextureFromFile(str.C_Str(), this->directory);
-				textures.push_back(tex);
-				TextureCache::getCache().emplace(tex.path, tex);
-			}
+			ref.path = std::string(str.C_Str());
 		}
-	}
 
-	return textures;
+		material.textures.push_back(ref);
+	}
 }
 
-void Model::processTexturesForCache(const aiScene* scene, aiMaterial* mat, aiTextureType type, std::string name) {
-	for (unsigned int i = 0; i < mat->GetTextureCount(type); i++) {
-
-		bool skip = false;
-		aiString str;
-		mat->GetTexture(type, i, &str);
+void Model::loadAllTexturesFromMaterialIntoCache(const std::vector<MaterialData>& materials) {
 
-		if (*str.C_Str() == '*') {
-			auto it = TextureCache::getCache().find(std::string(scene->GetEmbeddedTexture(str.C_Str())->mFilename.C_Str()));
-			std::cout << "CACHE::EMBEDD::pokusaj pristupa teksturi: " << scene->GetEmbeddedTexture(str.C_Str())->mFilename.C_Str() << "..." << std::endl;
-			if (it != TextureCache::getCache().end()) {
-				skip = true;
-				std::cout << "CACHE::EMBEDD::tekstura nadjena!" << std::endl;
-			}
+	for (const MaterialData& material : materials) {
+		processTexturesForCache(material, "texture_diffuse");
 
-			if (!skip) {
-				// Ovo je embedded format koji svoje materijale drzi unutar sebe, ne odvojeno.
-				std::cout << "CACHE::EMBEDD::tekstura nije nadjena.. " << std::endl;
-				const aiTexture* embeddedTexture = scene->GetEmbeddedTexture(str.C_Str());
-				Texture tex;
-				tex.type = name;
-				tex.path = std::string(embeddedTexture->mFilename.C_Str());
-				tex.id = loadEmbeddedTexture(embeddedTexture);
-				TextureCache::getCache().emplace(tex.path, tex);
-				std::cout << "CACHE::EMBEDD:uspesno kesiranje teksture: " << tex.type + " " + tex.path << std::endl;
-			}
+		processTexturesForCache(material, "texture_specular");
+	}
 
-		}
-		else {
-			auto it = TextureCache::getCache().find(std::string(str.C_Str()));
-			std::cout << "CACHE::Looking for texture: " << str.C_Str() << "..." << std::endl;
-			if (it != TextureCache::getCache().end()) {
-				skip = true;
-				std::cout << "CACHE::Texture found" << std::endl;
-			}
+}
 
-			if (!skip) {
-				Texture tex;
-				tex.type = name;
-				tex.path = std::string(str.C_Str());
-				tex.id = loadTextureFromFile(str.C_Str(), this->directory);
-				TextureCache::getCache().emplace(tex.path, tex);
-				std::cout << "CACHE::Texture cached: " << tex.type + " " + tex.path << std::endl;
-			}
-		}
+std::string Model::textureRefKey(const TextureRef& ref) const {
+	if (ref.embedded) {
+		return "embedded:" + hashToHex(contentHash64(ref.embeddedData.data(), ref.embeddedData.size())) + ":" + ref.type;
 	}
+	return directory + "/" + ref.path + ":" + ref.type;
 }
 
-unsigned int Model::loadTextureFromFile(const char* path, const std::string& directory) {
-	
-	std::string pathString = std::string(path);
-	std::string texPath = directory + "/" + pathString;
+void Model::groupTextureArrays() {
+	TextureCache& cache = TextureCache::getInstance();
 
-	unsigned int textureID;
-	glGenTextures(1, &textureID);
-
-	int texWidth, texHeight, texNumberOfChannels;
-	unsigned char* texData = stbi_load(texPath.c_str(), &texWidth, &texHeight, &texNumberOfChannels, 0);
-
-	if (texData) {
-
-		GLenum imageformat = GL_RGB;
-		if (texNumberOfChannels == 1) {
-			imageformat = GL_RED;
+	for (PendingTexture& pending : pendingTextures) {
+		// vec na GPU-u kao sloj niza drugog modela, koji god da su ostali slojevi
+		pending.resident = cache.findLayer(pending.decoded.key, pending.layer);
+		if (pending.resident) {
+			std::cout << "CACHE::Texture shared: " << pending.decoded.name << std::endl;
+			pending.decoded = DecodedImage();
+			continue;
 		}
-		if (texNumberOfChannels == 3) {
-			imageformat = GL_RGB;
+
+		// ista slika pod drugom referencom (drugi folder, embedded) je isti sloj
+		bool placed = false;
+		for (size_t a = 0; a < pendingArrays.size() && !placed; a++) {
+			std::vector<DecodedImage>& layers = pendingArrays[a].layers;
+			if (!canShareArray(layers[0], pending.decoded)) continue;
+
+			for (size_t l = 0; l < layers.size() && !placed; l++) {
+				if (pending.decoded.key != 0 && layers[l].key == pending.decoded.key) {
+					pending.array = a;
+					pending.layer = (unsigned int)l;
+					placed = true;
+				}
+			}
+			if (!placed && layers.size() < MAX_ARRAY_LAYERS) {
+				pending.array = a;
+				pending.layer = (unsigned int)layers.size();
+				layers.push_back(std::move(pending.decoded));
+				placed = true;
+			}
 		}
-		if (texNumberOfChannels == 4) {
-			imageformat = GL_RGBA;
+
+		// novi niz: prva slika te velicine i formata, ili neispravna (createTextureArray javi gresku)
+		if (!placed) {
+			pending.array = pendingArrays.size();
+			pending.layer = 0;
+			pendingArrays.emplace_back();
+			pendingArrays.back().layers.push_back(std::move(pending.decoded));
 		}
+		pending.decoded = DecodedImage();
+	}
+}
 
-		glBindTexture(GL_TEXTURE_2D, textureID);
-		glTexImage2D(GL_TEXTURE_2D, 0, imageformat, texWidth, texHeight, 0, imageformat, GL_UNSIGNED_BYTE, texData);
-		//std::cout << "Generisana tekstura! Velicina je: " << texWidth << " * " << texHeight << " = " << texWidth * texHeight << std::endl;
-		//std::cout << "Ucitana tekstura je: " << texPath << std::endl;
-		glGenerateMipmap(GL_TEXTURE_2D);
+bool Model::uploadPendingArray(PendingArray& pending, const std::function<bool()>& budgetSpent) {
+	TextureCache& cache = TextureCache::getInstance();
+	std::string names;
+	for (const DecodedImage& layer : pending.layers) {
+		names += (names.empty() ? "" : ", ") + layer.name;
+	}
 
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	// isti niz (iste slike, istim redom) je mozda vec na GPU-u, od drugog modela
+	TextureHandle shared = cache.find(TextureCache::arrayKey(pending.layers));
+	if (shared) {
+		if (pending.uploadedLevels > 0) {
+			glDeleteTextures(1, &pending.id);
+		}
+		pending.handle = shared;
+		pending.layers.clear();
+		std::cout << "CACHE::Texture array shared: " << names << std::endl;
+		return true;
 	}
-	else {
-		std::cerr << "Failed to load texture at path: " << texPath << std::endl;
+
+	if (pending.uploadedLevels == 0) {
+		pending.id = createTextureArray(pending.layers);
 	}
 
-	stbi_image_free(texData);
-	glBindTexture(GL_TEXTURE_2D, 0); // unbinding je opcionalan uvek
+	// bar jedan nivo po pozivu, da niz napreduje i kad je budzet mali
+	while (pending.uploadedLevels < pending.layers[0].levelCount()) {
+		if (pending.uploadedLevels > 0 && budgetSpent()) return false;
+		uploadTextureArrayLevel(pending.id, pending.layers, pending.uploadedLevels);
+		pending.uploadedLevels++;
+	}
 
-	return textureID;
+	pending.handle = cache.insertArray(pending.layers, pending.id);
+	std::cout << "CACHE::Texture array cached: " << pending.layers.size() << " layers, " << names << std::endl;
+	pending.layers.clear();
+	return true;
 }
 
-unsigned int Model::loadEmbeddedTexture(const aiTexture* texture) {
-	unsigned int textureID;
-	glGenTextures(1, &textureID);
+std::vector<Texture> Model::processTextures(const MaterialData& material) {
 
-	int texWidth, texHeight, texNumberOfChannels;
-	unsigned char* texData;
+	std::vector<Texture> result;
 
-	if (texture->mHeight == 0) {
-		texData = stbi_load_from_memory(reinterpret_cast<unsigned char*>(texture->pcData), texture->mWidth, &texWidth, &texHeight, &texNumberOfChannels, 0);
-	}
-	else {
-		texData = stbi_load_from_memory(reinterpret_cast<unsigned char*>(texture->pcData), texture->mWidth * texture->mHeight, &texWidth, &texHeight, &texNumberOfChannels, 0);
+	for (const TextureRef& ref : material.textures) {
+
+		std::string key = textureRefKey(ref);
+		auto it = textures.find(key);
+		if (it == textures.end()) {
+			TextureLayer loaded = ref.embedded ? loadEmbeddedTexture(ref) : loadTextureFromFile(ref.path.c_str(), this->directory, colorSpaceFor(ref.type));
+			it = textures.emplace(key, loaded).first;
+		}
+
+		Texture tex;
+		tex.id = it->second.array->id;
+		tex.layer = it->second.layer;
+		tex.type = ref.type;
+		tex.path = ref.path;
+		result.push_back(tex);
 	}
 
-	if (texData) {
+	return result;
+}
 
-		GLenum imageformat = GL_RGB;
-		if (texNumberOfChannels == 1) {
-			imageformat = GL_RED;
-		}
-		if (texNumberOfChannels == 3) {
-			imageformat = GL_RGB;
-		}
-		if (texNumberOfChannels == 4) {
-			imageformat = GL_RGBA;
+void Model::processTexturesForCache(const MaterialData& material, std::string name) {
+	for (const TextureRef& ref : material.textures) {
+
+		if (ref.type != name) continue;
+
+		// isti fajl moze da koristi vise materijala, dekodira se jednom
+		std::string key = textureRefKey(ref);
+		bool skip = textures.find(key) != textures.end();
+		for (const PendingTexture& p : pendingTextures) {
+			if (p.texture.path == key) skip = true;
 		}
 
-		glBindTexture(GL_TEXTURE_2D, textureID);
-		glTexImage2D(GL_TEXTURE_2D, 0, imageformat, texWidth, texHeight, 0, imageformat, GL_UNSIGNED_BYTE, texData);
-		//std::cout << "Generisana tekstura! Velicina je: " << texWidth << " * " << texHeight << " = " << texWidth * texHeight << std::endl;
-		//std::cout << "Ucitana tekstura je: " << texture->mFilename.C_Str() << std::endl;
-		glGenerateMipmap(GL_TEXTURE_2D);
+		if (!skip) {
+			PendingTexture p;
+			p.texture.type = name;
+			p.texture.path = key;
+			p.texture.id = 0;
 
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+			if (ref.embedded) {
+				// Ovo je embedded format koji svoje materijale drzi unutar sebe, ne odvojeno.
+				// ref zivi u ModelData, posao ga drzi zivim preko shared_ptr-a.
+				std::shared_ptr<ModelData> data = loadingData;
+				const TextureRef* embedded = &ref;
+				ColorSpace colorSpace = colorSpaceFor(name);
+				p.image = ThreadPool::getInstance().submit([data, embedded, colorSpace]() {
+					return decodeImageMemory(embedded->embeddedData.data(), embedded->embeddedData.size(), embedded->path, colorSpace);
+				});
+			}
+			else {
+				p.image = decodeImageFileAsync(this->directory + "/" + ref.path, colorSpaceFor(name));
+			}
+
+			pendingTextures.push_back(std::move(p));
+		}
 	}
-	else {
-		std::cerr << "Failed to load Embedded texture of name: " << texture->mFilename.C_Str() << std::endl;
+}
+
+Model::TextureLayer Model::acquireLayer(const DecodedImage& image) {
+	TextureLayer result;
+	result.array = TextureCache::getInstance().findLayer(image.key, result.layer);
+	if (result.array) {
+		std::cout << "CACHE::Texture shared: " << image.name << std::endl;
+		return result;
 	}
+	result.array = TextureCache::getInstance().acquireArray({ image });
+	result.layer = 0;
+	return result;
+}
 
-	stbi_image_free(texData);
-	glBindTexture(GL_TEXTURE_2D, 0); // unbinding je opcionalan uvek
+Model::TextureLayer Model::loadTextureFromFile(const char* path, const std::string& directory, ColorSpace colorSpace) {
+	return acquireLayer(decodeImageFile(directory + "/" + std::string(path), colorSpace));
+}
 
-	return textureID;
+Model::TextureLayer Model::loadEmbeddedTexture(const TextureRef& texture) {
+	return acquireLayer(decodeImageMemory(texture.embeddedData.data(), texture.embeddedData.size(), texture.path, colorSpaceFor(texture.type)));
 }
 
 glm::mat4 Model::transformToGLMatrix(aiMatrix4x4 assimpMatrix) {
@@ -2,10 +2,13 @@
 #define _MOJ_MODEL_H_
 
 #include "Mesh.h"
-#include "Node.h"
+#include "ModelData.h"
+#include "SceneGraph.h"
 #include "Shader.h"
 #include "TextureCache.h"
+#include "TextureLoader.h"
 
+#include "functional"
 #include "iostream"
 #include "unordered_map"
 
@@ -13,46 +16,172 @@
 #include "assimp/postprocess.h"
 #include "assimp/scene.h"
 
-#include "stb_image.h"
-
 class Model {
 public:
 
-	Node* rootNode;
+	// najgrublji LOD sme da odstupi od punog mesh-a do ovog dela dijagonale njegove kutije
+	static constexpr float LOD_MAX_ERROR = 0.02f;
+
+	// hijerarhija cvorova, ravni nizovi u depth-first redosledu
+	SceneGraph nodes;
 
 	std::vector<Mesh> meshes;
 
-	Model(const std::string& path) {
-		bool success = loadModel(path);
-		if (!success) {
-			std::cout << "Failed loading model." << std::endl;
-		}
+	// jedan po materijalu iz ModelData, i na kraju prazan za mesh-eve bez materijala
+	std::vector<Material> materials;
+
+	// Blokira dok model nije potpuno ucitan, kao ranije.
+	Model(const std::string& path, VertexFormat format = VertexFormat::Full) {
+		startLoading(path, format, false);
+		streamIn(-1.0);
 	}
 
-	void draw(Shader& shader);
+	~Model();
+
+	// drzi GL objekte, ne kopira se
+	Model(const Model&) = delete;
+	Model& operator=(const Model&) = delete;
+
+	// Returns right away. Import/cooked read and texture decoding run on the ThreadPool,
+	// GL objects are created a few at a time from streamIn(), so the caller can keep rendering.
+	// format: Packed upola smanjuje verteks-e, ali trazi shader sa PACKED_VERTICES.
+	static Model* loadAsync(const std::string& path, VertexFormat format = VertexFormat::Full) {
+		Model* model = new Model();
+		model->startLoading(path, format, true);
+		return model;
+	}
+
+	// Called every frame on the GL thread. Creates textures and meshes until budgetMs runs out;
+	// a negative budget waits for the workers and finishes the whole model.
+	void streamIn(double budgetMs);
+
+	// sve je na GPU-u i model moze da se crta
+	bool isReady() const { return state == LoadState::Ready; }
+
+	// loading finished, successfully or not
+	bool isLoaded() const { return state == LoadState::Ready || state == LoadState::Failed; }
+
+	// Records only the meshes whose world-space box touches the view-projection frustum;
+	// drawn and culled meshes are counted in RenderStats.
+	// lodScale: pikseli koje pokriva jedinica sveta na udaljenosti 1, podeljeno dozvoljenom greskom
+	// u pikselima; 0 uvek crta pune mesh-eve.
+	void draw(RenderQueue& queue, Shader& shader, const glm::mat4& viewProjection, float lodScale = 0.0f);
 
 private:
 
+	enum class LoadState { Importing, Uploading, Ready, Failed };
+
+	// slojevi su u per-vertex bajtu (Mesh::MATERIAL_LAYERS_ATTRIBUTE)
+	static const size_t MAX_ARRAY_LAYERS = 256;
+
+	// tekstura koja se dekodira na ThreadPool-u i ceka upload; texture.path je textureRefKey
+	struct PendingTexture {
+		Texture texture;
+		std::future<DecodedImage> image;
+		// posle image.get(), dok se ne premesti u svoj niz
+		DecodedImage decoded;
+		// niz u pendingArrays i sloj u njemu
+		size_t array = 0;
+		unsigned int layer = 0;
+		// slika je vec sloj niza u TextureCache-u (od drugog modela); tada je layer sloj u tom nizu
+		TextureHandle resident;
+	};
+
+	// slike iste velicine i formata, jedan GL_TEXTURE_2D_ARRAY; nivoi se salju nekoliko po frame-u
+	struct PendingArray {
+		std::vector<DecodedImage> layers;
+		unsigned int id = 0;
+		size_t uploadedLevels = 0;
+		TextureHandle handle;
+	};
+
+	// niz iz TextureCache-a i sloj u njemu
+	struct TextureLayer {
+		TextureHandle array;
+		unsigned int layer = 0;
+	};
+
+	LoadState state = LoadState::Importing;
+
+	// Verteksi i indeksi svih mesh-eva, jedan za drugim; Mesh je samo opseg u njima.
+	// layerVBO: slojevi tekstura materijala po verteksu.
+	unsigned int VAO = 0, VBO = 0, EBO = 0, layerVBO = 0;
+
+	VertexFormat vertexFormat = VertexFormat::Full;
+
+	std::string path;
+
 	// directory in which model is located
 	std::string directory;
 
-	bool loadModel(const std::string& path);
+	// Teksture modela po textureRefKey; handle-ovi drze nizove u TextureCache-u dok model postoji.
+	std::unordered_map<std::string, TextureLayer> textures;
+
+	// Sve ispod postoji samo dok se model ucitava.
+	std::shared_ptr<ModelData> loadingData;
+	std::future<bool> importJob;
+	std::vector<PendingTexture> pendingTextures;
+	std::vector<PendingArray> pendingArrays;
+	bool texturesGrouped = false;
+	size_t decodedTextures = 0;
+	size_t uploadedArrays = 0;
+	unsigned int uploadedVertices = 0;
+	size_t uploadedIndexBytes = 0;
+
+	Model() = default;
+
+	void startLoading(const std::string& path, VertexFormat format, bool async);
+
+	// Posle Assimp importa, pre kuvanja: pakuje verteks-e u format i bira 16-bit indekse gde mogu.
+	static void prepareVertexData(ModelData& data, VertexFormat format);
+
+	// pravi VAO i bafere dovoljno velike za sve mesh-eve iz data; slojeve tekstura popunjava odmah
+	void setupBuffers(const ModelData& data);
+
+	// materijal mesh-a, ili poslednji (prazan) ako ga nema
+	const Material& meshMaterial(const ModelData& data, const MeshData& mesh) const;
+
+	// Cooked fajl ako je ispravan, inace Assimp import + cook. Ne dira GL, moze na bilo kojoj niti.
+	static bool loadModelData(const std::string& path, VertexFormat format, ModelData& data);
+
+	// Assimp import u ModelData, koristi se samo kad cooked fajl ne postoji ili je zastareo.
+	static bool importWithAssimp(const std::string& path, ModelData& data);
+
+	static void processNode(aiNode* node, int parentIndex, ModelData& data);
+
+	static MeshData processMesh(aiMesh* mesh);
+
+	static MaterialData processMaterial(const aiScene* scene, aiMaterial* mat);
+
+	static void processTextureRefs(const aiScene* scene, aiMaterial* mat, aiTextureType type, std::string name, MaterialData& material);
+
+	// Starts decoding every texture the model references; streamIn uploads them (or takes them from the cache).
+	void loadAllTexturesFromMaterialIntoCache(const std::vector<MaterialData>& materials);
+
+	// Kljuc reference unutar modela: fajl po punoj putanji, embedded slika po hash-u sadrzaja
+	// (mFilename ume da bude prazan), uz tip (diffuse/specular se drugacije filtriraju).
+	std::string textureRefKey(const TextureRef& ref) const;
 
-	void loadAllTexturesFromMaterialIntoCache(const aiScene* scene, aiMaterial* mat);
+	// Slike iste velicine i formata idu u isti niz (do MAX_ARRAY_LAYERS slojeva), pa mesh-evi
+	// razlicitih materijala vezuju iste teksture i RenderQueue ih spaja u jedan draw.
+	// Slika koja je vec sloj nekog niza u TextureCache-u se uzima odatle i ne ide u novi niz.
+	void groupTextureArrays();
 
-	Node* processNode(aiNode* node, Node* callingNode);
+	// Salje nivoe dok budgetSpent ne kaze da je dosta; true kad je niz gotov (ili vec postoji u cache-u).
+	bool uploadPendingArray(PendingArray& pending, const std::function<bool()>& budgetSpent);
 
-	Mesh processMesh(aiMesh* mesh, const aiScene* scene);
+	std::vector<Texture> processTextures(const MaterialData& material);
 
-	std::vector<Texture> processTextures(const aiScene* scene, aiMaterial* mat, aiTextureType type, std::string name);
+	void processTexturesForCache(const MaterialData& material, std::string name);
 
-	void processTexturesForCache(const aiScene* scene, aiMaterial* mat, aiTextureType type, std::string name);
+	// sloj postojeceg niza sa istom slikom, ili novi niz od jedne slike
+	TextureLayer acquireLayer(const DecodedImage& image);
 
-	unsigned int loadTextureFromFile(const char* path, const std::string& directory);
+	TextureLayer loadTextureFromFile(const char* path, const std::string& directory, ColorSpace colorSpace);
 
-	unsigned int loadEmbeddedTexture(const aiTexture* texture);
+	TextureLayer loadEmbeddedTexture(const TextureRef& texture);
 
-	glm::mat4 transformToGLMatrix(aiMatrix4x4 assimpMatrix);
+	static glm::mat4 transformToGLMatrix(aiMatrix4x4 assimpMatrix);
 
 };
 
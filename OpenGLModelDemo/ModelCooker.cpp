@@ -0,0 +1,358 @@
+#include "ModelCooker.h"
+#include "AssetCache.h"
+#include "ContentHash.h"
+
+#include <cstring>
+#include <iostream>
+
+static const char COOKED_MAGIC[8] = { 'O', 'G', 'L', 'M', 'O', 'D', 'E', 'L' };
+static const uint64_t BLOB_ALIGNMENT = 16;
+
+struct CookedHeader {
+	char magic[8];
+	uint32_t version;
+	uint32_t vertexSize;
+	uint64_t sourceHash;
+	uint32_t nodeCount;
+	uint32_t meshCount;
+	uint32_t materialCount;
+	uint32_t dependencyCount;
+	// VertexFormat verteks blobova; vertexSize je Mesh::vertexSize tog formata
+	uint32_t vertexFormat;
+	uint32_t reserved;
+	uint64_t metaOffset;
+	uint64_t metaSize;
+	uint64_t blobOffset;
+	uint64_t blobSize;
+	// xxHash meta i blob sekcije; indeksi su provereni pri pisanju, pa ispravni hash-evi znace ispravne
+	// indekse, a i brojeve, velicine indeksa i ofsete koji ih opisuju
+	uint64_t metaHash;
+	uint64_t blobHash;
+};
+
+// najmanje bajtova koje meta deo zauzima po cvoru (prazno ime, bez mesh-eva), mesh-u (bez LOD-ova)
+// i materijalu (bez tekstura); brojevi iz header-a se proveravaju pre nego sto se za njih alocira
+static const uint64_t MIN_NODE_META = 4 + sizeof(glm::mat4) + 4 + 4;
+static const uint64_t MIN_MESH_META = 4 * 4 + 2 * sizeof(glm::vec3) + 2 * 8 + 4;
+static const uint64_t MIN_MATERIAL_META = 4;
+static const uint64_t MIN_DEPENDENCY_META = 4 + 8;
+static const uint64_t QUANTIZATION_META = 2 * sizeof(glm::vec3);
+
+static_assert(sizeof(Vertex) == 32, "cooked format assumes a tightly packed Vertex");
+
+static uint64_t alignUp(uint64_t value, uint64_t alignment) {
+	return (value + alignment - 1) / alignment * alignment;
+}
+
+// Pise male vrednosti u meta deo, a velike nizove u blob deo.
+class CookWriter {
+public:
+	std::vector<unsigned char> meta;
+	std::vector<unsigned char> blobs;
+
+	void u32(uint32_t value) { raw(meta, &value, sizeof(value)); }
+
+	void i32(int32_t value) { raw(meta, &value, sizeof(value)); }
+
+	void u64(uint64_t value) { raw(meta, &value, sizeof(value)); }
+
+	void f32(float value) { raw(meta, &value, sizeof(value)); }
+
+	void str(const std::string& value) {
+		u32(static_cast<uint32_t>(value.size()));
+		raw(meta, value.data(), value.size());
+	}
+
+	void mat4(const glm::mat4& value) { raw(meta, &value[0][0], sizeof(glm::mat4)); }
+
+	void vec3(const glm::vec3& value) { raw(meta, &value[0], sizeof(glm::vec3)); }
+
+	// returns the blob offset, relative to the start of the blob section
+	uint64_t blob(const void* data, size_t size) {
+		blobs.resize(alignUp(blobs.size(), BLOB_ALIGNMENT), 0);
+		uint64_t offset = blobs.size();
+		raw(blobs, data, size);
+		return offset;
+	}
+
+private:
+	static void raw(std::vector<unsigned char>& target, const void* data, size_t size) {
+		const unsigned char* bytes = static_cast<const unsigned char*>(data);
+		target.insert(target.end(), bytes, bytes + size);
+	}
+};
+
+// Cita meta deo uz proveru granica; posle prve greske sve vraca nule i ok() je false.
+class CookReader {
+public:
+	CookReader(const unsigned char* data, uint64_t size) : cursor(data), end(data + size) {}
+
+	bool ok() const { return valid; }
+
+	uint32_t u32() { uint32_t value = 0; raw(&value, sizeof(value)); return value; }
+
+	int32_t i32() { int32_t value = 0; raw(&value, sizeof(value)); return value; }
+
+	uint64_t u64() { uint64_t value = 0; raw(&value, sizeof(value)); return value; }
+
+	float f32() { float value = 0.0f; raw(&value, sizeof(value)); return value; }
+
+	std::string str() {
+		uint32_t length = u32();
+		if (!valid || static_cast<uint64_t>(end - cursor) < length) {
+			valid = false;
+			return std::string();
+		}
+		std::string value(reinterpret_cast<const char*>(cursor), length);
+		cursor += length;
+		return value;
+	}
+
+	glm::mat4 mat4() { glm::mat4 value(1.0f); raw(&value[0][0], sizeof(glm::mat4)); return value; }
+
+	glm::vec3 vec3() { glm::vec3 value(0.0f); raw(&value[0], sizeof(glm::vec3)); return value; }
+
+private:
+	const unsigned char* cursor;
+	const unsigned char* end;
+	bool valid = true;
+
+	void raw(void* out, size_t size) {
+		if (!valid || static_cast<size_t>(end - cursor) < size) {
+			valid = false;
+			return;
+		}
+		memcpy(out, cursor, size);
+		cursor += size;
+	}
+};
+
+bool ModelCooker::write(const std::string& cookedPath, uint64_t sourceHash, const ModelData& data) {
+	// indeks van mesh-a bi GPU citao van bafera; takav model se ne kuva.
+	// Provera ide po 32-bit indeksima iz importa, koje prepareVertexData ostavlja netaknute.
+	for (const MeshData& mesh : data.meshes) {
+		for (unsigned int i = 0; i < mesh.indexCount; i++) {
+			if (mesh.indices[i] >= mesh.vertexCount) {
+				std::cout << "COOK::indeks van opsega verteksa, model se ne kuva: " << cookedPath << std::endl;
+				return false;
+			}
+		}
+	}
+
+	CookWriter writer;
+
+	// zavisnosti prve, da read() odbaci zastareo fajl pre citanja ostatka
+	for (const SourceDependency& dependency : data.dependencies) {
+		writer.str(dependency.path);
+		writer.u64(dependency.hash);
+	}
+
+	writer.vec3(data.quantization.offset);
+	writer.vec3(data.quantization.scale);
+
+	for (const NodeData& node : data.nodes) {
+		writer.str(node.name);
+		writer.mat4(node.localTransform);
+		writer.i32(node.parent);
+		writer.u32(static_cast<uint32_t>(node.meshIndices.size()));
+		for (unsigned int meshIndex : node.meshIndices) {
+			writer.u32(meshIndex);
+		}
+	}
+
+	for (const MeshData& mesh : data.meshes) {
+		writer.u32(mesh.vertexCount);
+		writer.u32(mesh.indexCount);
+		writer.u32(mesh.indexSize);
+		writer.u32(mesh.materialIndex);
+		writer.vec3(mesh.bounds.min);
+		writer.vec3(mesh.bounds.max);
+		writer.u64(writer.blob(mesh.uploadVertices, Mesh::vertexSize(data.vertexFormat) * mesh.vertexCount));
+		writer.u64(writer.blob(mesh.uploadIndices, (size_t)mesh.indexSize * mesh.indexCount));
+		writer.u32(static_cast<uint32_t>(mesh.lods.size()));
+		for (const MeshLod& lod : mesh.lods) {
+			writer.u32(lod.firstIndex);
+			writer.u32(lod.indexCount);
+			writer.f32(lod.error);
+		}
+	}
+
+	for (const MaterialData& material : data.materials) {
+		writer.u32(static_cast<uint32_t>(material.textures.size()));
+		for (const TextureRef& texture : material.textures) {
+			writer.str(texture.type);
+			writer.str(texture.path);
+			writer.u32(texture.embedded ? 1 : 0);
+			writer.u32(texture.embeddedWidth);
+			writer.u32(texture.embeddedHeight);
+			writer.u64(texture.embeddedData.size());
+			writer.u64(writer.blob(texture.embeddedData.data(), texture.embeddedData.size()));
+		}
+	}
+
+	CookedHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, COOKED_MAGIC, sizeof(COOKED_MAGIC));
+	header.version = VERSION;
+	header.vertexSize = static_cast<uint32_t>(Mesh::vertexSize(data.vertexFormat));
+	header.sourceHash = sourceHash;
+	header.nodeCount = static_cast<uint32_t>(data.nodes.size());
+	header.meshCount = static_cast<uint32_t>(data.meshes.size());
+	header.materialCount = static_cast<uint32_t>(data.materials.size());
+	header.dependencyCount = static_cast<uint32_t>(data.dependencies.size());
+	header.vertexFormat = static_cast<uint32_t>(data.vertexFormat);
+	header.metaOffset = sizeof(CookedHeader);
+	header.metaSize = writer.meta.size();
+	header.blobOffset = alignUp(header.metaOffset + header.metaSize, BLOB_ALIGNMENT);
+	header.blobSize = writer.blobs.size();
+	header.metaHash = contentHash64(writer.meta.data(), writer.meta.size());
+	header.blobHash = contentHash64(writer.blobs.data(), writer.blobs.size());
+
+	std::vector<unsigned char> file(header.blobOffset + header.blobSize, 0);
+	memcpy(file.data(), &header, sizeof(header));
+	if (!writer.meta.empty()) {
+		memcpy(file.data() + header.metaOffset, writer.meta.data(), writer.meta.size());
+	}
+	if (!writer.blobs.empty()) {
+		memcpy(file.data() + header.blobOffset, writer.blobs.data(), writer.blobs.size());
+	}
+
+	return AssetCache::writeFile(cookedPath, file.data(), file.size());
+}
+
+bool ModelCooker::read(const std::string& cookedPath, uint64_t sourceHash, VertexFormat format, ModelData& data) {
+	std::shared_ptr<MappedFile> mapping = std::make_shared<MappedFile>(cookedPath);
+	if (!mapping->isOpen() || mapping->size() < sizeof(CookedHeader)) {
+		return false;
+	}
+
+	CookedHeader header;
+	memcpy(&header, mapping->data(), sizeof(header));
+
+	if (memcmp(header.magic, COOKED_MAGIC, sizeof(COOKED_MAGIC)) != 0 ||
+		header.version != VERSION ||
+		header.vertexFormat != static_cast<uint32_t>(format) ||
+		header.vertexSize != Mesh::vertexSize(format)) {
+		std::cout << "COOK::zastareo format, ponovo se importuje: " << cookedPath << std::endl;
+		return false;
+	}
+	if (header.sourceHash != sourceHash) {
+		std::cout << "COOK::izvorni fajl promenjen, ponovo se importuje: " << cookedPath << std::endl;
+		return false;
+	}
+	// oduzimanje umesto sabiranja, da ogromni ofseti iz ostecenog fajla ne bi presli preko 2^64
+	uint64_t fileSize = mapping->size();
+	if (header.metaOffset > fileSize || header.metaSize > fileSize - header.metaOffset ||
+		header.blobOffset > fileSize || header.blobSize > fileSize - header.blobOffset ||
+		header.blobOffset % BLOB_ALIGNMENT != 0 ||
+		header.nodeCount * MIN_NODE_META + header.meshCount * MIN_MESH_META + header.materialCount * MIN_MATERIAL_META +
+		header.dependencyCount * MIN_DEPENDENCY_META + QUANTIZATION_META > header.metaSize ||
+		contentHash64(mapping->data() + header.metaOffset, header.metaSize) != header.metaHash ||
+		contentHash64(mapping->data() + header.blobOffset, header.blobSize) != header.blobHash) {
+		std::cout << "COOK::ostecen fajl: " << cookedPath << std::endl;
+		return false;
+	}
+
+	const unsigned char* blobBase = mapping->data() + header.blobOffset;
+	// blob mora da stane u blob sekciju
+	auto blobAt = [&](uint64_t offset, uint64_t size) -> const unsigned char* {
+		if (offset > header.blobSize || size > header.blobSize - offset) return nullptr;
+		return blobBase + offset;
+	};
+
+	CookReader reader(mapping->data() + header.metaOffset, header.metaSize);
+	ModelData cooked;
+
+	for (uint32_t i = 0; i < header.dependencyCount && reader.ok(); i++) {
+		SourceDependency dependency;
+		dependency.path = reader.str();
+		dependency.hash = reader.u64();
+
+		uint64_t currentHash = 0;
+		if (reader.ok() && (!hashFile(dependency.path, currentHash) || currentHash != dependency.hash)) {
+			std::cout << "COOK::izvorni fajl promenjen, ponovo se importuje: " << dependency.path << std::endl;
+			return false;
+		}
+		cooked.dependencies.push_back(dependency);
+	}
+
+	cooked.vertexFormat = format;
+	cooked.quantization.offset = reader.vec3();
+	cooked.quantization.scale = reader.vec3();
+
+	cooked.nodes.resize(header.nodeCount);
+	for (uint32_t i = 0; i < header.nodeCount && reader.ok(); i++) {
+		NodeData& node = cooked.nodes[i];
+		node.name = reader.str();
+		node.localTransform = reader.mat4();
+		node.parent = reader.i32();
+		uint32_t meshIndexCount = reader.u32();
+		for (uint32_t j = 0; j < meshIndexCount && reader.ok(); j++) {
+			uint32_t meshIndex = reader.u32();
+			if (meshIndex >= header.meshCount) return false;
+			node.meshIndices.push_back(meshIndex);
+		}
+		if (node.parent >= static_cast<int>(i)) return false;
+	}
+
+	cooked.meshes.resize(header.meshCount);
+	for (uint32_t i = 0; i < header.meshCount && reader.ok(); i++) {
+		MeshData& mesh = cooked.meshes[i];
+		mesh.vertexCount = reader.u32();
+		mesh.indexCount = reader.u32();
+		mesh.indexSize = reader.u32();
+		mesh.materialIndex = reader.u32();
+		mesh.bounds.min = reader.vec3();
+		mesh.bounds.max = reader.vec3();
+		uint64_t vertexOffset = reader.u64();
+		uint64_t indexOffset = reader.u64();
+
+		// 16-bit indeksi samo za mesh koji ih moze adresirati
+		bool shortIndices = mesh.indexSize == sizeof(uint16_t) && mesh.vertexCount <= 65536;
+		if (!shortIndices && mesh.indexSize != sizeof(unsigned int)) return false;
+
+		mesh.uploadVertices = blobAt(vertexOffset, header.vertexSize * (uint64_t)mesh.vertexCount);
+		mesh.uploadIndices = blobAt(indexOffset, mesh.indexSize * (uint64_t)mesh.indexCount);
+		if (!mesh.uploadVertices || !mesh.uploadIndices) return false;
+
+		uint32_t lodCount = reader.u32();
+		for (uint32_t j = 0; j < lodCount && reader.ok(); j++) {
+			MeshLod lod;
+			lod.firstIndex = reader.u32();
+			lod.indexCount = reader.u32();
+			lod.error = reader.f32();
+			if ((uint64_t)lod.firstIndex + lod.indexCount > mesh.indexCount) return false;
+			mesh.lods.push_back(lod);
+		}
+	}
+
+	cooked.materials.resize(header.materialCount);
+	for (uint32_t i = 0; i < header.materialCount && reader.ok(); i++) {
+		uint32_t textureCount = reader.u32();
+		for (uint32_t j = 0; j < textureCount && reader.ok(); j++) {
+			TextureRef texture;
+			texture.type = reader.str();
+			texture.path = reader.str();
+			texture.embedded = reader.u32() != 0;
+			texture.embeddedWidth = reader.u32();
+			texture.embeddedHeight = reader.u32();
+			uint64_t dataSize = reader.u64();
+			uint64_t dataOffset = reader.u64();
+
+			const unsigned char* bytes = blobAt(dataOffset, dataSize);
+			if (!bytes) return false;
+			texture.embeddedData.assign(bytes, bytes + dataSize);
+
+			cooked.materials[i].textures.push_back(texture);
+		}
+	}
+
+	if (!reader.ok()) {
+		std::cout << "COOK::ostecen fajl: " << cookedPath << std::endl;
+		return false;
+	}
+
+	cooked.mapping = mapping;
+	data = std::move(cooked);
+	return true;
+}
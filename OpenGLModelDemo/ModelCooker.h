@@ -0,0 +1,34 @@
+#ifndef _MOJ_MODEL_COOKER_H_
+#define _MOJ_MODEL_COOKER_H_
+
+#include <cstdint>
+#include <string>
+
+#include "ModelData.h"
+
+// Binarni "cooked" format modela.
+//
+// header | meta (cvorovi, mesh-evi, materijali) | blobovi (vertex i index nizovi, embedded teksture)
+//
+// Vertex/index blobs are 16-byte aligned and stored exactly as Model::streamIn uploads them
+// (vertices already in the VertexFormat, 16-bit indices where the mesh allows, plus the shared
+// quantization box), so a mapped file goes straight into glBufferSubData without touching single vertices.
+// The header records the hash of the source file, and the meta section the path and hash of every
+// other file the import read (the .mtl next to an .obj, for example); any mismatch (or a different
+// version, VertexFormat or vertex layout) makes read() fail and the model is imported again with Assimp.
+// Indices are checked against their mesh's vertex count when writing, and the meta and blob
+// sections carry their own hashes, so a damaged file is re-imported instead of drawing out of range.
+// Little-endian only, like every platform this project builds on.
+class ModelCooker {
+public:
+
+	static const uint32_t VERSION = 7;
+
+	static bool write(const std::string& cookedPath, uint64_t sourceHash, const ModelData& data);
+
+	// Maps the cooked file; on success data points into the mapping, which data keeps alive.
+	static bool read(const std::string& cookedPath, uint64_t sourceHash, VertexFormat format, ModelData& data);
+
+};
+
+#endif
@@ -0,0 +1,116 @@
+#ifndef _MOJ_MODEL_DATA_H_
+#define _MOJ_MODEL_DATA_H_
+
+#include "glm/glm.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Bounds.h"
+#include "Mesh.h"
+#include "MappedFile.h"
+#include "VertexPacking.h"
+
+// CPU strana modela, bez ijednog GL objekta.
+// Puni je ili Assimp import ili cooked fajl, a Model od nje pravi bafere i teksture.
+
+struct NodeData {
+	std::string name;
+
+	// transformacija u odnosu na roditelja
+	glm::mat4 localTransform;
+
+	// index roditelja u ModelData::nodes, -1 za koren. Roditelj je uvek pre deteta (depth-first).
+	int parent;
+
+	std::vector<unsigned int> meshIndices;
+};
+
+struct TextureRef {
+	// texture_diffuse or texture_specular
+	std::string type;
+
+	// putanja relativna na folder modela, ili mFilename embedded teksture
+	std::string path;
+
+	bool embedded = false;
+
+	// Embedded textures carry their bytes along, as aiTexture does:
+	// height 0 means data holds a compressed file (png, jpg...) of width bytes.
+	unsigned int embeddedWidth = 0;
+	unsigned int embeddedHeight = 0;
+	std::vector<unsigned char> embeddedData;
+};
+
+struct MaterialData {
+	// diffuse pa specular, istim redosledom kojim ih mesh binduje
+	std::vector<TextureRef> textures;
+};
+
+struct MeshData {
+	// Verteksi i 32-bit indeksi iz Assimp importa (optimizer, LOD-ovi, provera pri kuvanju).
+	// Cooked fajl ih ne cuva, pa su posle njegovog citanja nullptr; brojevi vaze uvek.
+	const Vertex* vertices = nullptr;
+	unsigned int vertexCount = 0;
+
+	// prvo pun mesh, pa indeksi grubljih LOD-ova jedan za drugim
+	const unsigned int* indices = nullptr;
+	unsigned int indexCount = 0;
+
+	// Bytes exactly as streamIn() hands them to glBufferSubData: vertices in the model's VertexFormat,
+	// indices of indexSize bytes (2 or 4). Point into the vectors here or into a mapped cooked file.
+	const void* uploadVertices = nullptr;
+	const void* uploadIndices = nullptr;
+	unsigned int indexSize = sizeof(unsigned int);
+
+	// opisi LOD-ova u indices; prazno = jedan nivo, svi indeksi
+	std::vector<MeshLod> lods;
+
+	unsigned int materialIndex = 0;
+
+	// kutija oko svih pozicija, u prostoru mesh-a (cvora kome pripada)
+	AABB bounds;
+
+	std::vector<Vertex> ownedVertices;
+	std::vector<unsigned int> ownedIndices;
+
+	// Popunjava Model::prepareVertexData, samo posle Assimp importa:
+	// pakovani verteksi (samo VertexFormat::Packed) i 16-bit indeksi (mesh sa manje od 65536 verteksa).
+	std::vector<PackedVertex> packedVertices;
+	std::vector<uint16_t> shortIndices;
+
+	// usmerava pokazivace na sopstvene vektore (posle Assimp importa)
+	void useOwnedData() {
+		vertices = ownedVertices.data();
+		vertexCount = static_cast<unsigned int>(ownedVertices.size());
+		indices = ownedIndices.data();
+		indexCount = static_cast<unsigned int>(ownedIndices.size());
+	}
+};
+
+// Fajl koji je import procitao pored samog modela (npr. .mtl uz .obj) i xxHash njegovog sadrzaja.
+struct SourceDependency {
+	std::string path;
+	uint64_t hash = 0;
+};
+
+struct ModelData {
+	std::vector<NodeData> nodes;
+	std::vector<MeshData> meshes;
+	std::vector<MaterialData> materials;
+
+	// cooked fajl vazi samo dok se ni jedan od ovih fajlova ne promeni
+	std::vector<SourceDependency> dependencies;
+
+	// format u kome su uploadVertices svih mesh-eva
+	VertexFormat vertexFormat = VertexFormat::Full;
+
+	// zajednicka za sve pakovane mesh-eve modela, da bi mogli u isti multi-draw
+	PositionQuantization quantization;
+
+	// Drzi cooked fajl mapiranim dok god MeshData pokazuje u njega.
+	std::shared_ptr<MappedFile> mapping;
+};
+
+#endif
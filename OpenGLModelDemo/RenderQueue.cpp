@@ -0,0 +1,162 @@
+#include "RenderQueue.h"
+#include "RenderStats.h"
+#include "TextureCache.h"
+
+#include <algorithm>
+#include <cstring>
+
+// sirine polja kljuca
+static const int DEPTH_BITS = 24;
+static const int VAO_BITS = 14;
+static const int TEXTURE_SET_BITS = 12;
+static const int PROGRAM_BITS = 11;
+
+static uint64_t field(uint64_t value, int bits) {
+	return value & ((1ull << bits) - 1);
+}
+
+unsigned int RenderQueue::registerTextureSet(const TextureSet& textures) {
+	auto it = textureSetIds.find(textures);
+	if (it != textureSetIds.end()) return it->second;
+
+	textureSets.push_back(textures);
+	uint id = static_cast<uint>(textureSets.size());
+	textureSetIds.emplace(textures, id);
+	return id;
+}
+
+void RenderQueue::add(const DrawCommand& command) {
+	order.push_back({ makeKey(command), static_cast<uint>(commands.size()) });
+	commands.push_back(command);
+}
+
+uint64_t RenderQueue::makeKey(const DrawCommand& command) const {
+	float normalized = std::min(std::max(command.depth / farPlane, 0.0f), 1.0f);
+	uint64_t depth = static_cast<uint64_t>(normalized * ((1 << DEPTH_BITS) - 1));
+
+	uint64_t program = field(command.shader->programID, PROGRAM_BITS);
+	uint64_t textures = field(command.textureSet, TEXTURE_SET_BITS);
+	uint64_t vao = field(command.VAO, VAO_BITS);
+
+	if (!command.transparent) {
+		return (program << 50) | (textures << 38) | (vao << 24) | depth;
+	}
+
+	// pass 1, blend 1, pa dalje ka blizem
+	uint64_t farToNear = field(~depth, DEPTH_BITS);
+	return (1ull << 62) | (1ull << 61) | (farToNear << 37) | (program << 26) | (textures << 14) | vao;
+}
+
+bool RenderQueue::canMerge(const DrawCommand& first, const DrawCommand& second) {
+	return first.instanceCount == 0 && second.instanceCount == 0 &&
+		first.shader == second.shader &&
+		first.VAO == second.VAO &&
+		first.textureSet == second.textureSet &&
+		first.transparent == second.transparent &&
+		first.indexType == second.indexType &&
+		first.modelUniform.location == second.modelUniform.location &&
+		memcmp(&first.model, &second.model, sizeof(glm::mat4)) == 0 &&
+		first.positionOffsetUniform.location == second.positionOffsetUniform.location &&
+		first.positionOffset == second.positionOffset &&
+		first.positionScale == second.positionScale;
+}
+
+void RenderQueue::submit() {
+	std::sort(order.begin(), order.end());
+
+	RenderStats& stats = RenderStats::getInstance();
+	TextureCache& textureCache = TextureCache::getInstance();
+
+	// stanje pre prvog draw-a nije poznato, pa se prvo sve postavlja
+	const Shader* currentShader = nullptr;
+	uint currentVAO = ~0u;
+	uint currentTextureSet = 0;
+	uint boundTextures[TextureSet::MAX_UNITS];
+	GLenum boundTargets[TextureSet::MAX_UNITS] = {};
+	std::fill(boundTextures, boundTextures + TextureSet::MAX_UNITS, ~0u);
+	int blending = -1;
+
+	for (size_t i = 0; i < order.size(); i++) {
+		const DrawCommand& command = commands[order[i].second];
+
+		if (blending != (command.transparent ? 1 : 0)) {
+			blending = command.transparent ? 1 : 0;
+			if (blending) glEnable(GL_BLEND);
+			else glDisable(GL_BLEND);
+		}
+
+		if (command.shader != currentShader) {
+			command.shader->use();
+			currentShader = command.shader;
+			stats.programChanges++;
+		}
+
+		if (command.textureSet != 0 && command.textureSet != currentTextureSet) {
+			const TextureSet& textures = textureSets[command.textureSet - 1];
+			for (int unit = 0; unit < TextureSet::MAX_UNITS; unit++) {
+				GLenum target = textures.target(unit);
+				if (boundTextures[unit] == textures.ids[unit] && boundTargets[unit] == target) continue;
+
+				glActiveTexture(GL_TEXTURE0 + unit);
+				glBindTexture(target, textures.ids[unit]);
+				boundTextures[unit] = textures.ids[unit];
+				boundTargets[unit] = target;
+				textureCache.markUsed(textures.ids[unit]);
+				stats.textureBinds++;
+			}
+			currentTextureSet = command.textureSet;
+		}
+
+		if (command.VAO != currentVAO) {
+			glBindVertexArray(command.VAO);
+			currentVAO = command.VAO;
+			stats.vaoBinds++;
+		}
+
+		if (command.modelUniform.location >= 0) {
+			command.shader->setMat4(command.modelUniform, command.model);
+		}
+		if (command.positionOffsetUniform.location >= 0) {
+			command.shader->setVec3(command.positionOffsetUniform, command.positionOffset);
+			command.shader->setVec3(command.positionScaleUniform, command.positionScale);
+		}
+
+		const void* offset = (const void*)(size_t)command.indexOffset;
+
+		// komande koje slede sa istim stanjem idu u isti poziv
+		size_t runEnd = i + 1;
+		while (runEnd < order.size() && canMerge(command, commands[order[runEnd].second])) {
+			runEnd++;
+		}
+
+		if (command.instanceCount > 0) {
+			glDrawElementsInstancedBaseVertex(GL_TRIANGLES, command.indexCount, command.indexType, offset, (GLsizei)command.instanceCount, command.baseVertex);
+			stats.triangles += command.indexCount / 3 * command.instanceCount;
+		}
+		else if (runEnd == i + 1) {
+			glDrawElementsBaseVertex(GL_TRIANGLES, command.indexCount, command.indexType, offset, command.baseVertex);
+			stats.triangles += command.indexCount / 3;
+		}
+		else {
+			multiCounts.clear();
+			multiOffsets.clear();
+			multiBaseVertices.clear();
+			for (size_t k = i; k < runEnd; k++) {
+				const DrawCommand& part = commands[order[k].second];
+				multiCounts.push_back((GLsizei)part.indexCount);
+				multiOffsets.push_back((const void*)(size_t)part.indexOffset);
+				multiBaseVertices.push_back(part.baseVertex);
+				stats.triangles += part.indexCount / 3;
+			}
+			glMultiDrawElementsBaseVertex(GL_TRIANGLES, multiCounts.data(), command.indexType, multiOffsets.data(), (GLsizei)multiCounts.size(), multiBaseVertices.data());
+			i = runEnd - 1;
+		}
+		stats.drawCalls++;
+	}
+
+	glBindVertexArray(0);
+	glActiveTexture(GL_TEXTURE0);
+
+	commands.clear();
+	order.clear();
+}
@@ -0,0 +1,126 @@
+#ifndef _MOJ_RENDER_QUEUE_H_
+#define _MOJ_RENDER_QUEUE_H_
+
+#include "glad/glad.h"
+#include "glm/glm.hpp"
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+#include "Shader.h"
+
+// Teksture po texture unit-u koje jedan draw ocekuje; 0 = na tom unit-u nista.
+struct TextureSet {
+	static const int MAX_UNITS = 8;
+
+	unsigned int ids[MAX_UNITS] = {};
+
+	// bit po unit-u: tekstura je GL_TEXTURE_2D_ARRAY, ne GL_TEXTURE_2D
+	unsigned int arrayUnits = 0;
+
+	GLenum target(int unit) const { return (arrayUnits >> unit) & 1 ? GL_TEXTURE_2D_ARRAY : GL_TEXTURE_2D; }
+
+	bool operator<(const TextureSet& other) const {
+		for (int unit = 0; unit < MAX_UNITS; unit++) {
+			if (ids[unit] != other.ids[unit]) return ids[unit] < other.ids[unit];
+		}
+		return arrayUnits < other.arrayUnits;
+	}
+};
+
+// Jedan snimljen draw. Uniformi koji vaze za ceo frame (view, projection, svetla) se postavljaju
+// pre submit-a; uz komandu ide samo model matrica.
+struct DrawCommand {
+	Shader* shader = nullptr;
+	unsigned int VAO = 0;
+
+	// indexCount indeksa od bajta indexOffset u index buffer-u VAO-a; indeksi se sabiraju sa baseVertex
+	unsigned int indexOffset = 0;
+	unsigned int indexCount = 0;
+	GLenum indexType = GL_UNSIGNED_INT;
+	int baseVertex = 0;
+
+	// 0 = glDrawElements, inace glDrawElementsInstanced sa toliko instanci
+	unsigned int instanceCount = 0;
+
+	// from RenderQueue::registerTextureSet(); 0 leaves the bound textures alone
+	unsigned int textureSet = 0;
+
+	// neispravan (-1) uniform = komanda nema svoju model matricu
+	Uniform modelUniform;
+	glm::mat4 model = glm::mat4(1.0f);
+
+	// dekvantizacija pakovanih pozicija, postavlja se samo ako je uniform ispravan
+	Uniform positionOffsetUniform, positionScaleUniform;
+	glm::vec3 positionOffset = glm::vec3(0.0f);
+	glm::vec3 positionScale = glm::vec3(1.0f);
+
+	// udaljenost od kamere (clip w), za redosled unutar istog stanja
+	float depth = 0.0f;
+
+	bool transparent = false;
+};
+
+// Draws are recorded during the frame and issued by submit(), sorted by a 64-bit key:
+//
+//   63..62 pass | 61 blend | opaque:      60..50 program | 49..38 texture set | 37..24 VAO | 23..0 depth
+//                          | transparent: 60..37 inverted depth | 36..26 program | 25..14 texture set | 13..0 VAO
+//
+// Opaque draws come first, with blending off, grouped by state and front-to-back inside a group.
+// Transparent ones follow back-to-front with blending on. submit() only touches GL state that differs
+// from the previous draw, so program/texture/VAO switches follow the number of unique states.
+// Neighbouring non-instanced draws with the same state, index type and uniforms (meshes of one model
+// that share a material and a node) become a single glMultiDrawElementsBaseVertex.
+class RenderQueue {
+	typedef unsigned int uint;
+public:
+	static RenderQueue& getInstance() {
+		static RenderQueue queue;
+		return queue;
+	}
+
+	// Isti skup tekstura uvek dobija isti id, do kraja programa. Poziva se pri ucitavanju,
+	// ne za svaki draw.
+	uint registerTextureSet(const TextureSet& textures);
+
+	// command.depth se u kljucu svodi na [0, farPlane]
+	void add(const DrawCommand& command);
+
+	// Sorts and issues every recorded draw, then empties the queue.
+	void submit();
+
+	void setFarPlane(float distance) { farPlane = distance; }
+
+	RenderQueue(const RenderQueue&) = delete;
+	RenderQueue& operator=(const RenderQueue&) = delete;
+
+private:
+
+	std::vector<DrawCommand> commands;
+
+	// kljuc i indeks komande, sortira se ovo umesto samih komandi
+	std::vector<std::pair<uint64_t, uint>> order;
+
+	std::map<TextureSet, uint> textureSetIds;
+
+	// indeks = id - 1
+	std::vector<TextureSet> textureSets;
+
+	// argumenti jednog multi-draw-a, cuvaju kapacitet izmedju frame-ova
+	std::vector<GLsizei> multiCounts;
+	std::vector<const void*> multiOffsets;
+	std::vector<GLint> multiBaseVertices;
+
+	float farPlane = 100.0f;
+
+	RenderQueue() = default;
+
+	uint64_t makeKey(const DrawCommand& command) const;
+
+	// isto stanje, tip indeksa i uniformi, pa mogu u isti multi-draw
+	static bool canMerge(const DrawCommand& first, const DrawCommand& second);
+
+};
+
+#endif
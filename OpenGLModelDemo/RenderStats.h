@@ -0,0 +1,50 @@
+#ifndef _RENDER_STATS_H_
+#define _RENDER_STATS_H_
+
+// Brojaci za jedan frame. Resetuje ih onaj ko crta (main ili bench) na pocetku frame-a.
+class RenderStats {
+	typedef unsigned int uint;
+public:
+	static RenderStats& getInstance() {
+		static RenderStats stats;
+		return stats;
+	}
+
+	// every glDraw* call issued this frame
+	uint drawCalls = 0;
+
+	// triangles those calls drew, every instance counted
+	uint triangles = 0;
+
+	// model meshes that passed / failed the frustum test
+	uint meshesDrawn = 0;
+	uint meshesCulled = 0;
+
+	// GL state actually changed by RenderQueue::submit()
+	uint programChanges = 0;
+	uint textureBinds = 0;
+	uint vaoBinds = 0;
+
+	// point svetla poslata shaderima, i zbir svetala po svim klasterima (LightBuffer::upload())
+	uint pointLights = 0;
+	uint clusterLightIndices = 0;
+
+	void reset() {
+		drawCalls = 0;
+		triangles = 0;
+		meshesDrawn = 0;
+		meshesCulled = 0;
+		programChanges = 0;
+		textureBinds = 0;
+		vaoBinds = 0;
+		pointLights = 0;
+		clusterLightIndices = 0;
+	}
+
+private:
+
+	RenderStats() = default;
+
+};
+
+#endif
@@ -0,0 +1,586 @@
+#include "Scene.h"
+#include "TextureLoader.h"
+
+// GLM Include
+#include "glm/gtc/matrix_transform.hpp"
+#include "glm/gtc/quaternion.hpp"
+#include "glm/gtx/quaternion.hpp"
+#include "glm/gtc/type_ptr.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <iostream>
+#include <random>
+#include <string>
+
+Scene::Scene() {
+
+	// za transparentne teksture; blending ukljucuje RenderQueue, samo za transparentni prolaz
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	RenderQueue::getInstance().setFarPlane(FAR_PLANE);
+	// omogucava dubinsko testiranje
+	glEnable(GL_DEPTH_TEST);
+
+	//STBI za ucitavanja tekstura ucitava pravilno, kako OPENGLu odgovara
+	setFlipVerticallyOnLoad(true);
+
+	// Teksture scene se dekodiraju na ThreadPool-u dok se kompajliraju shaderi
+	std::future<DecodedImage> boxDiffuseImage = decodeImageFileAsync("textures/dosadnakutija.png", ColorSpace::SRGB);
+	std::future<DecodedImage> dnkGreenImage = decodeImageFileAsync("textures/dnkgreen.png", ColorSpace::SRGB);
+	std::future<DecodedImage> dnkRedImage = decodeImageFileAsync("textures/dnkred.png", ColorSpace::SRGB);
+	std::future<DecodedImage> dnkSpecImage = decodeImageFileAsync("textures/dnkSPEC.png", ColorSpace::Linear);
+
+	setupCube();
+
+	// SHADER SETUP
+
+	lights = new LightBuffer();
+	createPrograms(forwardPrograms, false);
+
+	// Ucitavanje tekstura
+	TextureCache& textureCache = TextureCache::getInstance();
+	boxDiffuse = textureCache.acquire(boxDiffuseImage.get());
+	dnkDiffuse = textureCache.acquireArray({ dnkGreenImage.get(), dnkRedImage.get() });
+	dnkSpec = textureCache.acquire(dnkSpecImage.get());
+
+	TextureSet helixTextures;
+	helixTextures.ids[0] = dnkDiffuse->id;
+	helixTextures.ids[1] = dnkSpec->id;
+	helixTextures.arrayUnits = 1u << 0;
+	helixTextureSet = RenderQueue::getInstance().registerTextureSet(helixTextures);
+
+	torusConeModel = Model::loadAsync("models/toruscone/torus.obj", MODEL_VERTEX_FORMAT);
+	backpackModel = Model::loadAsync("models/backpack2/backpack.obj", MODEL_VERTEX_FORMAT);
+}
+
+Scene::~Scene() {
+	delete torusConeModel;
+	delete backpackModel;
+
+	deletePrograms(forwardPrograms);
+	deletePrograms(deferredPrograms);
+	delete gbuffer;
+
+	InstanceBatch* batches[] = { &helixCubes, &helixBeams, &lightMarkers, &modelLight };
+	for (InstanceBatch* batch : batches) {
+		glDeleteVertexArrays(1, &batch->VAO);
+		glDeleteBuffers(1, &batch->instanceVBO);
+	}
+	glDeleteVertexArrays(1, &kockaVAO);
+	glDeleteBuffers(1, &kockaVBO);
+	glDeleteBuffers(1, &kockaEBO);
+
+	delete lights;
+}
+
+void Scene::setupCube() {
+
+	// Defining cube - definisanje kocke
+	float kockaTacke[] = {
+		// koordinate			normale			tex. koordinate
+
+		// prednja strana kocke
+		-0.5f, -0.5f, 0.5f,		0.0f, 0.0f, 1.0f,	0.0f, 0.0f,
+		-0.5f, 0.5f, 0.5f,		0.0f, 0.0f, 1.0f,	0.0f, 1.0f,
+		0.5f, 0.5f, 0.5f,		0.0f, 0.0f, 1.0f,	1.0f, 1.0f,
+		0.5f, -0.5f, 0.5f,		0.0f, 0.0f, 1.0f,	1.0f, 0.0f,
+
+		//zadnja strana kocke
+		-0.5f, -0.5f, -0.5f,	0.0f, 0.0f, -1.0f,	0.0f, 0.0f,
+		-0.5f, 0.5f, -0.5f,		0.0f, 0.0f, -1.0f,	0.0f, 1.0f,
+		0.5f, 0.5f, -0.5f,		0.0f, 0.0f, -1.0f,	1.0f, 1.0f,
+		0.5f, -0.5f,-0.5f,		0.0f, 0.0f, -1.0f,	1.0f, 0.0f,
+
+		//gornja
+		-0.5f, 0.5f, 0.5f,		0.0f, 1.0f, 0.0f,	0.0f, 0.0f,
+		-0.5f, 0.5f, -0.5f,		0.0f, 1.0f, 0.0f,	0.0f, 1.0f,
+		0.5f, 0.5f, -0.5f,		0.0f, 1.0f, 0.0f,	1.0f, 1.0f,
+		0.5f, 0.5f, 0.5f,		0.0f, 1.0f, 0.0f,	1.0f, 0.0f,
+
+		//donja
+		-0.5f, -0.5f, 0.5f,		0.0f, -1.0f, 0.0f,	0.0f, 0.0f,
+		-0.5f, -0.5f, -0.5f,	0.0f, -1.0f, 0.0f,	0.0f, 1.0f,
+		0.5f, -0.5f, -0.5f,		0.0f, -1.0f, 0.0f,	1.0f, 1.0f,
+		0.5f, -0.5f, 0.5f,		0.0f, -1.0f, 0.0f,	1.0f, 0.0f,
+
+		//leva
+		-0.5f, -0.5f, -0.5f,	-1.0f, 0.0f, 0.0f,	0.0f, 0.0f,
+		-0.5f, 0.5f, -0.5f, 	-1.0f, 0.0f, 0.0f,	0.0f, 1.0f,
+		-0.5f, 0.5f, 0.5f,		-1.0f, 0.0f, 0.0f,	1.0f, 1.0f,
+		-0.5f, -0.5f, 0.5f,		-1.0f, 0.0f, 0.0f,	1.0f, 0.0f,
+
+		//desno
+		0.5f, -0.5f, -0.5f,		1.0f, 0.0f, 0.0f,	0.0f, 0.0f,
+		0.5f, 0.5f, -0.5f, 		1.0f, 0.0f, 0.0f,	0.0f, 1.0f,
+		0.5f, 0.5f, 0.5f,		1.0f, 0.0f, 0.0f,	1.0f, 1.0f,
+		0.5f, -0.5f, 0.5f,		1.0f, 0.0f, 0.0f,	1.0f, 0.0f
+	};
+
+	// 24 verteksa, 16-bit indeksi su dovoljni
+	GLushort kockaRedosled[] = {
+		//prednja
+		0, 1, 2,
+		0, 2, 3,
+		//zadnja
+		4, 5, 6,
+		4, 6, 7,
+		//gornja
+		8, 9, 10,
+		8, 10, 11,
+		//donja
+		12, 13, 14,
+		12, 14, 15,
+		//leva
+		16, 17, 18,
+		16, 18, 19,
+		//desna
+		20, 21, 22,
+		20, 22, 23
+	};
+
+	glGenVertexArrays(1, &kockaVAO);
+	glBindVertexArray(kockaVAO);
+	glGenBuffers(1, &kockaVBO);
+	glGenBuffers(1, &kockaEBO);
+	glBindBuffer(GL_ARRAY_BUFFER, kockaVBO);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(kockaTacke), kockaTacke, GL_STATIC_DRAW);
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
+	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
+	glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
+	glEnableVertexAttribArray(0);
+	glEnableVertexAttribArray(1);
+	glEnableVertexAttribArray(2);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, kockaEBO);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(kockaRedosled), kockaRedosled, GL_STATIC_DRAW);
+
+	glBindVertexArray(0);
+
+	setupInstanceBatch(helixCubes, true);
+	setupInstanceBatch(helixBeams, false);
+	setupInstanceBatch(lightMarkers, false);
+	setupInstanceBatch(modelLight, false);
+
+	lightMarkers.models.reserve(NEON_LIGHTS);
+	lightMarkers.data.reserve(NEON_LIGHTS);
+
+	setupHelix();
+}
+
+void Scene::setupHelix() {
+	float radius = 6.0f;
+	float distanceBetweenSquares = 2 * radius;
+
+	helixRotationAxes.clear();
+	for (int i = 0; i < HELIX_LEVELS; i++) {
+		float sign = (i % 2) ? -1.0f : 1.0f;
+		helixRotationAxes.push_back(glm::normalize(glm::vec3(sign * i * 1.3f, 0.6f, -1.0f * sign * i * i * 0.3f)));
+	}
+
+	// dve kocke po nivou; sloj u dnkDiffuse: 0 = zelena, 1 = crvena
+	helixCubeTransforms.resize(2 * HELIX_LEVELS);
+	helixCubes.models.resize(2 * HELIX_LEVELS);
+	helixCubes.normalMatrices.resize(2 * HELIX_LEVELS);
+	helixViewModels.resize(2 * HELIX_LEVELS);
+	helixCubes.data.clear();
+	for (int i = 0; i < HELIX_LEVELS; i++) {
+		glm::vec4 diffuseIndex = glm::vec4((float)(i % 2), 0.0f, 0.0f, 0.0f);
+		helixCubes.data.push_back(diffuseIndex);
+		helixCubes.data.push_back(diffuseIndex);
+	}
+
+	// bela greda na svakom trecem nivou
+	int beamCount = (HELIX_LEVELS + 2) / 3;
+	helixBeamTransforms.resize(beamCount);
+	helixBeams.models.resize(beamCount);
+	helixBeams.data.assign(beamCount, glm::vec4(1.0f));
+	for (int beam = 0; beam < beamCount; beam++) {
+		helixBeamTransforms.set(beam, glm::vec3(0.0f, -30.0f + 1.25f * (beam * 3), 0.0f), glm::quat(1.0f, 0.0f, 0.0f, 0.0f), glm::vec3(distanceBetweenSquares, 0.5f, 0.5f));
+	}
+}
+
+void Scene::setupInstanceBatch(InstanceBatch& batch, bool withSurface) {
+	batch.withSurface = withSurface;
+
+	glGenVertexArrays(1, &batch.VAO);
+	glBindVertexArray(batch.VAO);
+
+	glBindBuffer(GL_ARRAY_BUFFER, kockaVBO);
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
+	glEnableVertexAttribArray(0);
+	if (withSurface) {
+		glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
+		glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
+		glEnableVertexAttribArray(1);
+		glEnableVertexAttribArray(2);
+	}
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, kockaEBO);
+
+	glGenBuffers(1, &batch.instanceVBO);
+
+	glBindVertexArray(0);
+}
+
+void Scene::setInstanceAttributes(InstanceBatch& batch) {
+	glBindVertexArray(batch.VAO);
+	glBindBuffer(GL_ARRAY_BUFFER, batch.instanceVBO);
+
+	size_t dataOffset = batch.capacity * sizeof(glm::mat4);
+	size_t normalOffset = dataOffset + batch.capacity * sizeof(glm::vec4);
+
+	// mat4 atribut zauzima cetiri uzastopne lokacije (3-6), svaka po jedna kolona
+	for (int column = 0; column < 4; column++) {
+		glVertexAttribPointer(3 + column, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (void*)(column * sizeof(glm::vec4)));
+		glEnableVertexAttribArray(3 + column);
+		glVertexAttribDivisor(3 + column, 1);
+	}
+	glVertexAttribPointer(7, 4, GL_FLOAT, GL_FALSE, sizeof(glm::vec4), (void*)dataOffset);
+	glEnableVertexAttribArray(7);
+	glVertexAttribDivisor(7, 1);
+
+	// mat3 normal matrica na lokacijama 8-10
+	if (batch.withSurface) {
+		for (int column = 0; column < 3; column++) {
+			glVertexAttribPointer(8 + column, 3, GL_FLOAT, GL_FALSE, sizeof(glm::mat3), (void*)(normalOffset + column * sizeof(glm::vec3)));
+			glEnableVertexAttribArray(8 + column);
+			glVertexAttribDivisor(8 + column, 1);
+		}
+	}
+
+	glBindVertexArray(0);
+}
+
+void Scene::drawInstanceBatch(RenderQueue& queue, InstanceBatch& batch, Shader& shader, uint textureSet) {
+	size_t count = batch.models.size();
+	if (count == 0) return;
+
+	if (count > batch.capacity) {
+		// raste duplo, da veci broj instanci ne realocira buffer svaki frame
+		batch.capacity = std::max(count, 2 * batch.capacity);
+		setInstanceAttributes(batch);
+	}
+
+	size_t modelsSize = batch.capacity * sizeof(glm::mat4);
+	size_t dataSize = batch.capacity * sizeof(glm::vec4);
+	size_t normalsSize = batch.withSurface ? batch.capacity * sizeof(glm::mat3) : 0;
+
+	glBindBuffer(GL_ARRAY_BUFFER, batch.instanceVBO);
+	// orphaning: novi storage iste velicine, driver ne ceka da GPU zavrsi sa prethodnim frame-om
+	glBufferData(GL_ARRAY_BUFFER, modelsSize + dataSize + normalsSize, NULL, GL_STREAM_DRAW);
+	glBufferSubData(GL_ARRAY_BUFFER, 0, count * sizeof(glm::mat4), batch.models.data());
+	glBufferSubData(GL_ARRAY_BUFFER, modelsSize, count * sizeof(glm::vec4), batch.data.data());
+	if (batch.withSurface) {
+		glBufferSubData(GL_ARRAY_BUFFER, modelsSize + dataSize, count * sizeof(glm::mat3), batch.normalMatrices.data());
+	}
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	DrawCommand command;
+	command.shader = &shader;
+	command.VAO = batch.VAO;
+	command.indexCount = 36;
+	command.indexType = GL_UNSIGNED_SHORT;
+	command.instanceCount = (uint)count;
+	command.textureSet = textureSet;
+	queue.add(command);
+}
+
+Scene::LightingUniforms Scene::resolveLightingUniforms(const Shader& shader) {
+	LightingUniforms u;
+
+	u.model = shader.uniform("model"_uniform);
+	u.view = shader.uniform("view"_uniform);
+	u.projection = shader.uniform("projection"_uniform);
+
+	return u;
+}
+
+void Scene::createPrograms(ScenePrograms& programs, bool gbufferPass) {
+	std::string defines = gbufferPass ? "#define GBUFFER\n" : "";
+
+	programs.cubeShader = new Shader("shaders/lighting.vs", "shaders/lighting.fs", defines + "#define INSTANCED\n");
+	programs.map2CubeShader = new Shader("shaders/lighting.vs", "shaders/lightingNoPoints.fs",
+		defines + "#define MATERIAL_LAYERS\n" + (MODEL_VERTEX_FORMAT == VertexFormat::Packed ? "#define PACKED_VERTICES\n" : ""));
+	programs.lightsourceInstancedShader = new Shader("shaders/lightsource.vs", "shaders/lightsource.fs", defines + "#define INSTANCED\n");
+
+	programs.cubeUniforms = resolveLightingUniforms(*programs.cubeShader);
+	programs.map2CubeUniforms = resolveLightingUniforms(*programs.map2CubeShader);
+	programs.lightsourceInstancedUniforms = resolveLightingUniforms(*programs.lightsourceInstancedShader);
+
+	if (!gbufferPass) {
+		lights->attach(*programs.cubeShader);
+		lights->attach(*programs.map2CubeShader);
+	}
+
+	programs.cubeShader->use();
+	programs.cubeShader->setInt("material.texture_diffuse1", 0);
+	programs.cubeShader->setInt("material.texture_specular1", 1);
+	programs.cubeShader->setFloat("material.shininess", 32.0f);
+
+	// teksture modela su na fiksnim unit-ima materijala
+	Material::bindSamplers(*programs.map2CubeShader);
+	programs.map2CubeShader->setFloat("material.shininess", 32.0f);
+}
+
+void Scene::deletePrograms(ScenePrograms& programs) {
+	delete programs.cubeShader;
+	delete programs.map2CubeShader;
+	delete programs.lightsourceInstancedShader;
+	programs = ScenePrograms();
+}
+
+// point light sa zajednickim slabljenjem (1, 0.09, 0.032) i belim odsjajem
+static PointLightData makePointLight(const glm::vec3& viewPosition, const glm::vec3& ambient, const glm::vec3& diffuse) {
+	PointLightData light = {};
+	light.position = viewPosition;
+	light.ambient = ambient;
+	light.diffuse = diffuse;
+	light.specular = glm::vec3(1.0f, 1.0f, 1.0f);
+	light.constant = 1.0f;
+	light.linear = 0.09f;
+	light.quadratic = 0.032f;
+	return light;
+}
+
+void Scene::setSharedLights(bool flashlightOn) {
+	// directional light
+	DirectionLightData directionLight = {};
+	directionLight.direction = glm::vec3(-0.2f, -1.0f, -0.3f);
+	directionLight.ambient = glm::vec3(0.05f, 0.05f, 0.05f);
+	directionLight.diffuse = glm::vec3(0.4f, 0.4f, 0.4f);
+	directionLight.specular = glm::vec3(0.5f, 0.5f, 0.5f);
+	lights->setDirectionLight(directionLight);
+
+	// spotLight
+	SpotLightData spotLight = {};
+	spotLight.position = glm::vec3(0.0f, 0.0f, 0.0f);
+	spotLight.direction = glm::vec3(0.0f, 0.0f, -1.0f);
+	spotLight.ambient = glm::vec3(0.0f, 0.0f, 0.0f);
+	spotLight.diffuse = glm::vec3(1.0f, 1.0f, 1.0f);
+	spotLight.specular = glm::vec3(1.0f, 1.0f, 1.0f);
+	spotLight.constant = 1.0f;
+	spotLight.linear = 0.09f;
+	spotLight.quadratic = 0.032f;
+	spotLight.innerCosAngle = glm::cos(glm::radians(12.5f));
+	spotLight.outerCosAngle = glm::cos(glm::radians(15.0f));
+	spotLight.on = flashlightOn ? 1 : 0;
+	lights->setSpotLight(spotLight);
+}
+
+void Scene::setHelixLightCount(int count) {
+	count = std::min(std::max(count, NEON_LIGHTS), LightBuffer::MAX_POINT_LIGHTS);
+
+	// uvek isti raspored za isti broj svetala
+	std::mt19937 random(2024);
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+	fireflies.resize(count - NEON_LIGHTS);
+	for (Firefly& firefly : fireflies) {
+		firefly.radius = 3.0f + 17.0f * unit(random);
+		firefly.height = -35.0f + 60.0f * unit(random);
+		firefly.speed = (unit(random) < 0.5f ? -1.0f : 1.0f) * (0.2f + 0.8f * unit(random));
+		firefly.phase = glm::two_pi<float>() * unit(random);
+		firefly.color = glm::vec3(0.2f) + 0.8f * glm::vec3(unit(random), unit(random), unit(random));
+	}
+
+	lightMarkers.models.reserve(count);
+	lightMarkers.data.reserve(count);
+}
+
+bool Scene::isMapReady(int map) const {
+	if (map == 2) return torusConeModel->isLoaded();
+	if (map == 3) return backpackModel->isLoaded();
+	return true;
+}
+
+bool Scene::isLoaded() const {
+	return torusConeModel->isLoaded() && backpackModel->isLoaded();
+}
+
+void Scene::draw(int map, const Camera& camera, float time, int width, int height, bool flashlightOn, bool debugView) {
+
+	// izbacivanje i vracanje tekstura po tome sta je crtano u prethodnom frame-u
+	TextureCache::getInstance().update();
+
+	// deo posla na modelima koji se jos ucitavaju, bez obzira na to koja se mapa crta
+	torusConeModel->streamIn(MODEL_UPLOAD_BUDGET_MS);
+	backpackModel->streamIn(MODEL_UPLOAD_BUDGET_MS);
+
+	bool deferred = activePath == RenderPath::Deferred;
+	if (deferred && !gbuffer) {
+		createPrograms(deferredPrograms, true);
+		gbuffer = new GBuffer(*lights);
+	}
+	const ScenePrograms& programs = deferred ? deferredPrograms : forwardPrograms;
+
+	glm::mat4 viewMatrix = camera.buildViewMatrix();
+	glm::mat4 projectionMatrix = glm::perspective(glm::radians(camera.fov), (float)width / (float)height, NEAR_PLANE, FAR_PLANE);
+	lights->setProjection(projectionMatrix, NEAR_PLANE, FAR_PLANE, width, height);
+
+	// projection[1][1] = 1 / tan(fov / 2): visina ekrana na udaljenosti 1 je 2 / projection[1][1] jedinica.
+	// Zoom (manji fov) zato trazi finiji LOD.
+	float lodScale = 0.5f * (float)height * projectionMatrix[1][1] / LOD_PIXEL_ERROR;
+
+	// SWITCHING BETWEEN MAPS
+
+	if (map == 1) {
+		drawHelixMap(programs, viewMatrix, projectionMatrix, time, flashlightOn, debugView);
+	}
+	else if (map == 2) {
+		drawModelMap(programs, *torusConeModel, viewMatrix, projectionMatrix, lodScale, time, flashlightOn);
+	}
+	else if (map == 3) {
+		drawModelMap(programs, *backpackModel, viewMatrix, projectionMatrix, lodScale, time, flashlightOn);
+	}
+
+	// sve sto su mape snimile, sortirano po stanju; u deferred putu u G-buffer, pa svetla preko celog ekrana
+	if (deferred) {
+		gbuffer->begin(width, height);
+		RenderQueue::getInstance().submit();
+		gbuffer->resolve(projectionMatrix);
+	}
+	else {
+		RenderQueue::getInstance().submit();
+	}
+}
+
+void Scene::drawHelixMap(const ScenePrograms& programs, const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix, float vreme, bool flashlightOn, bool debugView) {
+
+	lightMarkers.models.clear();
+	lightMarkers.data.clear();
+
+	// CRTANJE I DEFINISANJE "NEONKI"
+
+	float distanceFactor = 0.25f;
+	int counter = 0;
+	int heights[] = {
+		0, 3, 6, 9, 12, 15, 18, 21, 24, 27, 30, 33, 36, 39
+	};
+
+	lights->setPointLightCount(NEON_LIGHTS + (int)fireflies.size());
+
+	for (int i = 0; i < NEON_LIGHTS; i += 2) {
+		counter = i / 2;
+
+		glm::vec3 lokacija1 = glm::vec3(4.0f * sin(vreme + (heights[counter] * distanceFactor)), -30.0f + 1.25f * heights[counter], 4.0f * cos(vreme + (heights[counter] * distanceFactor)));
+		glm::vec3 lokacija2 = glm::vec3(-4.0f * sin(vreme + (heights[counter] * distanceFactor)), -30.0f + 1.25f * heights[counter], -4.0f * cos(vreme + (heights[counter] * distanceFactor)));
+
+
+		lights->setPointLight(i, makePointLight(glm::vec3(viewMatrix * glm::vec4(lokacija1, 1.0f)), glm::vec3(0.05f, 0.0f, 0.0f), glm::vec3(0.8f, 0.0f, 0.0f)));
+		lights->setPointLight(i + 1, makePointLight(glm::vec3(viewMatrix * glm::vec4(lokacija2, 1.0f)), glm::vec3(0.0f, 0.05f, 0.0f), glm::vec3(0.0f, 0.8f, 0.0f)));
+
+
+		// "NEONKE" kao kocke. Opcioni korak
+
+		if (debugView) {
+			lightMarkers.models.push_back(glm::translate(glm::mat4(1.0f), lokacija1));
+			lightMarkers.data.push_back(glm::vec4(1.0f, 0.0f, 0.0f, 0.0f));
+			lightMarkers.models.push_back(glm::translate(glm::mat4(1.0f), lokacija2));
+			lightMarkers.data.push_back(glm::vec4(0.0f, 1.0f, 0.0f, 0.0f));
+		}
+	}
+
+	// SVICI - kratak domet, pa svaki osvetljava samo par klastera oko sebe
+
+	for (size_t f = 0; f < fireflies.size(); f++) {
+		const Firefly& firefly = fireflies[f];
+		float angle = firefly.phase + vreme * firefly.speed;
+		glm::vec3 position = glm::vec3(firefly.radius * sin(angle), firefly.height + 0.5f * sin(2.0f * angle), firefly.radius * cos(angle));
+
+		PointLightData light = {};
+		light.position = glm::vec3(viewMatrix * glm::vec4(position, 1.0f));
+		light.diffuse = 2.0f * firefly.color;
+		light.specular = firefly.color;
+		light.constant = 1.0f;
+		light.linear = 2.0f;
+		light.quadratic = 20.0f;
+		lights->setPointLight(NEON_LIGHTS + (int)f, light);
+
+		if (debugView) {
+			lightMarkers.models.push_back(glm::scale(glm::translate(glm::mat4(1.0f), position), glm::vec3(0.15f)));
+			lightMarkers.data.push_back(glm::vec4(firefly.color, 0.0f));
+		}
+	}
+
+	// KOCKE I GREDE HELIXA - samo pozicije i rotacije se menjaju, matrice racunaju TransformKernels
+
+	float radius = 6.0f;
+
+	for (int i = 0; i < HELIX_LEVELS; i++) {
+		glm::quat rotation = glm::angleAxis(glm::radians(i * vreme * 2.8f), helixRotationAxes[i]);
+
+		glm::vec3 position1 = glm::vec3(radius * sin(vreme + (i * distanceFactor)), -30.0f + 1.25f * i, radius * cos(vreme + (i * distanceFactor)));
+		glm::vec3 position2 = glm::vec3(-radius * sin(vreme + (i * distanceFactor)), -30.0f + 1.25f * i, -radius * cos(vreme + (i * distanceFactor)));
+
+		helixCubeTransforms.setPosition(2 * i, position1);
+		helixCubeTransforms.setRotation(2 * i, rotation);
+		helixCubeTransforms.setPosition(2 * i + 1, position2);
+		helixCubeTransforms.setRotation(2 * i + 1, rotation);
+
+		if (i % 3 == 0) {
+			helixBeamTransforms.setRotation(i / 3, glm::angleAxis(vreme + (i * distanceFactor) + glm::pi<float>() / 2, glm::vec3(0.0f, 1.0f, 0.0f)));
+		}
+	}
+
+	size_t cubeCount = helixCubeTransforms.size();
+	TransformKernels::composeTRS(helixCubeTransforms, helixCubes.models.data());
+	TransformKernels::multiply(viewMatrix, helixCubes.models.data(), helixViewModels.data(), cubeCount);
+	TransformKernels::normalMatrices(helixViewModels.data(), helixCubes.normalMatrices.data(), cubeCount);
+
+	TransformKernels::composeTRS(helixBeamTransforms, helixBeams.models.data());
+
+	// uniformi za ceo frame, jednom po programu
+	programs.lightsourceInstancedShader->use();
+	programs.lightsourceInstancedShader->setMat4(programs.lightsourceInstancedUniforms.view, viewMatrix);
+	programs.lightsourceInstancedShader->setMat4(programs.lightsourceInstancedUniforms.projection, projectionMatrix);
+
+	programs.cubeShader->use();
+	programs.cubeShader->setMat4(programs.cubeUniforms.view, viewMatrix);
+	programs.cubeShader->setMat4(programs.cubeUniforms.projection, projectionMatrix);
+
+	// sva svetla mape jednim glBufferSubData
+	setSharedLights(flashlightOn);
+	lights->upload();
+
+	// markeri svetala, kocke, grede - po jedan draw call, redosled odredjuje RenderQueue
+	RenderQueue& queue = RenderQueue::getInstance();
+	drawInstanceBatch(queue, lightMarkers, *programs.lightsourceInstancedShader, 0);
+	drawInstanceBatch(queue, helixCubes, *programs.cubeShader, helixTextureSet);
+	drawInstanceBatch(queue, helixBeams, *programs.lightsourceInstancedShader, 0);
+}
+
+void Scene::drawModelMap(const ScenePrograms& programs, Model& model, const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix, float lodScale, float vreme, bool flashlightOn) {
+
+	// CRTANJE KRUZNOG IZVORA SVETLA
+	float radius = 5.0f;
+	glm::vec3 lightcubePos = glm::vec3(radius * sin(vreme), 0.0f, radius * cos(vreme)) + glm::vec3(-1.0f, 2.0f, 2.0f);
+
+	glm::vec3 lightColor = glm::vec3(1.0f);
+	lightColor.x = sin(vreme);
+	lightColor.y = sin(vreme + glm::pi<float>() * 4 / 3);
+	lightColor.z = sin(vreme + glm::pi<float>() * 2 / 3);
+
+	glm::mat4 modelMatrix = glm::translate(glm::mat4(1.0f), lightcubePos);
+	modelMatrix = glm::scale(modelMatrix, glm::vec3(0.5f, 0.5f, 0.5f));
+
+	modelLight.models.assign(1, modelMatrix);
+	modelLight.data.assign(1, glm::vec4(lightColor, 0.0f));
+
+	programs.lightsourceInstancedShader->use();
+	programs.lightsourceInstancedShader->setMat4(programs.lightsourceInstancedUniforms.view, viewMatrix);
+	programs.lightsourceInstancedShader->setMat4(programs.lightsourceInstancedUniforms.projection, projectionMatrix);
+
+	RenderQueue& queue = RenderQueue::getInstance();
+	drawInstanceBatch(queue, modelLight, *programs.lightsourceInstancedShader, 0);
+
+	programs.map2CubeShader->use();
+	// point light kruzni
+	lights->setPointLightCount(1);
+	lights->setPointLight(0, makePointLight(glm::vec3(viewMatrix * glm::vec4(lightcubePos, 1.0f)), glm::vec3(0.05f, 0.05f, 0.05f), lightColor));
+	setSharedLights(flashlightOn);
+	lights->upload();
+
+	modelMatrix = glm::translate(glm::mat4(1.0f), glm::vec3(-10.0f, 2.0f, 8.0f));
+	programs.map2CubeShader->setMat4(programs.map2CubeUniforms.model, modelMatrix);
+	programs.map2CubeShader->setMat4(programs.map2CubeUniforms.view, viewMatrix);
+	programs.map2CubeShader->setMat4(programs.map2CubeUniforms.projection, projectionMatrix);
+	model.draw(queue, *programs.map2CubeShader, projectionMatrix * viewMatrix, lodScale);
+}
@@ -0,0 +1,177 @@
+#ifndef _MOJA_SCENA_H_
+#define _MOJA_SCENA_H_
+
+#include "glad/glad.h"
+#include "glm/glm.hpp"
+
+#include "Shader.h"
+#include "Camera.h"
+#include "GBuffer.h"
+#include "LightBuffer.h"
+#include "Model.h"
+#include "RenderQueue.h"
+#include "TransformKernels.h"
+
+// Forward: lighting shaderi racunaju svetla za svaki fragment koji crtaju, i onaj koji se posle prepise.
+// Deferred: mape se crtaju u G-buffer, a svetla se racunaju jednom po pikselu (GBuffer).
+enum class RenderPath { Forward, Deferred };
+
+// Sve tri mape (helix, torus/cone, backpack) i resursi koje koriste.
+// Zajednicka je za prozor (main.cpp) i headless benchmark (bench.cpp).
+// Konstruktor zahteva aktivan OpenGL kontekst.
+class Scene {
+	typedef unsigned int uint;
+public:
+
+	Scene();
+
+	~Scene();
+
+	// draws the selected map (1, 2 or 3) as seen from the camera
+	// time is in seconds, it drives every animation in the scene
+	// width/height: velicina viewport-a u pikselima, za aspect ratio i izbor LOD-a
+	void draw(int map, const Camera& camera, float time, int width, int height, bool flashlightOn, bool debugView);
+
+	// Modeli se ucitavaju u pozadini; draw() svaki frame nastavlja njihov upload.
+	// map 1 is always ready, maps 2 and 3 once their model finished loading
+	bool isMapReady(int map) const;
+
+	// all models finished loading (successfully or not)
+	bool isLoaded() const;
+
+	// Ukupno point svetala na mapi 1: 28 neonki oko helixa i ostatak malih svetala ("svitaca")
+	// rasutih oko njega. Svetla su u klasterima pogleda, pa hiljade svetala ne kosta svaki piksel.
+	void setHelixLightCount(int count);
+
+	// Moze da se menja izmedju frame-ova, za A/B poredjenje. Shaderi i G-buffer deferred puta se
+	// prave kad se prvi put crta njime.
+	void setRenderPath(RenderPath path) { activePath = path; }
+
+	RenderPath renderPath() const { return activePath; }
+
+private:
+
+	uint kockaVAO, kockaVBO, kockaEBO;
+
+	// daleka ravan projekcije, i granica dubine u kljucevima RenderQueue-a
+	static constexpr float NEAR_PLANE = 0.1f;
+	static constexpr float FAR_PLANE = 100.0f;
+
+	// koliko piksela sme da odstupi LOD modela od punog mesh-a
+	static constexpr float LOD_PIXEL_ERROR = 1.0f;
+
+	// Instance jednog batch-a, crtaju se jednim glDrawElementsInstanced. VAO deli kockaVBO/kockaEBO.
+	// Jedan niz po atributu, da TransformKernels pisu direktno u njih; u instance VBO-u su
+	// jedan za drugim. VBO raste po potrebi i ne smanjuje se.
+	struct InstanceBatch {
+		uint VAO = 0;
+		uint instanceVBO = 0;
+		size_t capacity = 0;
+		bool withSurface = false;
+
+		std::vector<glm::mat4> models;
+
+		// kocke helixa: x = indeks difuzne teksture, svetla: rgb = boja
+		std::vector<glm::vec4> data;
+
+		// view-space normal matrice, samo batch-evi sa osvetljenjem (withSurface)
+		std::vector<glm::mat3> normalMatrices;
+	};
+
+	// modelLight je jedna instanca, kruzni izvor svetla na mapama 2 i 3
+	InstanceBatch helixCubes, helixBeams, lightMarkers, modelLight;
+
+	// broj nivoa helixa, po dve kocke na svakom
+	static constexpr int HELIX_LEVELS = 40;
+
+	// point svetla 0-27 na mapi 1, kruze sa helixom
+	static constexpr int NEON_LIGHTS = 28;
+
+	// malo svetlo na mapi 1, kruzi oko ose helixa na svojoj visini i udaljenosti
+	struct Firefly {
+		float radius, height, speed, phase;
+		glm::vec3 color;
+	};
+
+	// point svetla posle neonki
+	std::vector<Firefly> fireflies;
+
+	// Transformacije helixa. Ose rotacije i skale se ne menjaju, racunaju se jednom u setupHelix().
+	std::vector<glm::vec3> helixRotationAxes;
+	TransformSoA helixCubeTransforms, helixBeamTransforms;
+	std::vector<glm::mat4> helixViewModels;
+
+	// iz TextureCache-a; modeli koji koriste iste slike dobijaju iste teksture
+	// dnkDiffuse je niz: zelena i crvena difuzna tekstura helixa
+	TextureHandle boxDiffuse, dnkDiffuse, dnkSpec;
+
+	// dnkDiffuse (niz) i dnkSpec na unit-ima 0 i 1
+	uint helixTextureSet;
+
+	// Lokacije uniforma, razresene jednom u konstruktoru umesto po imenu svaki frame.
+	// Svetla nisu ovde, ona su u LightBuffer-u.
+	struct LightingUniforms {
+		Uniform model, view, projection;
+	};
+
+	// Programi mapa za jedan RenderPath; deferred ima GBUFFER varijante istih shadera.
+	// cubeShader i lightsourceInstancedShader su INSTANCED varijante, za batch-eve instanci.
+	struct ScenePrograms {
+		Shader* cubeShader = nullptr;
+		Shader* map2CubeShader = nullptr;
+		Shader* lightsourceInstancedShader = nullptr;
+
+		LightingUniforms cubeUniforms, map2CubeUniforms, lightsourceInstancedUniforms;
+	};
+
+	ScenePrograms forwardPrograms, deferredPrograms;
+
+	RenderPath activePath = RenderPath::Forward;
+
+	// nullptr dok se deferred put ne upotrebi
+	GBuffer* gbuffer = nullptr;
+
+	// directional, spot i point svetla obe mape, deljena izmedju lighting shadera
+	LightBuffer* lights;
+
+	static LightingUniforms resolveLightingUniforms(const Shader& shader);
+
+	// gbufferPass: GBUFFER varijante, koje ne citaju svetla
+	void createPrograms(ScenePrograms& programs, bool gbufferPass);
+
+	static void deletePrograms(ScenePrograms& programs);
+
+	// directional light and flashlight, the same on every map
+	void setSharedLights(bool flashlightOn);
+
+	Model* torusConeModel;
+	Model* backpackModel;
+
+	// verteksi modela mapa 2 i 3; map2CubeShader-i se kompajliraju za isti format
+	static constexpr VertexFormat MODEL_VERTEX_FORMAT = VertexFormat::Packed;
+
+	// koliko milisekundi po frame-u sme da ode na pravljenje GL objekata modela u ucitavanju
+	static constexpr double MODEL_UPLOAD_BUDGET_MS = 2.0;
+
+	// DNK helix model with flashing lights circling
+	void drawHelixMap(const ScenePrograms& programs, const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix, float vreme, bool flashlightOn, bool debugView);
+
+	// model sa kruznim izvorom svetla (mape 2 i 3)
+	void drawModelMap(const ScenePrograms& programs, Model& model, const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix, float lodScale, float vreme, bool flashlightOn);
+
+	void setupCube();
+
+	void setupHelix();
+
+	// withSurface: pored pozicije koristi i normale i tex. koordinate (lighting shader)
+	void setupInstanceBatch(InstanceBatch& batch, bool withSurface);
+
+	// instance atributi pokazuju na delove VBO-a, pa se postavljaju ponovo kad VBO naraste
+	void setInstanceAttributes(InstanceBatch& batch);
+
+	// salje instance batch-a na GPU i dodaje ih u queue, jedan draw call
+	void drawInstanceBatch(RenderQueue& queue, InstanceBatch& batch, Shader& shader, uint textureSet);
+
+};
+
+#endif
@@ -0,0 +1,183 @@
+#include "SceneGraph.h"
+#include "RenderStats.h"
+#include "TransformKernels.h"
+
+#include <algorithm>
+#include <cmath>
+
+void SceneGraph::build(const std::vector<NodeData>& nodes) {
+	size_t count = nodes.size();
+
+	parents.resize(count);
+	localTransforms.resize(count);
+	worldTransforms.resize(count);
+	subtreeEnds.assign(count, 0);
+	meshRanges.resize(count);
+	names.resize(count);
+	subtreeBounds.assign(count, AABB());
+	meshIndices.clear();
+
+	for (size_t i = 0; i < count; i++) {
+		const NodeData& node = nodes[i];
+
+		parents[i] = node.parent;
+		localTransforms[i] = node.localTransform;
+		names[i] = node.name;
+
+		meshRanges[i].first = static_cast<uint>(meshIndices.size());
+		meshRanges[i].count = static_cast<uint>(node.meshIndices.size());
+		meshIndices.insert(meshIndices.end(), node.meshIndices.begin(), node.meshIndices.end());
+	}
+	meshBounds.assign(meshIndices.size(), AABB());
+
+	// unazad, dete je posle roditelja pa je njegov kraj vec poznat
+	for (size_t i = count; i-- > 0;) {
+		subtreeEnds[i] = std::max<uint>(subtreeEnds[i], static_cast<uint>(i + 1));
+		if (parents[i] >= 0) {
+			subtreeEnds[parents[i]] = std::max(subtreeEnds[parents[i]], subtreeEnds[i]);
+		}
+	}
+
+	// na pocetku su sve world matrice promenjene
+	dirtyFlags.assign(count, 0);
+	dirtyNodes.clear();
+	TransformKernels::multiplyHierarchy(parents.data(), localTransforms.data(), worldTransforms.data(), count);
+	changed.clear();
+	if (count > 0) {
+		changed.push_back({ 0, static_cast<uint>(count) });
+	}
+}
+
+int SceneGraph::findNode(const std::string& name) const {
+	for (size_t i = 0; i < names.size(); i++) {
+		if (names[i] == name) return static_cast<int>(i);
+	}
+	return -1;
+}
+
+void SceneGraph::setLocalTransform(uint node, const glm::mat4& localTransform) {
+	if (node >= size()) return;
+
+	localTransforms[node] = localTransform;
+	if (!dirtyFlags[node]) {
+		dirtyFlags[node] = 1;
+		dirtyNodes.push_back(node);
+	}
+}
+
+void SceneGraph::updateWorldTransforms() {
+	changed.clear();
+	if (dirtyNodes.empty()) return;
+
+	// Sortirano po indeksu: podstablo prvog cvora pokriva sve promenjene potomke,
+	// pa se oni preskacu. Roditelj opsega je pre njega i vec je ispravan.
+	std::sort(dirtyNodes.begin(), dirtyNodes.end());
+
+	uint coveredEnd = 0;
+	for (uint node : dirtyNodes) {
+		dirtyFlags[node] = 0;
+		if (node < coveredEnd) continue;
+
+		coveredEnd = subtreeEnds[node];
+		changed.push_back({ node, coveredEnd - node });
+		TransformKernels::multiplyHierarchy(parents.data(), localTransforms.data(), worldTransforms.data(), node, coveredEnd - node);
+	}
+	dirtyNodes.clear();
+}
+
+void SceneGraph::updateBounds(const std::vector<Mesh>& meshes) {
+	for (const NodeRange& range : changed) {
+		uint end = range.first + range.count;
+
+		for (uint i = range.first; i < end; i++) {
+			const MeshRange& meshRange = meshRanges[i];
+			for (uint k = meshRange.first; k < meshRange.first + meshRange.count; k++) {
+				meshBounds[k] = meshes[meshIndices[k]].bounds.transformed(worldTransforms[i]);
+			}
+		}
+
+		// unazad, deca su posle roditelja pa su njihove kutije vec gotove
+		for (uint i = end; i-- > range.first;) {
+			refitSubtree(i);
+		}
+
+		// preci opsega, do korena
+		for (int parent = parents[range.first]; parent >= 0; parent = parents[parent]) {
+			refitSubtree(parent);
+		}
+	}
+}
+
+void SceneGraph::refitSubtree(uint node) {
+	AABB box;
+
+	const MeshRange& meshRange = meshRanges[node];
+	for (uint k = meshRange.first; k < meshRange.first + meshRange.count; k++) {
+		box.expand(meshBounds[k]);
+	}
+
+	// direktna deca: posle deteta sledece pocinje tamo gde se njegovo podstablo zavrsava
+	for (uint child = node + 1; child < subtreeEnds[node]; child = subtreeEnds[child]) {
+		box.expand(subtreeBounds[child]);
+	}
+
+	subtreeBounds[node] = box;
+}
+
+void SceneGraph::draw(RenderQueue& queue, Shader& shader, const std::vector<Mesh>& meshes, const glm::mat4& viewProjection, float lodScale) const {
+	RenderStats& stats = RenderStats::getInstance();
+	Frustum frustum(viewProjection);
+	MeshUniforms uniforms = MeshUniforms::resolve(shader);
+	glm::vec4 depthRow(viewProjection[0][3], viewProjection[1][3], viewProjection[2][3], viewProjection[3][3]);
+
+	size_t i = 0;
+	while (i < size()) {
+		uint end = subtreeEnds[i];
+
+		if (!frustum.intersects(subtreeBounds[i])) {
+			// mesh-evi podstabla su uzastopni u meshIndices
+			const MeshRange& last = meshRanges[end - 1];
+			stats.meshesCulled += last.first + last.count - meshRanges[i].first;
+			i = end;
+			continue;
+		}
+
+		const MeshRange& range = meshRanges[i];
+
+		// greska LOD-a je u jedinicama mesh-a; najveca skala cvora je gornja granica u svetu
+		const glm::mat4& world = worldTransforms[i];
+		float worldScale = std::sqrt(std::max(glm::dot(glm::vec3(world[0]), glm::vec3(world[0])),
+			std::max(glm::dot(glm::vec3(world[1]), glm::vec3(world[1])), glm::dot(glm::vec3(world[2]), glm::vec3(world[2])))));
+
+		for (uint k = range.first; k < range.first + range.count; k++) {
+			const AABB& box = meshBounds[k];
+			if (frustum.intersects(box)) {
+				// clip w centra kutije je njena udaljenost duz pogleda
+				float depth = glm::dot(depthRow, glm::vec4((box.min + box.max) * 0.5f, 1.0f));
+
+				// najbliza tacka kutije odredjuje LOD; kamera u kutiji dobija pun mesh
+				const Mesh& mesh = meshes[meshIndices[k]];
+				float distance = depth - glm::length(box.max - box.min) * 0.5f;
+				uint lod = lodScale > 0.0f && distance > 0.0f ? mesh.selectLod(lodScale * worldScale / distance) : 0;
+
+				mesh.draw(queue, shader, uniforms, world, depth, lod);
+				stats.meshesDrawn++;
+			}
+			else {
+				stats.meshesCulled++;
+			}
+		}
+		i++;
+	}
+}
+
+void SceneGraph::printHierarchy(std::ostream& out, int maxDepth) const {
+	// dubina se racuna u istom prolazu, roditelj je vec obradjen
+	std::vector<int> depths(size());
+	for (size_t i = 0; i < size(); i++) {
+		depths[i] = parents[i] < 0 ? 0 : depths[parents[i]] + 1;
+		if (depths[i] <= maxDepth) {
+			out << std::string(4 * depths[i], ' ') << names[i] << std::endl;
+		}
+	}
+}
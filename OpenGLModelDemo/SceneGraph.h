@@ -0,0 +1,110 @@
+#ifndef _MOJ_SCENE_GRAPH_H_
+#define _MOJ_SCENE_GRAPH_H_
+
+#include "glm/glm.hpp"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Bounds.h"
+#include "Mesh.h"
+#include "ModelData.h"
+#include "Shader.h"
+
+// Cvorovi modela kao ravni nizovi u depth-first redosledu, roditelj je uvek pre deteta.
+// Indeks cvora je isti u svim nizovima; nema pokazivaca ni alokacije po cvoru,
+// pa su racunanje svetskih matrica i crtanje jedan linearan prolaz.
+// Cvor i svi njegovi potomci su uzastopni, [i, subtreeEnds[i]), pa se posle promene
+// lokalne matrice racuna samo to podstablo.
+// Svaki cvor ima i kutiju celog podstabla u svetskom prostoru, pa draw() jednim testom
+// preskace podstablo koje je van frustuma.
+class SceneGraph {
+	typedef unsigned int uint;
+public:
+
+	// deo meshIndices koji pripada jednom cvoru
+	struct MeshRange {
+		uint first;
+		uint count;
+	};
+
+	// uzastopni cvorovi [first, first + count)
+	struct NodeRange {
+		uint first;
+		uint count;
+	};
+
+	// -1 za koren
+	std::vector<int> parents;
+
+	// menja se samo kroz setLocalTransform(), da bi cvor bio oznacen kao promenjen
+	std::vector<glm::mat4> localTransforms;
+
+	// parent world * local, popunjava updateWorldTransforms()
+	std::vector<glm::mat4> worldTransforms;
+
+	// kraj podstabla cvora (prvi indeks posle poslednjeg potomka)
+	std::vector<uint> subtreeEnds;
+
+	std::vector<MeshRange> meshRanges;
+
+	// indeksi u Model::meshes, za sve cvorove redom
+	std::vector<uint> meshIndices;
+
+	// world-space box of every entry in meshIndices (mesh bounds through its node's world matrix)
+	std::vector<AABB> meshBounds;
+
+	// unija kutija cvora i svih njegovih potomaka, [i, subtreeEnds[i])
+	std::vector<AABB> subtreeBounds;
+
+	// samo za ispis, odvojeno od podataka koji se koriste svaki frame
+	std::vector<std::string> names;
+
+	size_t size() const { return parents.size(); }
+
+	bool empty() const { return parents.empty(); }
+
+	// Takes the flat, depth-first node list from ModelData and computes world transforms.
+	void build(const std::vector<NodeData>& nodes);
+
+	// -1 ako cvor sa tim imenom ne postoji
+	int findNode(const std::string& name) const;
+
+	// Cvor se racuna ponovo tek u sledecem updateWorldTransforms(), zajedno sa celim podstablom.
+	void setLocalTransform(uint node, const glm::mat4& localTransform);
+
+	// Recomputes world transforms of the changed subtrees only; cost follows the number of
+	// nodes under changed ones, not the size of the model. Nothing changed - nothing to do.
+	void updateWorldTransforms();
+
+	// World matrices changed by the last updateWorldTransforms(), as sorted, disjoint node ranges
+	// (each range is contiguous in worldTransforms, one buffer upload per range).
+	const std::vector<NodeRange>& changedRanges() const { return changed; }
+
+	// Refits the boxes of the nodes in changedRanges() and of their ancestors. Called after
+	// build() and after every updateWorldTransforms(); with nothing changed it does nothing.
+	void updateBounds(const std::vector<Mesh>& meshes);
+
+	// Records every mesh whose box intersects the frustum of viewProjection, with its node's world
+	// transform. A subtree entirely outside is skipped with a single test.
+	// Each mesh uses the coarsest LOD whose error, projected with lodScale (see Model::draw), stays under a pixel.
+	void draw(RenderQueue& queue, Shader& shader, const std::vector<Mesh>& meshes, const glm::mat4& viewProjection, float lodScale) const;
+
+	// imena cvorova do dubine maxDepth, uvuceno po nivou
+	void printHierarchy(std::ostream& out, int maxDepth) const;
+
+private:
+
+	// cvorovi cija se lokalna matrica promenila od poslednjeg updateWorldTransforms()
+	std::vector<uint> dirtyNodes;
+	std::vector<unsigned char> dirtyFlags;
+
+	std::vector<NodeRange> changed;
+
+	// kutija podstabla iz kutija mesh-eva cvora i vec izracunatih kutija direktne dece
+	void refitSubtree(uint node);
+
+};
+
+#endif
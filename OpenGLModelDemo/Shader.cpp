@@ -1,13 +1,175 @@
 #include "Shader.h"
+#include "AssetCache.h"
+#include "ContentHash.h"
+#include "MappedFile.h"
 
+#include <cstring>
+#include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <sstream>
+#include <vector>
 
-Shader::Shader(std::string vshaderpath, std::string fshaderpath) {
-	std::string rawVshader = readShaderRaw(vshaderpath);
-	std::string rawFshader = readShaderRaw(fshaderpath);
+static const char PROGRAM_MAGIC[8] = { 'O', 'G', 'L', 'P', 'R', 'O', 'G', '1' };
 
+struct ProgramBinaryHeader {
+	char magic[8];
+	uint64_t key;
+	uint32_t binaryFormat;
+	uint32_t length;
+};
+
+// GL 4.1 konstante, vendor glad.h ih nema
+#ifndef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#endif
+#ifndef GL_PROGRAM_BINARY_LENGTH
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#endif
+#ifndef GL_NUM_PROGRAM_BINARY_FORMATS
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#endif
+
+typedef void (APIENTRYP GetProgramBinaryProc)(GLuint program, GLsizei bufSize, GLsizei* length, GLenum* binaryFormat, void* binary);
+typedef void (APIENTRYP ProgramBinaryProc)(GLuint program, GLenum binaryFormat, const void* binary, GLsizei length);
+typedef void (APIENTRYP ProgramParameteriProc)(GLuint program, GLenum pname, GLint value);
+
+static GetProgramBinaryProc getProgramBinary = nullptr;
+static ProgramBinaryProc programBinary = nullptr;
+static ProgramParameteriProc programParameteri = nullptr;
+
+// hash vendor/renderer/verzije; binarni program jednog drajvera ne vazi za drugi
+static uint64_t driverHash = 0;
+static bool programCacheEnabled = true;
+static ProgramCacheStats cacheStats;
+
+static bool hasExtension(const char* name) {
+	GLint count = 0;
+	glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+	for (GLint i = 0; i < count; i++) {
+		const char* extension = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+		if (extension && strcmp(extension, name) == 0) return true;
+	}
+	return false;
+}
+
+void Shader::loadProgramBinarySupport(GLADloadproc load) {
+	getProgramBinary = nullptr;
+	programBinary = nullptr;
+	programParameteri = nullptr;
+
+	bool gl41 = GLVersion.major > 4 || (GLVersion.major == 4 && GLVersion.minor >= 1);
+	if (!gl41 && !hasExtension("GL_ARB_get_program_binary")) {
+		std::cout << "SHADER::drajver nema glProgramBinary, programi se uvek kompajliraju" << std::endl;
+		return;
+	}
+
+	GLint formats = 0;
+	glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+	if (formats <= 0) {
+		std::cout << "SHADER::drajver ne nudi binarne formate programa, programi se uvek kompajliraju" << std::endl;
+		return;
+	}
+
+	getProgramBinary = reinterpret_cast<GetProgramBinaryProc>(load("glGetProgramBinary"));
+	programBinary = reinterpret_cast<ProgramBinaryProc>(load("glProgramBinary"));
+	programParameteri = reinterpret_cast<ProgramParameteriProc>(load("glProgramParameteri"));
+
+	std::string driver;
+	for (GLenum name : { GL_VENDOR, GL_RENDERER, GL_VERSION }) {
+		const char* value = reinterpret_cast<const char*>(glGetString(name));
+		driver += value ? value : "";
+		driver += '\n';
+	}
+	driverHash = contentHash64(driver.data(), driver.size());
+}
+
+void Shader::setProgramCache(bool enabled) {
+	programCacheEnabled = enabled;
+}
+
+const ProgramCacheStats& Shader::programCacheStats() {
+	return cacheStats;
+}
+
+Shader::Shader(std::string vshaderpath, std::string fshaderpath, const std::string& defines) {
+	std::set<std::string> openFiles;
+	std::string rawVshader = insertDefines(readShaderRaw(vshaderpath, openFiles), defines);
+	std::string rawFshader = insertDefines(readShaderRaw(fshaderpath, openFiles), defines);
+
+	this->programID = 0;
+
+	std::string cachePath;
+	uint64_t key = 0;
+	if (programCacheEnabled && getProgramBinary && programBinary && programParameteri) {
+		// hash vertex shadera je seed za fragment, pa i granica izmedju njih ulazi u kljuc
+		key = contentHash64(rawVshader.data(), rawVshader.size(), driverHash);
+		key = contentHash64(rawFshader.data(), rawFshader.size(), key);
+		cachePath = AssetCache::pathFor("program_" + hashToHex(key), ".glprog");
+		this->programID = loadProgramBinary(cachePath, key);
+	}
+
+	if (this->programID == 0) {
+		this->programID = compileProgram(rawVshader, rawFshader, cachePath, key);
+	}
+
+	loadUniformLocations();
+}
+
+Shader::uint Shader::loadProgramBinary(const std::string& cachePath, uint64_t key) {
+	MappedFile file(cachePath);
+	if (!file.isOpen() || file.size() < sizeof(ProgramBinaryHeader)) {
+		return 0;
+	}
+
+	ProgramBinaryHeader header;
+	memcpy(&header, file.data(), sizeof(header));
+	if (memcmp(header.magic, PROGRAM_MAGIC, sizeof(PROGRAM_MAGIC)) != 0 || header.key != key ||
+		header.length == 0 || header.length > file.size() - sizeof(header)) {
+		std::cout << "SHADER::ostecen binarni program, kompajlira se ponovo: " << cachePath << std::endl;
+		return 0;
+	}
+
+	uint program = glCreateProgram();
+	programBinary(program, header.binaryFormat, file.data() + sizeof(header), header.length);
+
+	// drajver sme da odbije binarni program (npr. posle azuriranja), tada se tiho kompajlira
+	GLint linked = GL_FALSE;
+	glGetProgramiv(program, GL_LINK_STATUS, &linked);
+	if (linked == GL_FALSE) {
+		std::cout << "SHADER::drajver odbio binarni program, kompajlira se ponovo: " << cachePath << std::endl;
+		glDeleteProgram(program);
+		cacheStats.rejected++;
+		return 0;
+	}
+
+	cacheStats.cached++;
+	return program;
+}
+
+void Shader::saveProgramBinary(uint program, const std::string& cachePath, uint64_t key) {
+	GLint length = 0;
+	glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+	if (length <= 0) return;
+
+	std::vector<unsigned char> file(sizeof(ProgramBinaryHeader) + length);
+	GLenum binaryFormat = 0;
+	GLsizei written = 0;
+	getProgramBinary(program, length, &written, &binaryFormat, file.data() + sizeof(ProgramBinaryHeader));
+	if (written <= 0) return;
+
+	ProgramBinaryHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, PROGRAM_MAGIC, sizeof(PROGRAM_MAGIC));
+	header.key = key;
+	header.binaryFormat = binaryFormat;
+	header.length = static_cast<uint32_t>(written);
+	memcpy(file.data(), &header, sizeof(header));
+
+	AssetCache::writeFile(cachePath, file.data(), sizeof(header) + written);
+}
+
+Shader::uint Shader::compileProgram(const std::string& rawVshader, const std::string& rawFshader, const std::string& cachePath, uint64_t key) {
 	const char* pRawVShader = rawVshader.c_str();
 	const char* pRawFShader = rawFshader.c_str();
 
@@ -24,18 +186,83 @@ Shader::Shader(std::string vshaderpath, std::string fshaderpath) {
 	checkCompileError(fshader, "Fragment Shader");
 
 	shaderprogram = glCreateProgram();
+	if (!cachePath.empty()) {
+		programParameteri(shaderprogram, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+	}
 	glAttachShader(shaderprogram, vshader);
 	glAttachShader(shaderprogram, fshader);
 	glLinkProgram(shaderprogram);
-	checkCompileError(shaderprogram, "PROGRAM");
 
-	this->programID = shaderprogram;
+	GLint linked = GL_FALSE;
+	glGetProgramiv(shaderprogram, GL_LINK_STATUS, &linked);
+	checkCompileError(shaderprogram, "PROGRAM");
 
 	glDeleteShader(vshader);
 	glDeleteShader(fshader);
+
+	cacheStats.compiled++;
+	if (linked == GL_TRUE && !cachePath.empty()) {
+		saveProgramBinary(shaderprogram, cachePath, key);
+	}
+
+	return shaderprogram;
+}
+
+void Shader::loadUniformLocations() {
+	GLint linked = GL_FALSE;
+	glGetProgramiv(this->programID, GL_LINK_STATUS, &linked);
+	if (linked == GL_FALSE) return;
+
+	GLint uniformCount = 0;
+	GLint maxNameLength = 0;
+	glGetProgramiv(this->programID, GL_ACTIVE_UNIFORMS, &uniformCount);
+	glGetProgramiv(this->programID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+
+	std::string name(maxNameLength > 0 ? maxNameLength : 1, '\0');
+	for (GLint i = 0; i < uniformCount; i++) {
+		GLsizei length = 0;
+		GLint size = 0;
+		GLenum type = 0;
+		glGetActiveUniform(this->programID, i, (GLsizei)name.size(), &length, &size, &type, &name[0]);
+		std::string uniformName = name.substr(0, length);
+
+		// uniformi iz uniform blokova nemaju lokaciju
+		GLint location = glGetUniformLocation(this->programID, uniformName.c_str());
+		if (location < 0) continue;
+
+		uniformLocations[uniformNameHash(uniformName.c_str())] = location;
+
+		// Niz osnovnog tipa se prijavljuje jednom, kao "ime[0]" sa size elemenata.
+		// Register "ime" and every "ime[i]"; element locations are queried, not assumed consecutive.
+		size_t bracket = uniformName.rfind("[0]");
+		if (size > 1 && bracket != std::string::npos && bracket + 3 == uniformName.size()) {
+			std::string baseName = uniformName.substr(0, bracket);
+			uniformLocations[uniformNameHash(baseName.c_str())] = location;
+			for (GLint element = 1; element < size; element++) {
+				std::string elementName = baseName + "[" + std::to_string(element) + "]";
+				uniformLocations[uniformNameHash(elementName.c_str())] = glGetUniformLocation(this->programID, elementName.c_str());
+			}
+		}
+	}
+}
+
+void Shader::bindUniformBlock(const GLchar* blockName, uint bindingPoint) const {
+	GLuint blockIndex = glGetUniformBlockIndex(this->programID, blockName);
+	if (blockIndex != GL_INVALID_INDEX) {
+		glUniformBlockBinding(this->programID, blockIndex, bindingPoint);
+	}
+}
+
+Uniform Shader::uniform(UniformName name) const {
+	Uniform result;
+	auto it = uniformLocations.find(name.hash);
+	if (it != uniformLocations.end()) {
+		result.location = it->second;
+	}
+	return result;
 }
 
-std::string Shader::readShaderRaw(std::string shaderpath) const {
+std::string Shader::readShaderRaw(std::string shaderpath, std::set<std::string>& openFiles) const {
 	std::ifstream rawShaderFile;
 	std::stringstream rawShaderText;
 	std::string shaderCode = "";
@@ -50,7 +277,59 @@ std::string Shader::readShaderRaw(std::string shaderpath) const {
 		std::cout << "ERROR While reading shader raw at: " << shaderpath << " error is " << e.what() << std::endl;
 	}
 
-	return shaderCode;
+	std::string openPath = std::filesystem::path(shaderpath).lexically_normal().generic_string();
+	openFiles.insert(openPath);
+	std::string resolved = resolveIncludes(shaderCode, shaderpath, openFiles);
+	openFiles.erase(openPath);
+	return resolved;
+}
+
+// GLSL nema #include; linija #include "fajl" se menja sadrzajem fajla iz istog foldera.
+// openFiles su fajlovi koji se upravo razresavaju: ciklican #include (fajl koji preko drugih ukljucuje
+// samog sebe) se prijavljuje kao los umesto beskonacne rekurzije.
+std::string Shader::resolveIncludes(const std::string& shaderCode, const std::string& shaderpath, std::set<std::string>& openFiles) const {
+	std::string directory;
+	size_t slash = shaderpath.find_last_of("/\\");
+	if (slash != std::string::npos) {
+		directory = shaderpath.substr(0, slash + 1);
+	}
+
+	std::istringstream lines(shaderCode);
+	std::string result;
+	std::string line;
+	while (std::getline(lines, line)) {
+		size_t start = line.find_first_not_of(" \t");
+		if (start != std::string::npos && line.compare(start, 8, "#include") == 0) {
+			size_t open = line.find('"', start);
+			size_t close = open == std::string::npos ? open : line.find('"', open + 1);
+			std::string includePath;
+			if (close != std::string::npos) {
+				includePath = std::filesystem::path(directory + line.substr(open + 1, close - open - 1)).lexically_normal().generic_string();
+			}
+			if (!includePath.empty() && openFiles.count(includePath) == 0) {
+				result += readShaderRaw(includePath, openFiles);
+				continue;
+			}
+			std::cout << "ERROR Bad #include in shader: " << shaderpath << ": " << line << std::endl;
+		}
+		result += line;
+		result += '\n';
+	}
+
+	return result;
+}
+
+// #version mora da bude prva linija, pa defines idu odmah iza nje.
+std::string Shader::insertDefines(const std::string& shaderCode, const std::string& defines) {
+	if (defines.empty()) return shaderCode;
+
+	size_t version = shaderCode.find("#version");
+	if (version == std::string::npos) return defines + shaderCode;
+
+	size_t lineEnd = shaderCode.find('\n', version);
+	if (lineEnd == std::string::npos) return shaderCode + "\n" + defines;
+
+	return shaderCode.substr(0, lineEnd + 1) + defines + shaderCode.substr(lineEnd + 1);
 }
 
 // Don't use, outdated, use readShaderRaw instead
@@ -94,53 +373,89 @@ void Shader::use() const {
 }
 
 void Shader::setBool(const GLchar* uniformName, bool value) const {
-	glUniform1i(glGetUniformLocation(this->programID, uniformName), (int)value);
+	glUniform1i(uniform(uniformName).location, (int)value);
 }
 
 void Shader::setInt(const GLchar* uniformName, int value) const {
-	glUniform1i(glGetUniformLocation(this->programID, uniformName), value);
+	glUniform1i(uniform(uniformName).location, value);
 }
 
 void Shader::setFloat(const GLchar* uniformName, float value) const {
-	glUniform1f(glGetUniformLocation(this->programID, uniformName), value);
+	glUniform1f(uniform(uniformName).location, value);
 }
 
 void Shader::set3Float(const GLchar* uniformName, float value1, float value2, float value3) const {
-	glUniform3f(glGetUniformLocation(this->programID, uniformName), value1, value2, value3);
+	glUniform3f(uniform(uniformName).location, value1, value2, value3);
 }
 
 void Shader::setVec2(const GLchar* uniformName, const glm::vec2& glmVec2value) const {
-	glUniform2fv(glGetUniformLocation(this->programID, uniformName), 1, &glmVec2value[0]);
+	glUniform2fv(uniform(uniformName).location, 1, &glmVec2value[0]);
 }
 
 void Shader::setVec2(const GLchar* uniformName, float x, float y) const {
-	glUniform2f(glGetUniformLocation(this->programID, uniformName), x, y);
+	glUniform2f(uniform(uniformName).location, x, y);
 }
 
 void Shader::setVec3(const GLchar* uniformName, const glm::vec3& glmVec3value) const {
-	glUniform3fv(glGetUniformLocation(this->programID, uniformName), 1, &glmVec3value[0]);
+	glUniform3fv(uniform(uniformName).location, 1, &glmVec3value[0]);
 }
 
 void Shader::setVec3(const GLchar* uniformName, float x, float y, float z) const {
-	glUniform3f(glGetUniformLocation(this->programID, uniformName), x, y, z);
+	glUniform3f(uniform(uniformName).location, x, y, z);
 }
 
 void Shader::setVec4(const GLchar* uniformName, const glm::vec4& glmVec4value) const {
-	glUniform4fv(glGetUniformLocation(this->programID, uniformName), 1, &glmVec4value[0]);
+	glUniform4fv(uniform(uniformName).location, 1, &glmVec4value[0]);
 }
 
 void Shader::setVec4(const GLchar* uniformName, float x, float y, float z, float w) const {
-	glUniform4f(glGetUniformLocation(this->programID, uniformName), x, y, z, w);
+	glUniform4f(uniform(uniformName).location, x, y, z, w);
 }
 
 void Shader::setMat2(const GLchar* uniformName, const glm::mat2& mat) const {
-	glUniformMatrix2fv(glGetUniformLocation(this->programID, uniformName), 1, GL_FALSE, &mat[0][0]);
+	glUniformMatrix2fv(uniform(uniformName).location, 1, GL_FALSE, &mat[0][0]);
 }
 
 void Shader::setMat3(const GLchar* uniformName, const glm::mat3& mat) const {
-	glUniformMatrix3fv(glGetUniformLocation(this->programID, uniformName), 1, GL_FALSE, &mat[0][0]);
+	glUniformMatrix3fv(uniform(uniformName).location, 1, GL_FALSE, &mat[0][0]);
 }
 
 void Shader::setMat4(const GLchar* uniformName, const glm::mat4& mat) const {
-	glUniformMatrix4fv(glGetUniformLocation(this->programID, uniformName), 1, GL_FALSE, &mat[0][0]);
+	glUniformMatrix4fv(uniform(uniformName).location, 1, GL_FALSE, &mat[0][0]);
+}
+
+void Shader::setBool(Uniform uniform, bool value) const {
+	glUniform1i(uniform.location, (int)value);
+}
+
+void Shader::setInt(Uniform uniform, int value) const {
+	glUniform1i(uniform.location, value);
+}
+
+void Shader::setFloat(Uniform uniform, float value) const {
+	glUniform1f(uniform.location, value);
+}
+
+void Shader::setVec2(Uniform uniform, const glm::vec2& glmVec2value) const {
+	glUniform2fv(uniform.location, 1, &glmVec2value[0]);
+}
+
+void Shader::setVec3(Uniform uniform, const glm::vec3& glmVec3value) const {
+	glUniform3fv(uniform.location, 1, &glmVec3value[0]);
+}
+
+void Shader::setVec3(Uniform uniform, float x, float y, float z) const {
+	glUniform3f(uniform.location, x, y, z);
+}
+
+void Shader::setVec4(Uniform uniform, const glm::vec4& glmVec4value) const {
+	glUniform4fv(uniform.location, 1, &glmVec4value[0]);
+}
+
+void Shader::setMat3(Uniform uniform, const glm::mat3& mat) const {
+	glUniformMatrix3fv(uniform.location, 1, GL_FALSE, &mat[0][0]);
+}
+
+void Shader::setMat4(Uniform uniform, const glm::mat4& mat) const {
+	glUniformMatrix4fv(uniform.location, 1, GL_FALSE, &mat[0][0]);
 }
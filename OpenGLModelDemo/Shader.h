@@ -3,9 +3,45 @@
 
 #include "glad/glad.h"
 #include "glm/glm.hpp"
+
+#include <cstdint>
+#include <set>
 #include <string>
+#include <unordered_map>
+
+// FNV-1a hash imena uniforma. constexpr, pa se za literale racuna pri kompajliranju.
+constexpr uint64_t uniformNameHash(const char* name) {
+	uint64_t hash = 14695981039346656037ull;
+	while (*name) {
+		hash = (hash ^ static_cast<unsigned char>(*name++)) * 1099511628211ull;
+	}
+	return hash;
+}
+
+// Uniform name reduced to its hash. "model"_uniform (or a constexpr UniformName)
+// costs nothing at runtime; a plain string is hashed when converted.
+struct UniformName {
+	uint64_t hash;
+
+	constexpr UniformName(const char* name) : hash(uniformNameHash(name)) {}
+};
 
+constexpr UniformName operator"" _uniform(const char* name, size_t) {
+	return UniformName(name);
+}
 
+// Lokacija uniforma razresena unapred. -1 (neaktivan uniform) OpenGL tiho ignorise.
+struct Uniform {
+	GLint location = -1;
+};
+
+// Koliko je programa u ovom procesu kompajlirano, a koliko ucitano iz binarnog kesa.
+struct ProgramCacheStats {
+	unsigned int compiled = 0;
+	unsigned int cached = 0;
+	// binarni program koji drajver nije prihvatio, pa je kompajliran ponovo
+	unsigned int rejected = 0;
+};
 
 class Shader {
 
@@ -14,12 +50,31 @@ typedef unsigned int uint;
 public:
 	uint programID;
 
+	// Binarni kes linkovanih programa: cache/program_<kljuc>.glprog, kljuc je finalni izvor oba shadera
+	// (posle #include i defines) i vendor/renderer/verzija drajvera.
+	// Vendor glad ucitava samo GL 3.3, a glGetProgramBinary / glProgramBinary su iz GL 4.1
+	// (ili ARB_get_program_binary), pa ih ova funkcija ucitava istim loader-om, posle gladLoadGLLoader.
+	// Ako ih drajver nema ili ne nudi nijedan binarni format, svaki program se kompajlira.
+	static void loadProgramBinarySupport(GLADloadproc load);
+
+	// false: svaki program se kompajlira, bez citanja i pisanja kesa (za A/B poredjenje)
+	static void setProgramCache(bool enabled);
+
+	static const ProgramCacheStats& programCacheStats();
+
 	// Constructor za shader.
 	// Vertex shader path, fragment shader path
-	Shader(std::string vshaderpath, std::string fshaderpath);
+	// defines (npr. "#define INSTANCED\n") se ubacuju odmah posle #version linije, u oba shadera
+	Shader(std::string vshaderpath, std::string fshaderpath, const std::string& defines = "");
 
 	void use() const;
 
+	// Vezuje uniform blok programa za binding point (GLSL 3.30 nema layout(binding = N)).
+	void bindUniformBlock(const GLchar* blockName, uint bindingPoint) const;
+
+	// Lookup in the table filled from glGetActiveUniform after linking, no GL call.
+	Uniform uniform(UniformName name) const;
+
 	void setBool(const GLchar* uniformName, bool value) const;
 
 	void setInt(const GLchar* uniformName, int value) const;
@@ -46,12 +101,49 @@ public:
 
 	void setMat4(const GLchar* uniformName, const glm::mat4 &mat) const;
 
+	// Isti setteri za vec razresene uniforme, za kod koji se izvrsava svaki frame.
+
+	void setBool(Uniform uniform, bool value) const;
+
+	void setInt(Uniform uniform, int value) const;
+
+	void setFloat(Uniform uniform, float value) const;
+
+	void setVec2(Uniform uniform, const glm::vec2 &glmVec2value) const;
+
+	void setVec3(Uniform uniform, const glm::vec3 &glmVec3value) const;
+
+	void setVec3(Uniform uniform, float x, float y, float z) const;
+
+	void setVec4(Uniform uniform, const glm::vec4 &glmVec4value) const;
+
+	void setMat3(Uniform uniform, const glm::mat3 &mat) const;
+
+	void setMat4(Uniform uniform, const glm::mat4 &mat) const;
+
 private:
 
-	std::string readShaderRaw(std::string shaderpath) const;
+	// hash imena -> lokacija, za sve aktivne uniforme programa
+	std::unordered_map<uint64_t, GLint> uniformLocations;
+
+	void loadUniformLocations();
+
+	std::string readShaderRaw(std::string shaderpath, std::set<std::string>& openFiles) const;
+
+	std::string resolveIncludes(const std::string& shaderCode, const std::string& shaderpath, std::set<std::string>& openFiles) const;
+
+	static std::string insertDefines(const std::string& shaderCode, const std::string& defines);
 
 	static std::string readShaderSource(std::string shaderpath);
 
+	// 0 ako fajla nema ili ga drajver odbije
+	static uint loadProgramBinary(const std::string& cachePath, uint64_t key);
+
+	static void saveProgramBinary(uint program, const std::string& cachePath, uint64_t key);
+
+	// sa cachePath binarni program se posle uspesnog linkovanja upisuje u kes
+	uint compileProgram(const std::string& rawVshader, const std::string& rawFshader, const std::string& cachePath, uint64_t key);
+
 	void checkCompileError(uint ID, std::string errorType);
 };
 #endif
@@ -0,0 +1,273 @@
+#include "TextureCache.h"
+#include "ContentHash.h"
+#include "ThreadPool.h"
+
+#include "glad/glad.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+size_t TextureCache::Residency::bytes(size_t droppedLevels) const {
+	size_t total = 0;
+	for (size_t level = droppedLevels; level < levelBytes.size(); level++) {
+		total += levelBytes[level];
+	}
+	return total;
+}
+
+TextureHandle TextureCache::find(uint64_t key) {
+	if (key == 0) return TextureHandle();
+
+	auto it = entries.find(key);
+	return it != entries.end() ? it->second.lock() : TextureHandle();
+}
+
+TextureHandle TextureCache::findLayer(uint64_t key, unsigned int& layer) {
+	if (key == 0) return TextureHandle();
+
+	auto it = layerEntries.find(key);
+	if (it == layerEntries.end()) return TextureHandle();
+
+	TextureHandle array = it->second.array.lock();
+	if (array) layer = it->second.layer;
+	return array;
+}
+
+TextureHandle TextureCache::insert(const DecodedImage& image, unsigned int id) {
+	return insertLayers(image.key, &image, 1, false, id);
+}
+
+TextureHandle TextureCache::insertArray(const std::vector<DecodedImage>& layers, unsigned int id) {
+	return insertLayers(arrayKey(layers), layers.data(), layers.size(), true, id);
+}
+
+TextureHandle TextureCache::insertLayers(uint64_t key, const DecodedImage* layers, size_t layerCount, bool array, unsigned int id) {
+	TextureHandle existing = find(key);
+	if (existing) {
+		glDeleteTextures(1, &id);
+		return existing;
+	}
+
+	SharedTexture* texture = new SharedTexture();
+	texture->id = id;
+	texture->key = key;
+	TextureHandle handle(texture, [](const SharedTexture* released) { TextureCache::getInstance().release(released); });
+
+	if (key != 0) {
+		entries[key] = handle;
+	}
+
+	if (array) {
+		for (size_t layer = 0; layer < layerCount; layer++) {
+			uint64_t layerKey = layers[layer].key;
+			texture->layerKeys.push_back(layerKey);
+			if (layerKey == 0) continue;
+
+			LayerEntry& entry = layerEntries[layerKey];
+			if (entry.array.expired()) {
+				entry.array = handle;
+				entry.layer = (unsigned int)layer;
+			}
+		}
+	}
+
+	bool valid = layerCount > 0;
+	for (size_t layer = 0; layer < layerCount; layer++) {
+		if (!canShareArray(layers[0], layers[layer])) valid = false;
+	}
+	if (valid) {
+		Residency& entry = residency[id];
+		entry.array = array;
+		entry.reloadable = true;
+		for (size_t layer = 0; layer < layerCount; layer++) {
+			entry.keys.push_back(layers[layer].key);
+			entry.sources.push_back(layers[layer].source);
+			if (layers[layer].key == 0 || layers[layer].source.path.empty()) entry.reloadable = false;
+		}
+		for (size_t level = 0; level < layers[0].levelCount(); level++) {
+			entry.levelBytes.push_back(textureLevelBytes(layers[0], level) * layerCount);
+		}
+		// nova tekstura jos nije stigla da se nacrta; ne izbacuje se odmah
+		entry.lastUsed = frame;
+
+		resident += entry.bytes(0);
+		peakResident = std::max(peakResident, resident);
+	}
+	return handle;
+}
+
+TextureHandle TextureCache::acquire(const DecodedImage& image) {
+	TextureHandle handle = find(image.key);
+	if (handle) {
+		std::cout << "CACHE::Texture shared: " << image.name << std::endl;
+		return handle;
+	}
+	return insert(image, uploadTexture(image));
+}
+
+TextureHandle TextureCache::acquireArray(const std::vector<DecodedImage>& layers) {
+	TextureHandle handle = find(arrayKey(layers));
+	if (handle) {
+		std::cout << "CACHE::Texture array shared: " << layers.size() << " layers" << std::endl;
+		return handle;
+	}
+	return insertArray(layers, uploadTextureArray(layers));
+}
+
+uint64_t TextureCache::arrayKey(const std::vector<DecodedImage>& layers) {
+	std::vector<uint64_t> keys;
+	for (const DecodedImage& layer : layers) {
+		if (layer.key == 0) return 0;
+		keys.push_back(layer.key);
+	}
+	// seed 1: niz od jedne slike nije ista tekstura kao ta slika u GL_TEXTURE_2D
+	return keys.empty() ? 0 : contentHash64(keys.data(), keys.size() * sizeof(uint64_t), 1);
+}
+
+void TextureCache::release(const SharedTexture* texture) {
+	// isti kljuc je mozda vec ponovo ucitan; taj unos ostaje
+	auto it = entries.find(texture->key);
+	if (it != entries.end() && it->second.expired()) {
+		entries.erase(it);
+	}
+	for (uint64_t layerKey : texture->layerKeys) {
+		auto layer = layerEntries.find(layerKey);
+		if (layer != layerEntries.end() && layer->second.array.expired()) {
+			layerEntries.erase(layer);
+		}
+	}
+
+	// ponovno dekodiranje u toku se samo odbacuje kad se zavrsi
+	auto found = residency.find(texture->id);
+	if (found != residency.end()) {
+		resident -= found->second.bytes(found->second.dropped);
+		residency.erase(found);
+	}
+
+	glDeleteTextures(1, &texture->id);
+	delete texture;
+}
+
+void TextureCache::update() {
+	frame++;
+
+	// plan se pravi iz pocetka svaki frame: sve crtano u prethodnom frame-u bi da bude puno,
+	// pa se izbacuje dok ne stane; isto stanje daje isti plan, pa nema ponovnih ucitavanja bez potrebe
+	finishReloads();
+	planReloads();
+	planEvictions();
+	startReloads();
+}
+
+size_t TextureCache::plannedBytes() const {
+	size_t total = 0;
+	for (const auto& entry : residency) {
+		total += entry.second.bytes(entry.second.targetDropped);
+	}
+	return total;
+}
+
+void TextureCache::finishReloads() {
+	for (auto& pair : residency) {
+		Residency& entry = pair.second;
+		if (!entry.reload.valid() || entry.reload.wait_for(std::chrono::seconds(0)) != std::future_status::ready) continue;
+
+		std::vector<DecodedImage> images = entry.reload.get();
+		if (entry.targetDropped == entry.dropped) continue;
+
+		bool unchanged = images.size() == entry.keys.size();
+		for (size_t layer = 0; unchanged && layer < images.size(); layer++) {
+			unchanged = images[layer].key == entry.keys[layer] && images[layer].levelCount() == entry.levelCount();
+		}
+		if (!unchanged) {
+			// fajl se promenio od prvog ucitavanja; tekstura ostaje kakva jeste i vise se ne izbacuje
+			std::cout << "CACHE::Texture source changed, not reloaded: " << entry.sources[0].path << std::endl;
+			entry.targetDropped = entry.dropped;
+			entry.reloadable = false;
+			continue;
+		}
+
+		if (entry.targetDropped < entry.dropped) reloadCount++;
+		else evictionCount++;
+
+		resident -= entry.bytes(entry.dropped);
+		size_t previousLevels = entry.levelCount() - entry.dropped;
+		if (entry.array) reuploadTextureArray(pair.first, images, entry.targetDropped, previousLevels);
+		else reuploadTexture(pair.first, images[0], entry.targetDropped, previousLevels);
+		entry.dropped = entry.targetDropped;
+		resident += entry.bytes(entry.dropped);
+		peakResident = std::max(peakResident, resident);
+	}
+}
+
+void TextureCache::planEvictions() {
+	size_t planned = plannedBytes();
+	if (budget == 0 || planned <= budget) return;
+
+	std::vector<Residency*> candidates;
+	for (auto& pair : residency) {
+		if (pair.second.canEvict() && pair.second.targetDropped + 1 < pair.second.levelCount()) {
+			candidates.push_back(&pair.second);
+		}
+	}
+	std::sort(candidates.begin(), candidates.end(), [](const Residency* a, const Residency* b) { return a->lastUsed < b->lastUsed; });
+
+	// cele teksture koje se nisu crtale ni u prethodnom frame-u, od najstarije
+	for (Residency* entry : candidates) {
+		if (planned <= budget || entry->lastUsed + 1 >= frame) break;
+
+		size_t smallest = entry->levelCount() - 1;
+		planned -= entry->bytes(entry->targetDropped) - entry->bytes(smallest);
+		entry->targetDropped = smallest;
+	}
+
+	// ako i to nije dosta, po jedan najveci nivo u krug, pa se kvalitet spusta ravnomerno
+	bool dropped = true;
+	while (planned > budget && dropped) {
+		dropped = false;
+		for (Residency* entry : candidates) {
+			if (planned <= budget) break;
+			if (entry->targetDropped + 1 >= entry->levelCount()) continue;
+
+			planned -= entry->levelBytes[entry->targetDropped];
+			entry->targetDropped++;
+			dropped = true;
+		}
+	}
+}
+
+void TextureCache::planReloads() {
+	for (auto& pair : residency) {
+		Residency& entry = pair.second;
+		if (entry.canEvict() && entry.lastUsed + 1 >= frame) {
+			entry.targetDropped = 0;
+		}
+	}
+}
+
+void TextureCache::startReloads() {
+	size_t pending = 0;
+	for (const auto& pair : residency) {
+		if (pair.second.reload.valid()) pending++;
+	}
+
+	// prvo izbacivanja (oslobadjaju memoriju), pa vracanja
+	for (int freeing = 1; freeing >= 0; freeing--) {
+		for (auto& pair : residency) {
+			Residency& entry = pair.second;
+			if (pending >= MAX_PENDING_RELOADS) return;
+			if (entry.reload.valid() || entry.targetDropped == entry.dropped || (entry.targetDropped > entry.dropped) != (freeing == 1)) continue;
+
+			std::vector<ImageSource> sources = entry.sources;
+			entry.reload = ThreadPool::getInstance().submit([sources]() {
+				std::vector<DecodedImage> images;
+				for (const ImageSource& source : sources) {
+					images.push_back(decodeImage(source));
+				}
+				return images;
+			});
+			pending++;
+		}
+	}
+}
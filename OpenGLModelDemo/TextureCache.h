@@ -1,10 +1,38 @@
 #ifndef _TEXTURE_CACHE_H_
 #define _TEXTURE_CACHE_H_
 
-#include "Mesh.h"
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <unordered_map>
+#include <vector>
 
-#include "unordered_map"
+#include "TextureLoader.h"
 
+// GL tekstura koju dele svi koji su ucitali isti sadrzaj.
+struct SharedTexture {
+	unsigned int id = 0;
+	// DecodedImage::key (hash izvornih bajtova + opcije dekodiranja), 0 = ne deli se
+	uint64_t key = 0;
+	// kljucevi slojeva niza, po redu (0 za sloj bez kljuca); prazno za GL_TEXTURE_2D
+	std::vector<uint64_t> layerKeys;
+};
+
+// Dok postoji bar jedan handle, tekstura postoji; poslednji handle je brise sa GPU-a.
+// Handle-ovi se oslobadjaju samo na GL niti (drze ih Model i Scene).
+typedef std::shared_ptr<const SharedTexture> TextureHandle;
+
+// Teksture po sadrzaju, ne po putanji: isti fajl iz dva foldera, ili embedded slika bez imena,
+// je jedna tekstura na GPU-u, koliko god je modela koristi.
+//
+// Uz to drzi teksture u budzetu GPU memorije. RenderQueue javlja koje teksture je vezao, pa se zna
+// kad je koja poslednji put koriscena. Kad je zbir preko budzeta, najduze nekoriscene se izbacuju:
+// prvo cele (ostaje 1x1 nivo), pa ako to nije dosta, i onima koje se crtaju po jedan najveci mip nivo, u krug.
+// Id se ne menja (u TextureSet-ovima je), menja se samo sadrzaj. Izbacena tekstura koja
+// se ponovo crta se vraca u punoj velicini cim stane, iz izvora na ThreadPool-u (obicno KTX2 iz kesa).
+// Nizovi (GL_TEXTURE_2D_ARRAY) se dele i izbacuju isto, ceo niz odjednom. Slika koja je vec sloj
+// nekog niza se nalazi i po svom kljucu (findLayer), pa je jednom na GPU-u i kad je drugi model
+// grupise sa drugim slikama.
 class TextureCache {
 public:
 	static TextureCache& getInstance() {
@@ -12,15 +40,130 @@ public:
 		return texCache;
 	}
 
-	static std::unordered_map<std::string, Texture>& getCache() {
-		static std::unordered_map<std::string, Texture> cache;
-		return cache;
+	// vec uploadovana tekstura sa istim kljucem, ili prazan handle
+	TextureHandle find(uint64_t key);
+
+	// Preuzima id teksture uploadovane iz image. Ako je isti kljuc u medjuvremenu vec dodat,
+	// id se brise i vraca se postojeca.
+	TextureHandle insert(const DecodedImage& image, unsigned int id);
+
+	// find, ili upload cele slike odjednom i insert
+	TextureHandle acquire(const DecodedImage& image);
+
+	// Isto za GL_TEXTURE_2D_ARRAY, kljuc je arrayKey(layers).
+	TextureHandle insertArray(const std::vector<DecodedImage>& layers, unsigned int id);
+
+	TextureHandle acquireArray(const std::vector<DecodedImage>& layers);
+
+	// Niz koji vec ima sliku sa ovim kljucem kao sloj (layer dobija njen sloj), ili prazan handle.
+	TextureHandle findLayer(uint64_t key, unsigned int& layer);
+
+	// Kljuc niza od kljuceva slojeva, po redu. Razlikuje se od kljuca iste slike kao GL_TEXTURE_2D;
+	// 0 (ne deli se) ako neki sloj nema kljuc.
+	static uint64_t arrayKey(const std::vector<DecodedImage>& layers);
+
+	size_t size() const { return entries.size(); }
+
+	// 0 = bez ogranicenja (nista se ne izbacuje)
+	void setMemoryBudget(size_t bytes) { budget = bytes; }
+
+	size_t memoryBudget() const { return budget; }
+
+	// procena zauzete GPU memorije svih tekstura iz kesa, sada i najvise do sada
+	size_t residentBytes() const { return resident; }
+	size_t peakResidentBytes() const { return peakResident; }
+
+	// koliko puta je tekstura smanjena (cela ili za nivoe), odnosno vracena
+	unsigned int evictions() const { return evictionCount; }
+	unsigned int reloads() const { return reloadCount; }
+
+	// tekstura je vezana za draw u ovom frame-u (zove RenderQueue::submit)
+	void markUsed(unsigned int id) {
+		auto it = residency.find(id);
+		if (it != residency.end()) it->second.lastUsed = frame;
 	}
 
+	// Jednom po frame-u, na GL niti, pre crtanja: zavrsava ponovna ucitavanja i drzi budzet.
+	void update();
+
+	TextureCache(const TextureCache&) = delete;
+	TextureCache& operator=(const TextureCache&) = delete;
+
 private:
 
+	// koliko najvise tekstura se istovremeno ponovo dekodira
+	static const size_t MAX_PENDING_RELOADS = 4;
+
+	// Sta je od teksture na GPU-u: nivoi [dropped, levelBytes.size()) izvora, dropped postaje nivo 0.
+	struct Residency {
+		bool array = false;
+
+		// po sloju; GL_TEXTURE_2D ima jedan
+		std::vector<uint64_t> keys;
+		std::vector<ImageSource> sources;
+
+		// svi slojevi imaju kljuc i izvor, pa mogu ponovo da se dekodiraju
+		bool reloadable = false;
+
+		// bajtovi svakog nivoa pune teksture, svi slojevi zajedno
+		std::vector<size_t> levelBytes;
+
+		size_t dropped = 0;
+		// koliko nivoa treba da bude odseceno; razlikuje se od dropped dok se izvor dekodira
+		size_t targetDropped = 0;
+
+		uint64_t lastUsed = 0;
+
+		std::future<std::vector<DecodedImage>> reload;
+
+		size_t levelCount() const { return levelBytes.size(); }
+
+		// zauzeto kad je odseceno toliko najvecih nivoa
+		size_t bytes(size_t droppedLevels) const;
+
+		bool canEvict() const { return reloadable && levelCount() > 1; }
+	};
+
+	std::unordered_map<uint64_t, std::weak_ptr<const SharedTexture>> entries;
+
+	// kljuc slike -> niz u kome je sloj; prvi niz sa tom slikom ostaje dok postoji
+	struct LayerEntry {
+		std::weak_ptr<const SharedTexture> array;
+		unsigned int layer = 0;
+	};
+	std::unordered_map<uint64_t, LayerEntry> layerEntries;
+
+	// po GL id-u
+	std::unordered_map<unsigned int, Residency> residency;
+
+	size_t budget = 0;
+	size_t resident = 0;
+	size_t peakResident = 0;
+
+	unsigned int evictionCount = 0;
+	unsigned int reloadCount = 0;
+
+	uint64_t frame = 0;
+
 	TextureCache() = default;
 
+	TextureHandle insertLayers(uint64_t key, const DecodedImage* layers, size_t layerCount, bool array, unsigned int id);
+
+	void release(const SharedTexture* texture);
+
+	// ponovo dekodirane teksture dobijaju nivoe po targetDropped
+	void finishReloads();
+
+	// teksture koriscene u prethodnom frame-u bi sve nivoe
+	void planReloads();
+
+	// povecava targetDropped najduze nekoriscenih dok plan ne stane u budzet
+	void planEvictions();
+
+	void startReloads();
+
+	size_t plannedBytes() const;
+
 };
 
-#endif
\ No newline at end of file
+#endif
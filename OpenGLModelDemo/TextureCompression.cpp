@@ -0,0 +1,372 @@
+#include "TextureCompression.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// 4x4 blok kao RGBA, red po red
+typedef unsigned char Block[16][4];
+
+// otprilike toliko blokova po komadu za ThreadPool::parallelFor
+static const int BLOCKS_PER_CHUNK = 1024;
+
+static void readBlock(const unsigned char* pixels, int width, int height, int channels, int blockX, int blockY, Block block) {
+	for (int y = 0; y < 4; y++) {
+		int sy = std::min(blockY * 4 + y, height - 1);
+		for (int x = 0; x < 4; x++) {
+			int sx = std::min(blockX * 4 + x, width - 1);
+			const unsigned char* source = pixels + (size_t(sy) * width + sx) * channels;
+			unsigned char* target = block[y * 4 + x];
+			if (channels == 1) {
+				target[0] = target[1] = target[2] = source[0];
+				target[3] = 255;
+			} else {
+				target[0] = source[0];
+				target[1] = source[1];
+				target[2] = source[2];
+				target[3] = channels == 4 ? source[3] : 255;
+			}
+		}
+	}
+}
+
+// ---------------------------------------------------------------- BC1 boja
+
+static unsigned short packColor(const float color[3]) {
+	int r = std::clamp(int(color[0] * 31.0f / 255.0f + 0.5f), 0, 31);
+	int g = std::clamp(int(color[1] * 63.0f / 255.0f + 0.5f), 0, 63);
+	int b = std::clamp(int(color[2] * 31.0f / 255.0f + 0.5f), 0, 31);
+	return static_cast<unsigned short>((r << 11) | (g << 5) | b);
+}
+
+static void unpackColor(unsigned short packed, int color[3]) {
+	int r = (packed >> 11) & 31, g = (packed >> 5) & 63, b = packed & 31;
+	color[0] = (r << 3) | (r >> 2);
+	color[1] = (g << 2) | (g >> 4);
+	color[2] = (b << 3) | (b >> 2);
+}
+
+// paleta u 4-color modu (c0 > c1); BC3 boja je uvek u tom modu
+static void colorPalette(unsigned short c0, unsigned short c1, bool fourColor, int palette[4][3]) {
+	unpackColor(c0, palette[0]);
+	unpackColor(c1, palette[1]);
+	for (int c = 0; c < 3; c++) {
+		if (fourColor) {
+			palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+			palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+		} else {
+			palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+			palette[3][c] = 0;
+		}
+	}
+}
+
+// najblize boje palete za svaki piksel; vraca ukupnu kvadratnu gresku
+static int selectColorIndices(const Block block, const int palette[4][3], unsigned char indices[16]) {
+	int total = 0;
+	for (int i = 0; i < 16; i++) {
+		int best = 0, bestError = 1 << 30;
+		for (int p = 0; p < 4; p++) {
+			int dr = block[i][0] - palette[p][0], dg = block[i][1] - palette[p][1], db = block[i][2] - palette[p][2];
+			int error = dr * dr + dg * dg + db * db;
+			if (error < bestError) {
+				bestError = error;
+				best = p;
+			}
+		}
+		indices[i] = static_cast<unsigned char>(best);
+		total += bestError;
+	}
+	return total;
+}
+
+// c0 > c1 (4-color mod); jednake boje znace jednobojni blok, svi indeksi 0
+static int fitEndpoints(const Block block, unsigned short& c0, unsigned short& c1, unsigned char indices[16]) {
+	if (c0 < c1) std::swap(c0, c1);
+	if (c0 == c1) {
+		int palette[4][3];
+		colorPalette(c0, c1, true, palette);
+		int total = 0;
+		for (int i = 0; i < 16; i++) {
+			indices[i] = 0;
+			for (int c = 0; c < 3; c++) total += (block[i][c] - palette[0][c]) * (block[i][c] - palette[0][c]);
+		}
+		return total;
+	}
+
+	int palette[4][3];
+	colorPalette(c0, c1, true, palette);
+	return selectColorIndices(block, palette, indices);
+}
+
+// Endpoint-i koji za date indekse daju najmanju kvadratnu gresku (2x2 sistem po kanalu).
+static bool refineEndpoints(const Block block, const unsigned char indices[16], float end0[3], float end1[3]) {
+	static const float weights[4] = { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+
+	float aa = 0, ab = 0, bb = 0;
+	float ax[3] = { 0, 0, 0 }, bx[3] = { 0, 0, 0 };
+	for (int i = 0; i < 16; i++) {
+		float a = weights[indices[i]], b = 1.0f - a;
+		aa += a * a;
+		ab += a * b;
+		bb += b * b;
+		for (int c = 0; c < 3; c++) {
+			ax[c] += a * block[i][c];
+			bx[c] += b * block[i][c];
+		}
+	}
+
+	float determinant = aa * bb - ab * ab;
+	if (std::fabs(determinant) < 1e-6f) return false;
+
+	for (int c = 0; c < 3; c++) {
+		end0[c] = std::clamp((ax[c] * bb - bx[c] * ab) / determinant, 0.0f, 255.0f);
+		end1[c] = std::clamp((bx[c] * aa - ax[c] * ab) / determinant, 0.0f, 255.0f);
+	}
+	return true;
+}
+
+static void encodeColorBlock(const Block block, unsigned char* output) {
+	float mean[3] = { 0, 0, 0 };
+	for (int i = 0; i < 16; i++) {
+		for (int c = 0; c < 3; c++) mean[c] += block[i][c];
+	}
+	for (int c = 0; c < 3; c++) mean[c] /= 16.0f;
+
+	float covariance[6] = { 0, 0, 0, 0, 0, 0 };
+	for (int i = 0; i < 16; i++) {
+		float r = block[i][0] - mean[0], g = block[i][1] - mean[1], b = block[i][2] - mean[2];
+		covariance[0] += r * r; covariance[1] += r * g; covariance[2] += r * b;
+		covariance[3] += g * g; covariance[4] += g * b; covariance[5] += b * b;
+	}
+
+	// glavna osa: par iteracija stepenovanja matrice, od dijagonale najveceg raspona
+	float axis[3] = { 1.0f, 1.0f, 1.0f };
+	for (int iteration = 0; iteration < 8; iteration++) {
+		float next[3] = {
+			covariance[0] * axis[0] + covariance[1] * axis[1] + covariance[2] * axis[2],
+			covariance[1] * axis[0] + covariance[3] * axis[1] + covariance[4] * axis[2],
+			covariance[2] * axis[0] + covariance[4] * axis[1] + covariance[5] * axis[2]
+		};
+		float length = std::max(std::fabs(next[0]), std::max(std::fabs(next[1]), std::fabs(next[2])));
+		if (length < 1e-6f) break;
+		for (int c = 0; c < 3; c++) axis[c] = next[c] / length;
+	}
+
+	// krajnje boje bloka duz ose, malo uvucene (1/16 raspona), kao kod vecine enkodera
+	float minProjection = 1e30f, maxProjection = -1e30f;
+	for (int i = 0; i < 16; i++) {
+		float projection = (block[i][0] - mean[0]) * axis[0] + (block[i][1] - mean[1]) * axis[1] + (block[i][2] - mean[2]) * axis[2];
+		minProjection = std::min(minProjection, projection);
+		maxProjection = std::max(maxProjection, projection);
+	}
+	float axisLength2 = axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2];
+	float inset = (maxProjection - minProjection) / 16.0f;
+
+	float end0[3], end1[3];
+	for (int c = 0; c < 3; c++) {
+		float scale = axisLength2 > 0.0f ? axis[c] / axisLength2 : 0.0f;
+		end0[c] = std::clamp(mean[c] + (maxProjection - inset) * scale, 0.0f, 255.0f);
+		end1[c] = std::clamp(mean[c] + (minProjection + inset) * scale, 0.0f, 255.0f);
+	}
+
+	unsigned short c0 = packColor(end0), c1 = packColor(end1);
+	unsigned char indices[16];
+	int error = fitEndpoints(block, c0, c1, indices);
+
+	// jedan krug najmanjih kvadrata; ostaje samo ako je bolje
+	if (error > 0 && c0 != c1 && refineEndpoints(block, indices, end0, end1)) {
+		unsigned short r0 = packColor(end0), r1 = packColor(end1);
+		unsigned char refined[16];
+		int refinedError = fitEndpoints(block, r0, r1, refined);
+		if (refinedError < error) {
+			c0 = r0;
+			c1 = r1;
+			memcpy(indices, refined, sizeof(refined));
+		}
+	}
+
+	unsigned int bits = 0;
+	for (int i = 0; i < 16; i++) bits |= unsigned(indices[i]) << (i * 2);
+
+	output[0] = static_cast<unsigned char>(c0 & 0xFF);
+	output[1] = static_cast<unsigned char>(c0 >> 8);
+	output[2] = static_cast<unsigned char>(c1 & 0xFF);
+	output[3] = static_cast<unsigned char>(c1 >> 8);
+	for (int b = 0; b < 4; b++) output[4 + b] = static_cast<unsigned char>(bits >> (b * 8));
+}
+
+static void decodeColorBlock(const unsigned char* input, bool forceFourColor, Block block) {
+	unsigned short c0 = static_cast<unsigned short>(input[0] | (input[1] << 8));
+	unsigned short c1 = static_cast<unsigned short>(input[2] | (input[3] << 8));
+	bool fourColor = forceFourColor || c0 > c1;
+
+	int palette[4][3];
+	colorPalette(c0, c1, fourColor, palette);
+
+	unsigned int bits = input[4] | (input[5] << 8) | (input[6] << 16) | (unsigned(input[7]) << 24);
+	for (int i = 0; i < 16; i++) {
+		int index = (bits >> (i * 2)) & 3;
+		for (int c = 0; c < 3; c++) block[i][c] = static_cast<unsigned char>(palette[index][c]);
+		block[i][3] = (!fourColor && index == 3) ? 0 : 255;
+	}
+}
+
+// ---------------------------------------------------------------- BC4 jedan kanal (i BC3 alfa)
+
+static void singlePalette(int a0, int a1, int palette[8]) {
+	palette[0] = a0;
+	palette[1] = a1;
+	if (a0 > a1) {
+		for (int i = 1; i < 7; i++) palette[i + 1] = ((7 - i) * a0 + i * a1) / 7;
+	} else {
+		for (int i = 1; i < 5; i++) palette[i + 1] = ((5 - i) * a0 + i * a1) / 5;
+		palette[6] = 0;
+		palette[7] = 255;
+	}
+}
+
+static void encodeSingleBlock(const Block block, int channel, unsigned char* output) {
+	int low = 255, high = 0;
+	for (int i = 0; i < 16; i++) {
+		low = std::min(low, int(block[i][channel]));
+		high = std::max(high, int(block[i][channel]));
+	}
+
+	// 8-vrednosni mod (a0 > a1); za ravan blok su svi indeksi 0
+	int palette[8];
+	singlePalette(high, low, palette);
+
+	unsigned long long bits = 0;
+	if (high != low) {
+		for (int i = 0; i < 16; i++) {
+			int value = block[i][channel], best = 0, bestError = 256;
+			for (int p = 0; p < 8; p++) {
+				int error = std::abs(value - palette[p]);
+				if (error < bestError) {
+					bestError = error;
+					best = p;
+				}
+			}
+			bits |= static_cast<unsigned long long>(best) << (i * 3);
+		}
+	}
+
+	output[0] = static_cast<unsigned char>(high);
+	output[1] = static_cast<unsigned char>(low);
+	for (int b = 0; b < 6; b++) output[2 + b] = static_cast<unsigned char>(bits >> (b * 8));
+}
+
+static void decodeSingleBlock(const unsigned char* input, unsigned char values[16]) {
+	int palette[8];
+	singlePalette(input[0], input[1], palette);
+
+	unsigned long long bits = 0;
+	for (int b = 0; b < 6; b++) bits |= static_cast<unsigned long long>(input[2 + b]) << (b * 8);
+	for (int i = 0; i < 16; i++) values[i] = static_cast<unsigned char>(palette[(bits >> (i * 3)) & 7]);
+}
+
+// ---------------------------------------------------------------- nivoi
+
+// blokovi jednog nivoa, red blokova po red na ThreadPool-u
+static void compressLevel(const unsigned char* pixels, int width, int height, int channels, BlockFormat format, unsigned char* output) {
+	int blocksX = (width + 3) / 4, blocksY = (height + 3) / 4;
+	size_t blockSize = CompressedTexture::blockSize(format);
+
+	ThreadPool::getInstance().parallelFor(blocksY, std::max(1, BLOCKS_PER_CHUNK / blocksX), [&](size_t rowBegin, size_t rowEnd) {
+		Block block;
+		for (int by = int(rowBegin); by < int(rowEnd); by++) {
+			for (int bx = 0; bx < blocksX; bx++) {
+				readBlock(pixels, width, height, channels, bx, by, block);
+				unsigned char* target = output + (size_t(by) * blocksX + bx) * blockSize;
+
+				switch (format) {
+				case BlockFormat::BC1: encodeColorBlock(block, target); break;
+				case BlockFormat::BC3: encodeSingleBlock(block, 3, target); encodeColorBlock(block, target + 8); break;
+				case BlockFormat::BC4: encodeSingleBlock(block, 0, target); break;
+				}
+			}
+		}
+	});
+}
+
+CompressedTexture compressImage(const std::vector<MipLevel>& levels, int channels) {
+	CompressedTexture texture;
+	if (levels.empty()) return texture;
+
+	switch (channels) {
+	case 1: texture.format = BlockFormat::BC4; break;
+	case 3: texture.format = BlockFormat::BC1; break;
+	case 4: texture.format = BlockFormat::BC3; break;
+	default: return texture;
+	}
+
+	size_t blockSize = CompressedTexture::blockSize(texture.format);
+	size_t offset = 0;
+	for (const MipLevel& source : levels) {
+		CompressedLevel level;
+		level.offset = offset;
+		level.size = size_t((source.width + 3) / 4) * ((source.height + 3) / 4) * blockSize;
+		level.width = source.width;
+		level.height = source.height;
+		texture.levels.push_back(level);
+		offset += level.size;
+	}
+	texture.data.resize(offset);
+
+	for (size_t l = 0; l < levels.size(); l++) {
+		compressLevel(levels[l].pixels.data(), levels[l].width, levels[l].height, channels, texture.format, texture.data.data() + texture.levels[l].offset);
+	}
+
+	return texture;
+}
+
+std::vector<unsigned char> decompressLevel(const CompressedTexture& texture, size_t level) {
+	std::vector<unsigned char> pixels;
+	if (level >= texture.levels.size()) return pixels;
+
+	const CompressedLevel& info = texture.levels[level];
+	size_t blockSize = CompressedTexture::blockSize(texture.format);
+	if (info.offset + info.size > texture.data.size()) return pixels;
+
+	int blocksX = (info.width + 3) / 4, blocksY = (info.height + 3) / 4;
+	pixels.resize(size_t(info.width) * info.height * 4);
+
+	Block block;
+	unsigned char values[16];
+	for (int by = 0; by < blocksY; by++) {
+		for (int bx = 0; bx < blocksX; bx++) {
+			const unsigned char* source = texture.data.data() + info.offset + (size_t(by) * blocksX + bx) * blockSize;
+
+			switch (texture.format) {
+			case BlockFormat::BC1:
+				decodeColorBlock(source, false, block);
+				break;
+			case BlockFormat::BC3:
+				decodeColorBlock(source + 8, true, block);
+				decodeSingleBlock(source, values);
+				for (int i = 0; i < 16; i++) block[i][3] = values[i];
+				break;
+			case BlockFormat::BC4:
+				decodeSingleBlock(source, values);
+				for (int i = 0; i < 16; i++) {
+					block[i][0] = block[i][1] = block[i][2] = values[i];
+					block[i][3] = 255;
+				}
+				break;
+			}
+
+			for (int y = 0; y < 4; y++) {
+				int py = by * 4 + y;
+				if (py >= info.height) break;
+				for (int x = 0; x < 4; x++) {
+					int px = bx * 4 + x;
+					if (px >= info.width) break;
+					memcpy(&pixels[(size_t(py) * info.width + px) * 4], block[y * 4 + x], 4);
+				}
+			}
+		}
+	}
+	return pixels;
+}
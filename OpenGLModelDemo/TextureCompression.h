@@ -0,0 +1,52 @@
+#ifndef _MOJ_TEXTURE_COMPRESSION_H_
+#define _MOJ_TEXTURE_COMPRESSION_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "MipChain.h"
+
+// Blok kompresija tekstura na CPU-u (4x4 piksela po bloku), sa celim mip lancem.
+//
+//   BC1 - RGB, 8 bajtova po bloku (slike sa 3 kanala)
+//   BC3 - RGBA, 16 bajtova: BC1 boja + BC4 alfa (slike sa 4 kanala)
+//   BC4 - jedan kanal, 8 bajtova (sive slike, GL_RED kao i nekompresovane)
+//
+// BC1 endpoint-i idu po glavnoj osi boja bloka (PCA), pa se jednom popravljaju najmanjim kvadratima
+// za izabrane indekse. Ivice slike koje nisu deljive sa 4 ponavljaju poslednji red/kolonu.
+// Mipmape pravi buildMipChain; redovi blokova se kompresuju paralelno na ThreadPool-u.
+enum class BlockFormat : uint32_t { BC1 = 1, BC3 = 3, BC4 = 4 };
+
+// Menja se sa svakom promenom enkodera ili mip filtera; ulazi u kljuc KTX2 kesa, pa se stari fajlovi ponovo prave.
+static const uint32_t BLOCK_ENCODER_VERSION = 2;
+
+struct CompressedLevel {
+	size_t offset = 0;
+	size_t size = 0;
+	int width = 0;
+	int height = 0;
+};
+
+struct CompressedTexture {
+	BlockFormat format = BlockFormat::BC1;
+
+	// levels[0] je puna velicina, svaki sledeci upola manji, do 1x1
+	std::vector<CompressedLevel> levels;
+	std::vector<unsigned char> data;
+
+	bool empty() const { return levels.empty(); }
+
+	// broj kanala izvorne slike: 3, 4 ili 1
+	int channels() const { return format == BlockFormat::BC3 ? 4 : format == BlockFormat::BC4 ? 1 : 3; }
+
+	static size_t blockSize(BlockFormat format) { return format == BlockFormat::BC3 ? 16 : 8; }
+};
+
+// Kompresuje ceo mip lanac (1, 3 ili 4 kanala); za druge kanale vraca prazno.
+CompressedTexture compressImage(const std::vector<MipLevel>& levels, int channels);
+
+// Jedan nivo nazad u RGBA8, za GPU bez podrske za format.
+std::vector<unsigned char> decompressLevel(const CompressedTexture& texture, size_t level);
+
+#endif
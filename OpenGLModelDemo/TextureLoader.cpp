@@ -0,0 +1,378 @@
+#include "TextureLoader.h"
+#include "AssetCache.h"
+#include "ContentHash.h"
+#include "Ktx2.h"
+#include "ThreadPool.h"
+
+#include "glad/glad.h"
+#include "stb_image.h"
+
+#include <atomic>
+#include <cstring>
+#include <iostream>
+
+// EXT_texture_compression_s3tc, glad ima samo core 3.3
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+
+static std::atomic<bool> flipVertically(false);
+static std::atomic<bool> compressionEnabled(true);
+
+static TextureMemoryStats memoryStats;
+
+void setFlipVerticallyOnLoad(bool flip) {
+	flipVertically = flip;
+	stbi_set_flip_vertically_on_load(flip);
+}
+
+void setTextureCompression(bool enabled) {
+	compressionEnabled = enabled;
+}
+
+// hash izvora + sve sto menja rezultat (flip, filter za mipmape, verzija enkodera)
+static uint64_t textureKey(uint64_t sourceHash, ColorSpace colorSpace) {
+	uint64_t seed = (uint64_t(BLOCK_ENCODER_VERSION) << 2) | (colorSpace == ColorSpace::SRGB ? 2 : 0) | (flipVertically ? 1 : 0);
+	return contentHash64(&sourceHash, sizeof(sourceHash), seed);
+}
+
+// Jedan KTX2 po izvoru, prostoru boja i kompresiji: ista slika kao SRGB i kao Linear, ili bez
+// kompresije (--raw-textures), ima razlicite nivoe, pa ne sme da prepisuje tudji fajl.
+static std::string cachePathFor(const std::string& name, ColorSpace colorSpace, bool compress) {
+	std::string suffix = colorSpace == ColorSpace::SRGB ? ".srgb" : ".linear";
+	return AssetCache::pathFor(name, suffix + (compress ? "" : ".raw") + ".ktx2");
+}
+
+static bool readCached(DecodedImage& image, const std::string& cachedPath, uint64_t key) {
+	if (!Ktx2::read(cachedPath, key, image.compressed, image.levels)) {
+		return false;
+	}
+	if (!image.compressed.empty()) {
+		image.width = image.compressed.levels[0].width;
+		image.height = image.compressed.levels[0].height;
+		image.channels = image.compressed.channels();
+	}
+	else {
+		image.width = image.levels[0].width;
+		image.height = image.levels[0].height;
+		image.channels = static_cast<int>(image.levels[0].pixels.size() / (size_t(image.width) * image.height));
+	}
+	return true;
+}
+
+// Mipmape od dekodiranih piksela (stbi ih oslobadja), pa kompresija ako je ukljucena i KTX2.
+// Slike sa 2 kanala ostaju nekompresovane; i takvi nivoi idu u KTX2, da se lanac ne pravi svaki put.
+static void buildLevels(DecodedImage& image, unsigned char* pixels, ColorSpace colorSpace, bool compress, const std::string& cachedPath, uint64_t key) {
+	if (!pixels) return;
+
+	image.levels = buildMipChain(pixels, image.width, image.height, image.channels, colorSpace);
+	stbi_image_free(pixels);
+
+	if (cachedPath.empty()) return;
+
+	if (compress) {
+		image.compressed = compressImage(image.levels, image.channels);
+	}
+
+	if (!image.compressed.empty()) {
+		image.levels.clear();
+		if (Ktx2::write(cachedPath, key, image.compressed)) {
+			std::cout << "KTX2::kompresovano " << image.name << " (" << image.width << "x" << image.height << ", "
+				<< image.compressed.levels.size() << " nivoa, " << image.compressed.data.size() << " B)" << std::endl;
+		}
+	}
+	else if (Ktx2::write(cachedPath, key, image.levels, image.channels)) {
+		std::cout << "KTX2::sacuvani nekompresovani nivoi " << image.name << " (" << image.width << "x" << image.height << ", "
+			<< image.levels.size() << " nivoa)" << std::endl;
+	}
+}
+
+DecodedImage decodeImageFile(const std::string& path, ColorSpace colorSpace) {
+	DecodedImage image;
+	image.name = path;
+	image.source.path = path;
+	image.source.colorSpace = colorSpace;
+
+	uint64_t sourceHash = 0;
+	if (hashFile(path, sourceHash)) {
+		image.key = textureKey(sourceHash, colorSpace);
+	}
+	bool compress = compressionEnabled;
+	std::string cachedPath = image.key != 0 ? cachePathFor(path, colorSpace, compress) : std::string();
+
+	if (!cachedPath.empty() && readCached(image, cachedPath, image.key)) {
+		return image;
+	}
+
+	unsigned char* pixels = stbi_load(path.c_str(), &image.width, &image.height, &image.channels, 0);
+	buildLevels(image, pixels, colorSpace, compress, cachedPath, image.key);
+	return image;
+}
+
+// bajtove drzi source, da bi TextureCache mogao ponovo da je dekodira kad je izbaci
+static DecodedImage decodeSharedMemory(std::shared_ptr<const std::vector<unsigned char>> bytes, const std::string& name, ColorSpace colorSpace) {
+	DecodedImage image;
+	image.name = name;
+	image.source.path = name;
+	image.source.colorSpace = colorSpace;
+
+	const unsigned char* data = bytes->data();
+	size_t size = bytes->size();
+	image.source.data = std::move(bytes);
+
+	if (size > 0) {
+		image.key = textureKey(contentHash64(data, size), colorSpace);
+	}
+
+	// embedded slika nema svoj fajl, pa je ime u kesu njen hash
+	bool compress = compressionEnabled;
+	std::string cachedPath = image.key != 0 ? cachePathFor("embedded_" + hashToHex(image.key), colorSpace, compress) : std::string();
+
+	if (!cachedPath.empty() && readCached(image, cachedPath, image.key)) {
+		return image;
+	}
+
+	unsigned char* pixels = size > 0 ? stbi_load_from_memory(data, static_cast<int>(size), &image.width, &image.height, &image.channels, 0) : nullptr;
+	buildLevels(image, pixels, colorSpace, compress, cachedPath, image.key);
+	return image;
+}
+
+DecodedImage decodeImageMemory(const unsigned char* data, size_t size, const std::string& name, ColorSpace colorSpace) {
+	std::shared_ptr<std::vector<unsigned char>> bytes = std::make_shared<std::vector<unsigned char>>();
+	if (data) bytes->assign(data, data + size);
+	return decodeSharedMemory(std::move(bytes), name, colorSpace);
+}
+
+std::future<DecodedImage> decodeImageFileAsync(const std::string& path, ColorSpace colorSpace) {
+	return ThreadPool::getInstance().submit([path, colorSpace]() { return decodeImageFile(path, colorSpace); });
+}
+
+DecodedImage decodeImage(const ImageSource& source) {
+	return source.data ? decodeSharedMemory(source.data, source.path, source.colorSpace) : decodeImageFile(source.path, source.colorSpace);
+}
+
+static bool hasExtension(const char* name) {
+	GLint count = 0;
+	glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+	for (GLint i = 0; i < count; i++) {
+		const char* extension = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+		if (extension && strcmp(extension, name) == 0) return true;
+	}
+	return false;
+}
+
+static GLenum channelFormat(int channels) {
+	if (channels == 1) return GL_RED;
+	if (channels == 2) return GL_RG;
+	if (channels == 4) return GL_RGBA;
+	return GL_RGB;
+}
+
+static bool s3tcSupported() {
+	// RGTC (BC4) je core od 3.0, S3TC (BC1/BC3) je ekstenzija koju ima skoro svaki desktop GPU
+	static const bool supported = hasExtension("GL_EXT_texture_compression_s3tc");
+	return supported;
+}
+
+// kompresovani nivoi idu na GPU takvi kakvi su; bez S3TC se BC1/BC3 dekompresuju
+static bool uploadsCompressed(const DecodedImage& image) {
+	return !image.compressed.empty() && (image.compressed.format == BlockFormat::BC4 || s3tcSupported());
+}
+
+static GLenum compressedFormat(BlockFormat format) {
+	if (format == BlockFormat::BC1) return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+	if (format == BlockFormat::BC3) return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+	return GL_COMPRESSED_RED_RGTC1;
+}
+
+// sve slike ispravne i medjusobno iste (jedna slika je uvek sama sa sobom)
+static bool layersMatch(const DecodedImage* layers, size_t layerCount) {
+	if (layerCount == 0) return false;
+	for (size_t layer = 0; layer < layerCount; layer++) {
+		if (!canShareArray(layers[0], layers[layer])) return false;
+	}
+	return true;
+}
+
+// GL_TEXTURE_2D ili GL_TEXTURE_2D_ARRAY sa layerCount slojeva; parametri su isti za oba
+static unsigned int createTexture(GLenum target, const DecodedImage* layers, size_t layerCount) {
+	unsigned int textureID;
+	glGenTextures(1, &textureID);
+
+	if (layersMatch(layers, layerCount)) {
+		glBindTexture(target, textureID);
+		glTexParameteri(target, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(layers[0].levelCount() - 1));
+		glTexParameteri(target, GL_TEXTURE_WRAP_S, GL_REPEAT);
+		glTexParameteri(target, GL_TEXTURE_WRAP_T, GL_REPEAT);
+		glTexParameteri(target, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+		glTexParameteri(target, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glBindTexture(target, 0); // unbinding je opcionalan uvek
+
+		memoryStats.textures++;
+		if (uploadsCompressed(layers[0])) {
+			memoryStats.compressed++;
+		}
+	}
+	else {
+		std::cerr << "Failed to load texture: " << (layerCount > 0 ? layers[0].name : std::string()) << std::endl;
+		for (size_t layer = 1; layer < layerCount; layer++) {
+			std::cerr << "  layer " << layer << ": " << layers[layer].name << std::endl;
+		}
+	}
+
+	return textureID;
+}
+
+bool canShareArray(const DecodedImage& first, const DecodedImage& second) {
+	if (!first.isValid() || !second.isValid()) return false;
+	if (first.width != second.width || first.height != second.height || first.levelCount() != second.levelCount()) return false;
+	if (first.compressed.empty() != second.compressed.empty()) return false;
+	return first.compressed.empty() ? first.channels == second.channels : first.compressed.format == second.compressed.format;
+}
+
+unsigned int createTexture(const DecodedImage& image) {
+	return createTexture(GL_TEXTURE_2D, &image, 1);
+}
+
+unsigned int createTextureArray(const std::vector<DecodedImage>& layers) {
+	return createTexture(GL_TEXTURE_2D_ARRAY, layers.data(), layers.size());
+}
+
+size_t textureLevelBytes(const DecodedImage& image, size_t level) {
+	if (level >= image.levelCount()) return 0;
+
+	if (image.compressed.empty()) return image.levels[level].pixels.size();
+
+	const CompressedLevel& info = image.compressed.levels[level];
+	return uploadsCompressed(image) ? info.size : size_t(info.width) * info.height * image.compressed.channels();
+}
+
+// Nivo level svih slojeva postaje nivo glLevel vezane teksture. Niz dobija slojeve jedan za drugim
+// u jednom pozivu; jedna slika ide direktno iz svojih bajtova, bez kopiranja.
+static void specifyLevel(GLenum target, const DecodedImage* layers, size_t layerCount, size_t level, GLint glLevel) {
+	const DecodedImage& first = layers[0];
+	GLsizei depth = static_cast<GLsizei>(layerCount);
+	std::vector<unsigned char> joined;
+
+	if (!first.compressed.empty() && uploadsCompressed(first)) {
+		const CompressedLevel& info = first.compressed.levels[level];
+		const unsigned char* data = first.compressed.data.data() + info.offset;
+		if (layerCount > 1) {
+			for (size_t layer = 0; layer < layerCount; layer++) {
+				const CompressedTexture& compressed = layers[layer].compressed;
+				const CompressedLevel& part = compressed.levels[level];
+				joined.insert(joined.end(), compressed.data.begin() + part.offset, compressed.data.begin() + part.offset + part.size);
+			}
+			data = joined.data();
+		}
+
+		GLenum internalFormat = compressedFormat(first.compressed.format);
+		GLsizei size = static_cast<GLsizei>(info.size * layerCount);
+		if (target == GL_TEXTURE_2D) glCompressedTexImage2D(target, glLevel, internalFormat, info.width, info.height, 0, size, data);
+		else glCompressedTexImage3D(target, glLevel, internalFormat, info.width, info.height, depth, 0, size, data);
+	}
+	else {
+		int width, height;
+		GLenum internalFormat, format;
+		const unsigned char* data;
+
+		if (!first.compressed.empty()) {
+			// bez S3TC: dekompresovano na CPU-u, uvek RGBA
+			width = first.compressed.levels[level].width;
+			height = first.compressed.levels[level].height;
+			internalFormat = channelFormat(first.compressed.channels());
+			format = GL_RGBA;
+			for (size_t layer = 0; layer < layerCount; layer++) {
+				std::vector<unsigned char> pixels = decompressLevel(layers[layer].compressed, level);
+				joined.insert(joined.end(), pixels.begin(), pixels.end());
+			}
+			data = joined.data();
+		}
+		else {
+			const MipLevel& mip = first.levels[level];
+			width = mip.width;
+			height = mip.height;
+			internalFormat = format = channelFormat(first.channels);
+			data = mip.pixels.data();
+			if (layerCount > 1) {
+				for (size_t layer = 0; layer < layerCount; layer++) {
+					const std::vector<unsigned char>& pixels = layers[layer].levels[level].pixels;
+					joined.insert(joined.end(), pixels.begin(), pixels.end());
+				}
+				data = joined.data();
+			}
+		}
+
+		// redovi nivoa nisu poravnati na 4 bajta (npr. 1x1 RGB)
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		if (target == GL_TEXTURE_2D) glTexImage2D(target, glLevel, internalFormat, width, height, 0, format, GL_UNSIGNED_BYTE, data);
+		else glTexImage3D(target, glLevel, internalFormat, width, height, depth, 0, format, GL_UNSIGNED_BYTE, data);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	}
+	memoryStats.bytes += textureLevelBytes(first, level) * layerCount;
+}
+
+static void uploadLevel(GLenum target, unsigned int texture, const DecodedImage* layers, size_t layerCount, size_t level) {
+	if (!layersMatch(layers, layerCount) || level >= layers[0].levelCount()) return;
+
+	glBindTexture(target, texture);
+	specifyLevel(target, layers, layerCount, level, static_cast<GLint>(level));
+	glBindTexture(target, 0);
+}
+
+void uploadTextureLevel(unsigned int texture, const DecodedImage& image, size_t level) {
+	uploadLevel(GL_TEXTURE_2D, texture, &image, 1, level);
+}
+
+void uploadTextureArrayLevel(unsigned int texture, const std::vector<DecodedImage>& layers, size_t level) {
+	uploadLevel(GL_TEXTURE_2D_ARRAY, texture, layers.data(), layers.size(), level);
+}
+
+static void reupload(GLenum target, unsigned int texture, const DecodedImage* layers, size_t layerCount, size_t firstLevel, size_t previousLevels) {
+	if (!layersMatch(layers, layerCount) || firstLevel >= layers[0].levelCount()) return;
+	size_t levelCount = layers[0].levelCount();
+
+	glBindTexture(target, texture);
+	glTexParameteri(target, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(levelCount - firstLevel - 1));
+	for (size_t level = firstLevel; level < levelCount; level++) {
+		specifyLevel(target, layers, layerCount, level, static_cast<GLint>(level - firstLevel));
+	}
+
+	// nivoi iza MAX_LEVEL bi ostali zauzeti; prazna slika ih oslobadja
+	for (size_t level = levelCount - firstLevel; level < previousLevels; level++) {
+		if (target == GL_TEXTURE_2D) glTexImage2D(target, static_cast<GLint>(level), GL_RGBA, 0, 0, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+		else glTexImage3D(target, static_cast<GLint>(level), GL_RGBA, 0, 0, 0, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+	}
+	glBindTexture(target, 0);
+}
+
+void reuploadTexture(unsigned int texture, const DecodedImage& image, size_t firstLevel, size_t previousLevels) {
+	reupload(GL_TEXTURE_2D, texture, &image, 1, firstLevel, previousLevels);
+}
+
+void reuploadTextureArray(unsigned int texture, const std::vector<DecodedImage>& layers, size_t firstLevel, size_t previousLevels) {
+	reupload(GL_TEXTURE_2D_ARRAY, texture, layers.data(), layers.size(), firstLevel, previousLevels);
+}
+
+unsigned int uploadTexture(const DecodedImage& image) {
+	unsigned int textureID = createTexture(image);
+	for (size_t level = 0; level < image.levelCount(); level++) {
+		uploadTextureLevel(textureID, image, level);
+	}
+	return textureID;
+}
+
+unsigned int uploadTextureArray(const std::vector<DecodedImage>& layers) {
+	unsigned int textureID = createTextureArray(layers);
+	for (size_t level = 0; !layers.empty() && level < layers[0].levelCount(); level++) {
+		uploadTextureArrayLevel(textureID, layers, level);
+	}
+	return textureID;
+}
+
+const TextureMemoryStats& textureMemoryStats() {
+	return memoryStats;
+}
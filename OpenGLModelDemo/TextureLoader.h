@@ -0,0 +1,114 @@
+#ifndef _MOJ_TEXTURE_LOADER_H_
+#define _MOJ_TEXTURE_LOADER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "MipChain.h"
+#include "TextureCompression.h"
+
+// Ucitavanje tekstura u dva koraka:
+// decode (stbi + mip lanac, bez GL-a, moze na bilo kojoj niti) i upload (samo na niti koja ima GL kontekst).
+//
+// Decode prvo gleda cache/<izvor>.<srgb|linear>[.raw].ktx2: ako je napravljen iz iste slike, PNG/JPG se uopste ne dekodira.
+// Inace dekodira, pravi mipmape (buildMipChain), kompresuje ih (BC1/BC3/BC4) i upisuje KTX2 za sledece pokretanje;
+// nivoi koji ostanu nekompresovani (bez kompresije, 2 kanala) upisuju se isto tako.
+// GL nit nikad ne racuna mipmape: svi nivoi stizu gotovi.
+
+// Odakle je slika dekodirana, da TextureCache moze ponovo da je ucita posle izbacivanja sa GPU-a.
+struct ImageSource {
+	// putanja fajla, ili ime embedded teksture
+	std::string path;
+	// bajtovi embedded slike (kodirani, PNG/JPG); prazno za fajl
+	std::shared_ptr<const std::vector<unsigned char>> data;
+	ColorSpace colorSpace = ColorSpace::SRGB;
+};
+
+struct DecodedImage {
+	int width = 0;
+	int height = 0;
+	int channels = 0;
+
+	// Tacno jedno od ova dva nije prazno kad je dekodiranje uspelo.
+	// levels: nekompresovani nivoi (bez kompresije ili 2 kanala), compressed: BCn nivoi.
+	std::vector<MipLevel> levels;
+	CompressedTexture compressed;
+
+	// putanja ili ime embedded teksture, za poruke o greskama
+	std::string name;
+
+	// hash izvornih (kodiranih) bajtova + flip i colorSpace; isti kljuc = ista tekstura (TextureCache).
+	// 0 ako izvor nije mogao da se procita.
+	uint64_t key = 0;
+
+	ImageSource source;
+
+	bool isValid() const { return !levels.empty() || !compressed.empty(); }
+
+	size_t levelCount() const { return compressed.empty() ? levels.size() : compressed.levels.size(); }
+};
+
+// Zamena za stbi_set_flip_vertically_on_load; ulazi i u kljuc KTX2 kesa.
+void setFlipVerticallyOnLoad(bool flip);
+
+// false: bez kompresije (za A/B poredjenje); mipmape se i dalje prave na CPU-u i kesiraju u svoj (.raw) KTX2
+void setTextureCompression(bool enabled);
+
+// colorSpace bira filter za mipmape: SRGB za boju (diffuse), Linear za podatke (specular)
+DecodedImage decodeImageFile(const std::string& path, ColorSpace colorSpace);
+
+DecodedImage decodeImageMemory(const unsigned char* data, size_t size, const std::string& name, ColorSpace colorSpace);
+
+// decodeImageFile na ThreadPool-u
+std::future<DecodedImage> decodeImageFileAsync(const std::string& path, ColorSpace colorSpace);
+
+// ponovo, iz DecodedImage::source; posle prvog puta obicno samo cita KTX2 iz kesa
+DecodedImage decodeImage(const ImageSource& source);
+
+// Pravi teksturu sa REPEAT/trilinear parametrima, bez ijednog nivoa; nivoi idu kroz uploadTextureLevel.
+// Kao i ranije, id se vraca i kad dekodiranje nije uspelo (prazna tekstura).
+unsigned int createTexture(const DecodedImage& image);
+
+// Jedan mip nivo. Kompresovana slika ide direktno preko glCompressedTexImage2D; ako GPU nema S3TC,
+// nivo se dekompresuje na CPU-u. Ostavlja GL_TEXTURE_2D nevezan.
+void uploadTextureLevel(unsigned int texture, const DecodedImage& image, size_t level);
+
+// createTexture + svi nivoi odjednom
+unsigned int uploadTexture(const DecodedImage& image);
+
+// Menja sadrzaj postojece teksture: nivo firstLevel slike postaje nivo 0, i tako redom do 1x1.
+// Id ostaje isti, pa TextureSet-ovi u kojima je tekstura ostaju ispravni. previousLevels je koliko
+// nivoa je tekstura imala do sada; oni preko novog broja se oslobadjaju.
+void reuploadTexture(unsigned int texture, const DecodedImage& image, size_t firstLevel, size_t previousLevels);
+
+// Isto za GL_TEXTURE_2D_ARRAY, sloj i je layers[i]. Slojevi moraju da imaju iste dimenzije, broj nivoa
+// i format (canShareArray); inace niz ostaje prazan, kao tekstura cije dekodiranje nije uspelo.
+unsigned int createTextureArray(const std::vector<DecodedImage>& layers);
+
+void uploadTextureArrayLevel(unsigned int texture, const std::vector<DecodedImage>& layers, size_t level);
+
+unsigned int uploadTextureArray(const std::vector<DecodedImage>& layers);
+
+void reuploadTextureArray(unsigned int texture, const std::vector<DecodedImage>& layers, size_t firstLevel, size_t previousLevels);
+
+// obe slike su ispravne i mogu da budu slojevi istog niza
+bool canShareArray(const DecodedImage& first, const DecodedImage& second);
+
+// koliko GPU memorije zauzima nivo (jedne slike, jednog sloja) kad se uploaduje (kompresovan ili ne, zavisno od GPU-a)
+size_t textureLevelBytes(const DecodedImage& image, size_t level);
+
+// Zbir svih uploadovanih tekstura i poslatih bajtova (mipmape i ponovna ucitavanja ukljucena).
+// Koliko je trenutno na GPU-u zna TextureCache::residentBytes().
+struct TextureMemoryStats {
+	unsigned int textures = 0;
+	unsigned int compressed = 0;
+	size_t bytes = 0;
+};
+
+const TextureMemoryStats& textureMemoryStats();
+
+#endif
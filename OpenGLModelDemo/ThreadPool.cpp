@@ -0,0 +1,87 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+
+ThreadPool::ThreadPool() {
+	unsigned int count = std::thread::hardware_concurrency();
+	if (count == 0) count = 1;
+
+	for (unsigned int i = 0; i < count; i++) {
+		workers.emplace_back(&ThreadPool::workerLoop, this);
+	}
+}
+
+ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard<std::mutex> lock(jobsMutex);
+		stopping = true;
+	}
+	jobsReady.notify_all();
+
+	for (std::thread& worker : workers) {
+		worker.join();
+	}
+}
+
+void ThreadPool::parallelFor(size_t count, size_t grain, const std::function<void(size_t, size_t)>& body) {
+	if (count == 0) return;
+	grain = std::max<size_t>(grain, 1);
+	size_t chunks = (count + grain - 1) / grain;
+	if (chunks == 1 || workers.size() <= 1) {
+		body(0, count);
+		return;
+	}
+
+	// Radnik koji stigne kad je sve uzeto samo izadje; body ne poziva, pa sme da nadzivi pozivaoca.
+	struct Progress {
+		std::atomic<size_t> next{ 0 };
+		size_t done = 0;
+		std::mutex mutex;
+		std::condition_variable finished;
+	};
+	std::shared_ptr<Progress> progress = std::make_shared<Progress>();
+
+	auto work = [progress, chunks, count, grain, &body]() {
+		for (;;) {
+			size_t chunk = progress->next++;
+			if (chunk >= chunks) return;
+			body(chunk * grain, std::min(count, (chunk + 1) * grain));
+
+			std::lock_guard<std::mutex> lock(progress->mutex);
+			if (++progress->done == chunks) progress->finished.notify_all();
+		}
+	};
+
+	size_t helpers = std::min<size_t>(workers.size(), chunks - 1);
+	for (size_t i = 0; i < helpers; i++) {
+		enqueue(work);
+	}
+	work();
+
+	std::unique_lock<std::mutex> lock(progress->mutex);
+	progress->finished.wait(lock, [&]() { return progress->done == chunks; });
+}
+
+void ThreadPool::enqueue(std::function<void()> job) {
+	{
+		std::lock_guard<std::mutex> lock(jobsMutex);
+		jobs.push_back(std::move(job));
+	}
+	jobsReady.notify_one();
+}
+
+void ThreadPool::workerLoop() {
+	for (;;) {
+		std::function<void()> job;
+		{
+			std::unique_lock<std::mutex> lock(jobsMutex);
+			jobsReady.wait(lock, [this]() { return stopping || !jobs.empty(); });
+			// zapoceti poslovi se zavrsavaju i pri gasenju, da niko ne ceka future zauvek
+			if (jobs.empty()) return;
+			job = std::move(jobs.front());
+			jobs.pop_front();
+		}
+		job();
+	}
+}
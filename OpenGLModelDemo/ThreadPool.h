@@ -0,0 +1,60 @@
+#ifndef _MOJ_THREAD_POOL_H_
+#define _MOJ_THREAD_POOL_H_
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Radnici za posao koji ne dira OpenGL (dekodiranje slika, import modela...).
+// Broj niti = broj jezgara. Poslovi se izvrsavaju redom kojim su predati.
+class ThreadPool {
+public:
+	static ThreadPool& getInstance() {
+		static ThreadPool pool;
+		return pool;
+	}
+
+	template <typename F>
+	auto submit(F&& job) -> std::future<decltype(job())> {
+		typedef decltype(job()) Result;
+		// packaged_task nije kopirljiv, a std::function trazi kopirljiv objekat
+		std::shared_ptr<std::packaged_task<Result()>> task = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(job));
+		std::future<Result> result = task->get_future();
+		enqueue([task]() { (*task)(); });
+		return result;
+	}
+
+	// Deli [0, count) na komade od po grain i poziva body(begin, end) za svaki, paralelno.
+	// Pozivalac i sam uzima komade i ceka samo one koje je radnik vec zapoceo, pa sme da se zove i iz
+	// posla koji vec radi na pool-u (ne ceka da se oslobodi red).
+	void parallelFor(size_t count, size_t grain, const std::function<void(size_t, size_t)>& body);
+
+	unsigned int workerCount() const { return static_cast<unsigned int>(workers.size()); }
+
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+private:
+
+	std::vector<std::thread> workers;
+	std::deque<std::function<void()>> jobs;
+	std::mutex jobsMutex;
+	std::condition_variable jobsReady;
+	bool stopping = false;
+
+	ThreadPool();
+
+	void enqueue(std::function<void()> job);
+
+	void workerLoop();
+
+};
+
+#endif
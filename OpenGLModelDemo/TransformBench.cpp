@@ -0,0 +1,150 @@
+// Microbenchmark za TransformKernels.
+// Compares every kernel set this CPU supports against the scalar glm code the scene used before
+// (translate * toMat4(angleAxis) * scale, parent * local, transpose(inverse(mat3))) and prints JSON.
+//
+//   transform_bench [--count N] [--repeats N]
+//
+// ns_per_element is the best of --repeats runs; max_error is the largest relative difference from glm.
+
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+#include "glm/gtc/quaternion.hpp"
+#include "glm/gtx/quaternion.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "TransformKernels.h"
+
+typedef std::chrono::steady_clock Clock;
+
+struct BenchInput {
+	TransformSoA transforms;
+	std::vector<glm::vec3> positions, scales;
+	std::vector<glm::quat> rotations;
+	std::vector<int> parents;
+	glm::mat4 view;
+};
+
+// nasumicne transformacije i stablo u kome je roditelj uvek pre deteta
+static BenchInput makeInput(size_t count) {
+	BenchInput input;
+	std::mt19937 random(1234);
+	std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+	input.transforms.resize(count);
+	for (size_t i = 0; i < count; i++) {
+		glm::vec3 position = glm::vec3(unit(random), unit(random), unit(random)) * 20.0f;
+		glm::vec3 axis = glm::normalize(glm::vec3(unit(random), unit(random), unit(random)) + glm::vec3(0.0f, 0.0f, 1e-3f));
+		glm::quat rotation = glm::angleAxis(unit(random) * glm::pi<float>(), axis);
+		glm::vec3 scale = glm::vec3(1.0f) + glm::vec3(unit(random), unit(random), unit(random)) * 0.25f;
+
+		input.positions.push_back(position);
+		input.rotations.push_back(rotation);
+		input.scales.push_back(scale);
+		input.transforms.set(i, position, rotation, scale);
+		input.parents.push_back(i == 0 ? -1 : (int)(random() % i));
+	}
+	input.view = glm::lookAt(glm::vec3(3.0f, 4.0f, 10.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+	return input;
+}
+
+// najbolje vreme od repeats pokretanja, u nanosekundama po elementu
+static double measure(const std::function<void()>& run, size_t count, int repeats) {
+	double best = 1e30;
+	for (int r = 0; r < repeats; r++) {
+		Clock::time_point start = Clock::now();
+		run();
+		double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+		best = std::min(best, ns / (double)count);
+	}
+	return best;
+}
+
+template <typename Matrix>
+static float maxError(const std::vector<Matrix>& a, const std::vector<Matrix>& b) {
+	float error = 0.0f;
+	for (size_t i = 0; i < a.size(); i++) {
+		const float* x = reinterpret_cast<const float*>(&a[i]);
+		const float* y = reinterpret_cast<const float*>(&b[i]);
+		for (size_t k = 0; k < sizeof(Matrix) / sizeof(float); k++) {
+			error = std::max(error, std::fabs(x[k] - y[k]) / std::max(1.0f, std::fabs(y[k])));
+		}
+	}
+	return error;
+}
+
+int main(int argc, char** argv) {
+	size_t count = 100000;
+	int repeats = 20;
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		if (arg == "--count" && i + 1 < argc) count = (size_t)std::max(1, atoi(argv[++i]));
+		else if (arg == "--repeats" && i + 1 < argc) repeats = std::max(1, atoi(argv[++i]));
+		else {
+			std::cerr << "usage: transform_bench [--count N] [--repeats N]" << std::endl;
+			return 1;
+		}
+	}
+
+	BenchInput input = makeInput(count);
+	std::vector<glm::mat4> locals(count), worlds(count), viewModels(count), out(count);
+	std::vector<glm::mat3> normals(count), normalsOut(count);
+
+	// GLM - referenca, isti izrazi kao pre kernela
+	double glmCompose = measure([&]() {
+		for (size_t i = 0; i < count; i++) {
+			locals[i] = glm::scale(glm::translate(glm::mat4(1.0f), input.positions[i]) * glm::toMat4(input.rotations[i]), input.scales[i]);
+		}
+	}, count, repeats);
+	double glmMultiply = measure([&]() {
+		for (size_t i = 0; i < count; i++) viewModels[i] = input.view * locals[i];
+	}, count, repeats);
+	double glmHierarchy = measure([&]() {
+		for (size_t i = 0; i < count; i++) {
+			worlds[i] = input.parents[i] < 0 ? locals[i] : worlds[input.parents[i]] * locals[i];
+		}
+	}, count, repeats);
+	double glmNormal = measure([&]() {
+		for (size_t i = 0; i < count; i++) normals[i] = glm::transpose(glm::inverse(glm::mat3(viewModels[i])));
+	}, count, repeats);
+
+	std::cout << "{" << std::endl;
+	std::cout << "  \"count\": " << count << "," << std::endl;
+	std::cout << "  \"default_kernels\": \"" << TransformKernels::kernelName() << "\"," << std::endl;
+	std::cout << "  \"ns_per_element\": [" << std::endl;
+	std::cout << "    { \"kernels\": \"glm\", \"compose_trs\": " << glmCompose << ", \"view_multiply\": " << glmMultiply
+		<< ", \"hierarchy\": " << glmHierarchy << ", \"normal_matrix\": " << glmNormal << " }";
+
+	const char* kernelSets[] = { "scalar", "sse2", "avx2" };
+	for (const char* name : kernelSets) {
+		if (!TransformKernels::selectKernels(name)) continue;
+
+		double compose = measure([&]() { TransformKernels::composeTRS(input.transforms, out.data()); }, count, repeats);
+		float composeError = maxError(out, locals);
+
+		double multiply = measure([&]() { TransformKernels::multiply(input.view, locals.data(), out.data(), count); }, count, repeats);
+		float multiplyError = maxError(out, viewModels);
+
+		double hierarchy = measure([&]() { TransformKernels::multiplyHierarchy(input.parents.data(), locals.data(), out.data(), count); }, count, repeats);
+		float hierarchyError = maxError(out, worlds);
+
+		double normal = measure([&]() { TransformKernels::normalMatrices(viewModels.data(), normalsOut.data(), count); }, count, repeats);
+		float normalError = maxError(normalsOut, normals);
+
+		std::cout << "," << std::endl;
+		std::cout << "    { \"kernels\": \"" << name << "\", \"compose_trs\": " << compose << ", \"view_multiply\": " << multiply
+			<< ", \"hierarchy\": " << hierarchy << ", \"normal_matrix\": " << normal
+			<< ", \"max_error\": [" << composeError << ", " << multiplyError << ", " << hierarchyError << ", " << normalError << "] }";
+	}
+	std::cout << std::endl << "  ]" << std::endl << "}" << std::endl;
+
+	return 0;
+}
@@ -0,0 +1,343 @@
+#include "TransformKernels.h"
+
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TRANSFORM_KERNELS_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#endif
+
+// TransformKernelsAVX2.cpp, nullptr ako ovaj build nema AVX2 verziju
+const TransformKernelTable* avx2TransformKernels();
+
+void TransformSoA::resize(size_t count) {
+	positionX.resize(count, 0.0f);
+	positionY.resize(count, 0.0f);
+	positionZ.resize(count, 0.0f);
+	rotationX.resize(count, 0.0f);
+	rotationY.resize(count, 0.0f);
+	rotationZ.resize(count, 0.0f);
+	rotationW.resize(count, 1.0f);
+	scaleX.resize(count, 1.0f);
+	scaleY.resize(count, 1.0f);
+	scaleZ.resize(count, 1.0f);
+}
+
+void TransformSoA::set(size_t index, const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale) {
+	setPosition(index, position);
+	setRotation(index, rotation);
+	scaleX[index] = scale.x;
+	scaleY[index] = scale.y;
+	scaleZ[index] = scale.z;
+}
+
+void TransformSoA::setPosition(size_t index, const glm::vec3& position) {
+	positionX[index] = position.x;
+	positionY[index] = position.y;
+	positionZ[index] = position.z;
+}
+
+void TransformSoA::setRotation(size_t index, const glm::quat& rotation) {
+	rotationX[index] = rotation.x;
+	rotationY[index] = rotation.y;
+	rotationZ[index] = rotation.z;
+	rotationW[index] = rotation.w;
+}
+
+// SCALAR - referentna verzija i fallback za procesore bez SSE2
+
+enum { POSITION_X, POSITION_Y, POSITION_Z, ROTATION_X, ROTATION_Y, ROTATION_Z, ROTATION_W, SCALE_X, SCALE_Y, SCALE_Z, COMPONENT_COUNT };
+
+static void composeTRSScalar(const float* const* components, size_t count, float* out) {
+	for (size_t i = 0; i < count; i++) {
+		float x = components[ROTATION_X][i], y = components[ROTATION_Y][i], z = components[ROTATION_Z][i], w = components[ROTATION_W][i];
+		float sx = components[SCALE_X][i], sy = components[SCALE_Y][i], sz = components[SCALE_Z][i];
+
+		// isti izrazi kao glm::toMat3(quat)
+		float* m = out + i * 16;
+		m[0] = (1.0f - 2.0f * (y * y + z * z)) * sx;
+		m[1] = (2.0f * (x * y + w * z)) * sx;
+		m[2] = (2.0f * (x * z - w * y)) * sx;
+		m[3] = 0.0f;
+		m[4] = (2.0f * (x * y - w * z)) * sy;
+		m[5] = (1.0f - 2.0f * (x * x + z * z)) * sy;
+		m[6] = (2.0f * (y * z + w * x)) * sy;
+		m[7] = 0.0f;
+		m[8] = (2.0f * (x * z + w * y)) * sz;
+		m[9] = (2.0f * (y * z - w * x)) * sz;
+		m[10] = (1.0f - 2.0f * (x * x + y * y)) * sz;
+		m[11] = 0.0f;
+		m[12] = components[POSITION_X][i];
+		m[13] = components[POSITION_Y][i];
+		m[14] = components[POSITION_Z][i];
+		m[15] = 1.0f;
+	}
+}
+
+static inline void multiplyMatrixScalar(const float* a, const float* b, float* out) {
+	float result[16];
+	for (int column = 0; column < 4; column++) {
+		for (int row = 0; row < 4; row++) {
+			result[column * 4 + row] = a[row] * b[column * 4] + a[4 + row] * b[column * 4 + 1]
+				+ a[8 + row] * b[column * 4 + 2] + a[12 + row] * b[column * 4 + 3];
+		}
+	}
+	memcpy(out, result, sizeof(result));
+}
+
+static void multiplyPairsScalar(const float* left, const float* right, float* out, size_t count) {
+	for (size_t i = 0; i < count; i++) {
+		multiplyMatrixScalar(left + i * 16, right + i * 16, out + i * 16);
+	}
+}
+
+static void multiplyByOneScalar(const float* left, const float* right, float* out, size_t count) {
+	float leftCopy[16];
+	memcpy(leftCopy, left, sizeof(leftCopy));
+	for (size_t i = 0; i < count; i++) {
+		multiplyMatrixScalar(leftCopy, right + i * 16, out + i * 16);
+	}
+}
+
+static void multiplyHierarchyScalar(const int* parents, const float* locals, float* worlds, size_t first, size_t count) {
+	for (size_t i = first; i < first + count; i++) {
+		if (parents[i] < 0) memcpy(worlds + i * 16, locals + i * 16, 16 * sizeof(float));
+		else multiplyMatrixScalar(worlds + parents[i] * 16, locals + i * 16, worlds + i * 16);
+	}
+}
+
+// Kolone inverse-transpose 3x3 dela su (b x c, c x a, a x b) / det, gde su a, b, c kolone matrice.
+static void normalMatricesScalar(const float* matrices, float* out, size_t count) {
+	for (size_t i = 0; i < count; i++) {
+		const float* m = matrices + i * 16;
+		glm::vec3 a = glm::vec3(m[0], m[1], m[2]);
+		glm::vec3 b = glm::vec3(m[4], m[5], m[6]);
+		glm::vec3 c = glm::vec3(m[8], m[9], m[10]);
+		glm::vec3 bc = glm::cross(b, c), ca = glm::cross(c, a), ab = glm::cross(a, b);
+		float inverseDeterminant = 1.0f / glm::dot(a, bc);
+
+		float* n = out + i * 9;
+		for (int k = 0; k < 3; k++) {
+			n[k] = bc[k] * inverseDeterminant;
+			n[3 + k] = ca[k] * inverseDeterminant;
+			n[6 + k] = ab[k] * inverseDeterminant;
+		}
+	}
+}
+
+static const TransformKernelTable scalarKernels = {
+	"scalar",
+	composeTRSScalar,
+	multiplyPairsScalar,
+	multiplyByOneScalar,
+	multiplyHierarchyScalar,
+	normalMatricesScalar
+};
+
+#ifdef TRANSFORM_KERNELS_SSE2
+
+// SSE2 - 4 elementa po koraku za composeTRS, jedna kolona po registru za mnozenje
+
+static inline void composeBlockSSE2(const float* const* components, size_t first, size_t count, float* out) {
+	// poslednji, nepotpuni blok se dopuni identitetom
+	static const float padding[COMPONENT_COUNT] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f };
+	__m128 v[COMPONENT_COUNT];
+	for (int k = 0; k < COMPONENT_COUNT; k++) {
+		if (count == 4) {
+			v[k] = _mm_loadu_ps(components[k] + first);
+		}
+		else {
+			float lanes[4];
+			for (size_t lane = 0; lane < 4; lane++) lanes[lane] = lane < count ? components[k][first + lane] : padding[k];
+			v[k] = _mm_loadu_ps(lanes);
+		}
+	}
+
+	__m128 x = v[ROTATION_X], y = v[ROTATION_Y], z = v[ROTATION_Z], w = v[ROTATION_W];
+	__m128 one = _mm_set1_ps(1.0f), two = _mm_set1_ps(2.0f), zero = _mm_setzero_ps();
+	__m128 xx = _mm_mul_ps(x, x), yy = _mm_mul_ps(y, y), zz = _mm_mul_ps(z, z);
+	__m128 xy = _mm_mul_ps(x, y), xz = _mm_mul_ps(x, z), yz = _mm_mul_ps(y, z);
+	__m128 wx = _mm_mul_ps(w, x), wy = _mm_mul_ps(w, y), wz = _mm_mul_ps(w, z);
+
+	__m128 columns[4][4] = {
+		{
+			_mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))), v[SCALE_X]),
+			_mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xy, wz)), v[SCALE_X]),
+			_mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xz, wy)), v[SCALE_X]),
+			zero
+		},
+		{
+			_mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xy, wz)), v[SCALE_Y]),
+			_mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz))), v[SCALE_Y]),
+			_mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(yz, wx)), v[SCALE_Y]),
+			zero
+		},
+		{
+			_mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xz, wy)), v[SCALE_Z]),
+			_mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(yz, wx)), v[SCALE_Z]),
+			_mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy))), v[SCALE_Z]),
+			zero
+		},
+		{ v[POSITION_X], v[POSITION_Y], v[POSITION_Z], one }
+	};
+
+	// posle transponovanja svaki registar je jedna kolona jednog elementa
+	float block[4 * 16];
+	float* target = count == 4 ? out : block;
+	for (int column = 0; column < 4; column++) {
+		__m128 r0 = columns[column][0], r1 = columns[column][1], r2 = columns[column][2], r3 = columns[column][3];
+		_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+		_mm_storeu_ps(target + 0 * 16 + column * 4, r0);
+		_mm_storeu_ps(target + 1 * 16 + column * 4, r1);
+		_mm_storeu_ps(target + 2 * 16 + column * 4, r2);
+		_mm_storeu_ps(target + 3 * 16 + column * 4, r3);
+	}
+	if (count != 4) memcpy(out, block, count * 16 * sizeof(float));
+}
+
+static void composeTRSSSE2(const float* const* components, size_t count, float* out) {
+	for (size_t first = 0; first < count; first += 4) {
+		size_t blockCount = count - first < 4 ? count - first : 4;
+		composeBlockSSE2(components, first, blockCount, out + first * 16);
+	}
+}
+
+// out kolona j = a * b[j]; b se ucita cela pre upisa, pa out sme da bude b
+static inline void multiplyMatrixSSE2(__m128 a0, __m128 a1, __m128 a2, __m128 a3, const float* b, float* out) {
+	__m128 columns[4] = { _mm_loadu_ps(b), _mm_loadu_ps(b + 4), _mm_loadu_ps(b + 8), _mm_loadu_ps(b + 12) };
+	for (int j = 0; j < 4; j++) {
+		__m128 bj = columns[j];
+		__m128 r = _mm_mul_ps(a0, _mm_shuffle_ps(bj, bj, _MM_SHUFFLE(0, 0, 0, 0)));
+		r = _mm_add_ps(r, _mm_mul_ps(a1, _mm_shuffle_ps(bj, bj, _MM_SHUFFLE(1, 1, 1, 1))));
+		r = _mm_add_ps(r, _mm_mul_ps(a2, _mm_shuffle_ps(bj, bj, _MM_SHUFFLE(2, 2, 2, 2))));
+		r = _mm_add_ps(r, _mm_mul_ps(a3, _mm_shuffle_ps(bj, bj, _MM_SHUFFLE(3, 3, 3, 3))));
+		_mm_storeu_ps(out + j * 4, r);
+	}
+}
+
+static void multiplyPairsSSE2(const float* left, const float* right, float* out, size_t count) {
+	for (size_t i = 0; i < count; i++) {
+		const float* a = left + i * 16;
+		multiplyMatrixSSE2(_mm_loadu_ps(a), _mm_loadu_ps(a + 4), _mm_loadu_ps(a + 8), _mm_loadu_ps(a + 12), right + i * 16, out + i * 16);
+	}
+}
+
+static void multiplyByOneSSE2(const float* left, const float* right, float* out, size_t count) {
+	__m128 a0 = _mm_loadu_ps(left), a1 = _mm_loadu_ps(left + 4), a2 = _mm_loadu_ps(left + 8), a3 = _mm_loadu_ps(left + 12);
+	for (size_t i = 0; i < count; i++) {
+		multiplyMatrixSSE2(a0, a1, a2, a3, right + i * 16, out + i * 16);
+	}
+}
+
+static void multiplyHierarchySSE2(const int* parents, const float* locals, float* worlds, size_t first, size_t count) {
+	for (size_t i = first; i < first + count; i++) {
+		if (parents[i] < 0) {
+			memcpy(worlds + i * 16, locals + i * 16, 16 * sizeof(float));
+			continue;
+		}
+		const float* a = worlds + parents[i] * 16;
+		multiplyMatrixSSE2(_mm_loadu_ps(a), _mm_loadu_ps(a + 4), _mm_loadu_ps(a + 8), _mm_loadu_ps(a + 12), locals + i * 16, worlds + i * 16);
+	}
+}
+
+// (y, z, x) permutacija za vektorski proizvod: a x b = (a * b.yzx - a.yzx * b).yzx
+static inline __m128 yzx(__m128 v) {
+	return _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 0, 2, 1));
+}
+
+static inline __m128 crossSSE2(__m128 a, __m128 b) {
+	return yzx(_mm_sub_ps(_mm_mul_ps(a, yzx(b)), _mm_mul_ps(yzx(a), b)));
+}
+
+static inline void storeVec3SSE2(float* out, __m128 v) {
+	_mm_storel_pi(reinterpret_cast<__m64*>(out), v);
+	_mm_store_ss(out + 2, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2)));
+}
+
+static void normalMatricesSSE2(const float* matrices, float* out, size_t count) {
+	for (size_t i = 0; i < count; i++) {
+		const float* m = matrices + i * 16;
+		__m128 a = _mm_loadu_ps(m), b = _mm_loadu_ps(m + 4), c = _mm_loadu_ps(m + 8);
+		__m128 bc = crossSSE2(b, c), ca = crossSSE2(c, a), ab = crossSSE2(a, b);
+
+		// det = dot(a, b x c), samo x, y, z, u svim lane-ovima
+		__m128 product = _mm_mul_ps(a, bc);
+		__m128 determinant = _mm_add_ps(_mm_add_ps(_mm_shuffle_ps(product, product, _MM_SHUFFLE(0, 0, 0, 0)),
+			_mm_shuffle_ps(product, product, _MM_SHUFFLE(1, 1, 1, 1))), _mm_shuffle_ps(product, product, _MM_SHUFFLE(2, 2, 2, 2)));
+		__m128 inverseDeterminant = _mm_div_ps(_mm_set1_ps(1.0f), determinant);
+
+		// svaka kolona upise 4 float-a, cetvrti pregazi sledeca kolona; poslednja upisuje tacno 3
+		float* n = out + i * 9;
+		_mm_storeu_ps(n, _mm_mul_ps(bc, inverseDeterminant));
+		_mm_storeu_ps(n + 3, _mm_mul_ps(ca, inverseDeterminant));
+		storeVec3SSE2(n + 6, _mm_mul_ps(ab, inverseDeterminant));
+	}
+}
+
+static const TransformKernelTable sse2Kernels = {
+	"sse2",
+	composeTRSSSE2,
+	multiplyPairsSSE2,
+	multiplyByOneSSE2,
+	multiplyHierarchySSE2,
+	normalMatricesSSE2
+};
+
+#endif
+
+// AVX2 i FMA moraju da postoje i u procesoru i u OS-u (XSAVE cuva ymm registre)
+static bool cpuSupportsAVX2() {
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+	int info[4];
+	__cpuid(info, 0);
+	if (info[0] < 7) return false;
+
+	__cpuid(info, 1);
+	bool fma = (info[2] & (1 << 12)) != 0;
+	bool osxsave = (info[2] & (1 << 27)) != 0;
+	if (!fma || !osxsave) return false;
+	if ((_xgetbv(0) & 0x6) != 0x6) return false;
+
+	__cpuidex(info, 7, 0);
+	return (info[1] & (1 << 5)) != 0;
+#else
+	return false;
+#endif
+}
+
+static const TransformKernelTable* kernelsByName(const char* name) {
+	if (strcmp(name, "avx2") == 0) {
+		return cpuSupportsAVX2() ? avx2TransformKernels() : nullptr;
+	}
+#ifdef TRANSFORM_KERNELS_SSE2
+	if (strcmp(name, "sse2") == 0) return &sse2Kernels;
+#endif
+	if (strcmp(name, "scalar") == 0) return &scalarKernels;
+	return nullptr;
+}
+
+const TransformKernelTable*& TransformKernels::current() {
+	static const TransformKernelTable* kernels = []() {
+		const char* preferred[] = { "avx2", "sse2", "scalar" };
+		for (const char* name : preferred) {
+			const TransformKernelTable* table = kernelsByName(name);
+			if (table) return table;
+		}
+		return &scalarKernels;
+	}();
+	return kernels;
+}
+
+bool TransformKernels::selectKernels(const char* name) {
+	const TransformKernelTable* table = kernelsByName(name);
+	if (!table) return false;
+	current() = table;
+	return true;
+}
@@ -0,0 +1,111 @@
+#ifndef _MOJ_TRANSFORM_KERNELS_H_
+#define _MOJ_TRANSFORM_KERNELS_H_
+
+#include "glm/glm.hpp"
+#include "glm/gtc/quaternion.hpp"
+
+#include <cstddef>
+#include <vector>
+
+// Translacija, rotacija i skala N elemenata, svaka komponenta u svom nizu (structure of arrays),
+// tako da SIMD kernel ucita 4 ili 8 elemenata jednim load-om.
+struct TransformSoA {
+	std::vector<float> positionX, positionY, positionZ;
+	std::vector<float> rotationX, rotationY, rotationZ, rotationW;
+	std::vector<float> scaleX, scaleY, scaleZ;
+
+	size_t size() const { return positionX.size(); }
+
+	// new elements are identity transforms
+	void resize(size_t count);
+
+	void set(size_t index, const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale);
+
+	void setPosition(size_t index, const glm::vec3& position);
+
+	void setRotation(size_t index, const glm::quat& rotation);
+};
+
+// Funkcije jednog skupa kernela, nad golim float nizovima da AVX2 fajl ne bi instancirao glm/std sablone.
+// mat4 je 16 float-ova (column-major kao glm), mat3 9. Izlaz sme da bude isti niz kao desni ulaz.
+// components: positionX..Z, rotationX..W, scaleX..Z, redom kao u TransformSoA.
+struct TransformKernelTable {
+	const char* name;
+
+	void (*composeTRS)(const float* const* components, size_t count, float* out);
+
+	void (*multiplyPairs)(const float* left, const float* right, float* out, size_t count);
+
+	void (*multiplyByOne)(const float* left, const float* right, float* out, size_t count);
+
+	void (*multiplyHierarchy)(const int* parents, const float* locals, float* worlds, size_t first, size_t count);
+
+	void (*normalMatrices)(const float* matrices, float* out, size_t count);
+};
+
+// Batch transform math for scene-graph nodes and instance matrices.
+// Kernel set (avx2, sse2 or scalar) is picked once at startup from the CPU's features.
+class TransformKernels {
+public:
+
+	// out[i] = translate(position) * toMat4(rotation) * scale(scale)
+	static void composeTRS(const TransformSoA& transforms, glm::mat4* out) {
+		const float* components[10] = {
+			transforms.positionX.data(), transforms.positionY.data(), transforms.positionZ.data(),
+			transforms.rotationX.data(), transforms.rotationY.data(), transforms.rotationZ.data(), transforms.rotationW.data(),
+			transforms.scaleX.data(), transforms.scaleY.data(), transforms.scaleZ.data()
+		};
+		active().composeTRS(components, transforms.size(), floats(out));
+	}
+
+	// out[i] = left[i] * right[i]
+	static void multiply(const glm::mat4* left, const glm::mat4* right, glm::mat4* out, size_t count) {
+		active().multiplyPairs(floats(left), floats(right), floats(out), count);
+	}
+
+	// out[i] = left * right[i], npr. view * model za sve instance
+	static void multiply(const glm::mat4& left, const glm::mat4* right, glm::mat4* out, size_t count) {
+		active().multiplyByOne(floats(&left), floats(right), floats(out), count);
+	}
+
+	// worlds[i] = worlds[parents[i]] * locals[i], or locals[i] for parents[i] < 0.
+	// Roditelj mora da bude pre deteta (depth-first redosled).
+	static void multiplyHierarchy(const int* parents, const glm::mat4* locals, glm::mat4* worlds, size_t count) {
+		active().multiplyHierarchy(parents, floats(locals), floats(worlds), 0, count);
+	}
+
+	// Isto, samo za cvorove [first, first + count), npr. jedno podstablo.
+	// Roditelji pre first moraju vec da imaju ispravne world matrice.
+	static void multiplyHierarchy(const int* parents, const glm::mat4* locals, glm::mat4* worlds, size_t first, size_t count) {
+		active().multiplyHierarchy(parents, floats(locals), floats(worlds), first, count);
+	}
+
+	// out[i] = transpose(inverse(mat3(matrices[i]))), normal matrix koja podnosi neuniformnu skalu
+	static void normalMatrices(const glm::mat4* matrices, glm::mat3* out, size_t count) {
+		active().normalMatrices(floats(matrices), floats(out), count);
+	}
+
+	static const char* kernelName() { return active().name; }
+
+	// Switches to "avx2", "sse2" or "scalar" (used by the microbenchmark).
+	// false ako procesor taj skup ne podrzava; aktivni skup se tada ne menja.
+	static bool selectKernels(const char* name);
+
+private:
+
+	// glm matrice su gusto spakovani float-ovi
+	template <typename Matrix>
+	static const float* floats(const Matrix* matrices) { return reinterpret_cast<const float*>(matrices); }
+
+	template <typename Matrix>
+	static float* floats(Matrix* matrices) { return reinterpret_cast<float*>(matrices); }
+
+	static const TransformKernelTable*& current();
+
+	static const TransformKernelTable& active() {
+		return *current();
+	}
+
+};
+
+#endif
@@ -0,0 +1,216 @@
+// AVX2 + FMA kerneli. Ovaj fajl se jedini kompajlira sa -mavx2 -mfma (/arch:AVX2), a poziva se
+// samo kad TransformKernels na procesoru pronadje AVX2 i FMA.
+
+#include "TransformKernels.h"
+
+#include <cstring>
+
+#ifdef __AVX2__
+
+#include <immintrin.h>
+
+// 8 registara sa po 8 elemenata -> 8 registara sa po 8 komponenti jednog elementa
+static inline void transpose8(__m256& r0, __m256& r1, __m256& r2, __m256& r3, __m256& r4, __m256& r5, __m256& r6, __m256& r7) {
+	__m256 t0 = _mm256_unpacklo_ps(r0, r1), t1 = _mm256_unpackhi_ps(r0, r1);
+	__m256 t2 = _mm256_unpacklo_ps(r2, r3), t3 = _mm256_unpackhi_ps(r2, r3);
+	__m256 t4 = _mm256_unpacklo_ps(r4, r5), t5 = _mm256_unpackhi_ps(r4, r5);
+	__m256 t6 = _mm256_unpacklo_ps(r6, r7), t7 = _mm256_unpackhi_ps(r6, r7);
+
+	__m256 s0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0)), s1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+	__m256 s2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0)), s3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+	__m256 s4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0)), s5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+	__m256 s6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0)), s7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+
+	r0 = _mm256_permute2f128_ps(s0, s4, 0x20);
+	r1 = _mm256_permute2f128_ps(s1, s5, 0x20);
+	r2 = _mm256_permute2f128_ps(s2, s6, 0x20);
+	r3 = _mm256_permute2f128_ps(s3, s7, 0x20);
+	r4 = _mm256_permute2f128_ps(s0, s4, 0x31);
+	r5 = _mm256_permute2f128_ps(s1, s5, 0x31);
+	r6 = _mm256_permute2f128_ps(s2, s6, 0x31);
+	r7 = _mm256_permute2f128_ps(s3, s7, 0x31);
+}
+
+enum { POSITION_X, POSITION_Y, POSITION_Z, ROTATION_X, ROTATION_Y, ROTATION_Z, ROTATION_W, SCALE_X, SCALE_Y, SCALE_Z, COMPONENT_COUNT };
+
+static inline void composeBlockAVX2(const float* const* components, size_t first, size_t count, float* out) {
+	// poslednji, nepotpuni blok se dopuni identitetom
+	static const float padding[COMPONENT_COUNT] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f };
+	__m256 v[COMPONENT_COUNT];
+	for (int k = 0; k < COMPONENT_COUNT; k++) {
+		if (count == 8) {
+			v[k] = _mm256_loadu_ps(components[k] + first);
+		}
+		else {
+			float lanes[8];
+			for (size_t lane = 0; lane < 8; lane++) lanes[lane] = lane < count ? components[k][first + lane] : padding[k];
+			v[k] = _mm256_loadu_ps(lanes);
+		}
+	}
+
+	__m256 x = v[ROTATION_X], y = v[ROTATION_Y], z = v[ROTATION_Z], w = v[ROTATION_W];
+	__m256 one = _mm256_set1_ps(1.0f), two = _mm256_set1_ps(2.0f), zero = _mm256_setzero_ps();
+	__m256 xx = _mm256_mul_ps(x, x), yy = _mm256_mul_ps(y, y), zz = _mm256_mul_ps(z, z);
+	__m256 xy = _mm256_mul_ps(x, y), xz = _mm256_mul_ps(x, z), yz = _mm256_mul_ps(y, z);
+	__m256 wx = _mm256_mul_ps(w, x), wy = _mm256_mul_ps(w, y), wz = _mm256_mul_ps(w, z);
+
+	// prve dve kolone svih 8 matrica, pa druge dve
+	__m256 low[8] = {
+		_mm256_mul_ps(_mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(yy, zz))), v[SCALE_X]),
+		_mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(xy, wz)), v[SCALE_X]),
+		_mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(xz, wy)), v[SCALE_X]),
+		zero,
+		_mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(xy, wz)), v[SCALE_Y]),
+		_mm256_mul_ps(_mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(xx, zz))), v[SCALE_Y]),
+		_mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(yz, wx)), v[SCALE_Y]),
+		zero
+	};
+	__m256 high[8] = {
+		_mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(xz, wy)), v[SCALE_Z]),
+		_mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(yz, wx)), v[SCALE_Z]),
+		_mm256_mul_ps(_mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(xx, yy))), v[SCALE_Z]),
+		zero,
+		v[POSITION_X], v[POSITION_Y], v[POSITION_Z], one
+	};
+
+	transpose8(low[0], low[1], low[2], low[3], low[4], low[5], low[6], low[7]);
+	transpose8(high[0], high[1], high[2], high[3], high[4], high[5], high[6], high[7]);
+
+	float block[8 * 16];
+	float* target = count == 8 ? out : block;
+	for (int element = 0; element < 8; element++) {
+		_mm256_storeu_ps(target + element * 16, low[element]);
+		_mm256_storeu_ps(target + element * 16 + 8, high[element]);
+	}
+	if (count != 8) memcpy(out, block, count * 16 * sizeof(float));
+}
+
+static void composeTRSAVX2(const float* const* components, size_t count, float* out) {
+	for (size_t first = 0; first < count; first += 8) {
+		size_t blockCount = count - first < 8 ? count - first : 8;
+		composeBlockAVX2(components, first, blockCount, out + first * 16);
+	}
+}
+
+// Dve kolone rezultata po registru; aN sadrzi kolonu N leve matrice u obe polovine.
+// b se ucita cela pre upisa, pa out sme da bude b.
+static inline void multiplyMatrixAVX2(__m256 a0, __m256 a1, __m256 a2, __m256 a3, const float* b, float* out) {
+	__m256 columns[2] = { _mm256_loadu_ps(b), _mm256_loadu_ps(b + 8) };
+	__m256 results[2];
+	for (int j = 0; j < 2; j++) {
+		__m256 bj = columns[j];
+		__m256 r = _mm256_mul_ps(a0, _mm256_permute_ps(bj, _MM_SHUFFLE(0, 0, 0, 0)));
+		r = _mm256_fmadd_ps(a1, _mm256_permute_ps(bj, _MM_SHUFFLE(1, 1, 1, 1)), r);
+		r = _mm256_fmadd_ps(a2, _mm256_permute_ps(bj, _MM_SHUFFLE(2, 2, 2, 2)), r);
+		r = _mm256_fmadd_ps(a3, _mm256_permute_ps(bj, _MM_SHUFFLE(3, 3, 3, 3)), r);
+		results[j] = r;
+	}
+	_mm256_storeu_ps(out, results[0]);
+	_mm256_storeu_ps(out + 8, results[1]);
+}
+
+static inline void loadLeftAVX2(const float* a, __m256& a0, __m256& a1, __m256& a2, __m256& a3) {
+	a0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(a));
+	a1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(a + 4));
+	a2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(a + 8));
+	a3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(a + 12));
+}
+
+static void multiplyPairsAVX2(const float* left, const float* right, float* out, size_t count) {
+	for (size_t i = 0; i < count; i++) {
+		__m256 a0, a1, a2, a3;
+		loadLeftAVX2(left + i * 16, a0, a1, a2, a3);
+		multiplyMatrixAVX2(a0, a1, a2, a3, right + i * 16, out + i * 16);
+	}
+}
+
+static void multiplyByOneAVX2(const float* left, const float* right, float* out, size_t count) {
+	__m256 a0, a1, a2, a3;
+	loadLeftAVX2(left, a0, a1, a2, a3);
+	for (size_t i = 0; i < count; i++) {
+		multiplyMatrixAVX2(a0, a1, a2, a3, right + i * 16, out + i * 16);
+	}
+}
+
+static void multiplyHierarchyAVX2(const int* parents, const float* locals, float* worlds, size_t first, size_t count) {
+	for (size_t i = first; i < first + count; i++) {
+		if (parents[i] < 0) {
+			memcpy(worlds + i * 16, locals + i * 16, 16 * sizeof(float));
+			continue;
+		}
+		__m256 a0, a1, a2, a3;
+		loadLeftAVX2(worlds + parents[i] * 16, a0, a1, a2, a3);
+		multiplyMatrixAVX2(a0, a1, a2, a3, locals + i * 16, worlds + i * 16);
+	}
+}
+
+// (y, z, x) u svakoj 128-bitnoj polovini
+static inline __m256 yzx(__m256 v) {
+	return _mm256_permute_ps(v, _MM_SHUFFLE(3, 0, 2, 1));
+}
+
+static inline __m256 crossAVX2(__m256 a, __m256 b) {
+	return yzx(_mm256_fmsub_ps(a, yzx(b), _mm256_mul_ps(yzx(a), b)));
+}
+
+static inline __m256 loadColumnPair(const float* first, const float* second, int column) {
+	return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(first + column * 4)), _mm_loadu_ps(second + column * 4), 1);
+}
+
+static inline void storeVec3(float* out, __m128 v) {
+	_mm_storel_pi(reinterpret_cast<__m64*>(out), v);
+	_mm_store_ss(out + 2, _mm_movehl_ps(v, v));
+}
+
+// Dve matrice po koraku, po jedna u svakoj polovini registra.
+static void normalMatricesAVX2(const float* matrices, float* out, size_t count) {
+	for (size_t i = 0; i < count; i += 2) {
+		const float* first = matrices + i * 16;
+		const float* second = i + 1 < count ? first + 16 : first;
+
+		__m256 a = loadColumnPair(first, second, 0), b = loadColumnPair(first, second, 1), c = loadColumnPair(first, second, 2);
+		__m256 bc = crossAVX2(b, c), ca = crossAVX2(c, a), ab = crossAVX2(a, b);
+
+		// det = dot(a, b x c) u x, y, z svake polovine
+		__m256 product = _mm256_mul_ps(a, bc);
+		__m256 determinant = _mm256_add_ps(_mm256_add_ps(_mm256_permute_ps(product, _MM_SHUFFLE(0, 0, 0, 0)),
+			_mm256_permute_ps(product, _MM_SHUFFLE(1, 1, 1, 1))), _mm256_permute_ps(product, _MM_SHUFFLE(2, 2, 2, 2)));
+		__m256 inverseDeterminant = _mm256_div_ps(_mm256_set1_ps(1.0f), determinant);
+
+		bc = _mm256_mul_ps(bc, inverseDeterminant);
+		ca = _mm256_mul_ps(ca, inverseDeterminant);
+		ab = _mm256_mul_ps(ab, inverseDeterminant);
+
+		// svaka kolona upise 4 float-a, cetvrti pregazi sledeca kolona; poslednja upisuje tacno 3
+		float* n = out + i * 9;
+		_mm_storeu_ps(n, _mm256_castps256_ps128(bc));
+		_mm_storeu_ps(n + 3, _mm256_castps256_ps128(ca));
+		storeVec3(n + 6, _mm256_castps256_ps128(ab));
+		if (i + 1 < count) {
+			_mm_storeu_ps(n + 9, _mm256_extractf128_ps(bc, 1));
+			_mm_storeu_ps(n + 12, _mm256_extractf128_ps(ca, 1));
+			storeVec3(n + 15, _mm256_extractf128_ps(ab, 1));
+		}
+	}
+}
+
+static const TransformKernelTable kernels = {
+	"avx2",
+	composeTRSAVX2,
+	multiplyPairsAVX2,
+	multiplyByOneAVX2,
+	multiplyHierarchyAVX2,
+	normalMatricesAVX2
+};
+
+const TransformKernelTable* avx2TransformKernels() {
+	return &kernels;
+}
+
+#else
+
+const TransformKernelTable* avx2TransformKernels() {
+	return nullptr;
+}
+
+#endif
@@ -0,0 +1,95 @@
+#include "VertexPacking.h"
+#include "Mesh.h"
+
+#include <cmath>
+#include <cstring>
+
+PositionQuantization PositionQuantization::fromBounds(const AABB& bounds) {
+	PositionQuantization quantization;
+	if (bounds.empty()) return quantization;
+
+	quantization.offset = bounds.min;
+	// ravan mesh ima nultu debljinu po jednoj osi; bilo koja skala daje isti rezultat
+	quantization.scale = glm::max(bounds.max - bounds.min, glm::vec3(1e-12f));
+	return quantization;
+}
+
+uint16_t floatToHalf(float value) {
+	uint32_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+
+	uint32_t sign = (bits >> 16) & 0x8000u;
+	uint32_t exponent = (bits >> 23) & 0xFFu;
+	uint32_t mantissa = bits & 0x7FFFFFu;
+
+	// inf i NaN
+	if (exponent == 0xFFu) {
+		return (uint16_t)(sign | 0x7C00u | (mantissa ? 0x200u : 0u));
+	}
+
+	int halfExponent = (int)exponent - 127 + 15;
+	if (halfExponent >= 31) {
+		return (uint16_t)(sign | 0x7C00u);
+	}
+
+	if (halfExponent <= 0) {
+		// denormal ili nula
+		if (halfExponent < -10) return (uint16_t)sign;
+		mantissa |= 0x800000u;
+		uint32_t shift = (uint32_t)(14 - halfExponent);
+		uint32_t half = mantissa >> shift;
+		uint32_t rest = mantissa & ((1u << shift) - 1);
+		uint32_t halfway = 1u << (shift - 1);
+		if (rest > halfway || (rest == halfway && (half & 1u))) half++;
+		return (uint16_t)(sign | half);
+	}
+
+	uint32_t half = ((uint32_t)halfExponent << 10) | (mantissa >> 13);
+	uint32_t rest = mantissa & 0x1FFFu;
+	// prenos iz mantise u eksponent je ispravan i za prelazak u inf
+	if (rest > 0x1000u || (rest == 0x1000u && (half & 1u))) half++;
+	return (uint16_t)(sign | half);
+}
+
+glm::vec2 octahedralEncode(const glm::vec3& normal) {
+	float length = std::fabs(normal.x) + std::fabs(normal.y) + std::fabs(normal.z);
+	if (length == 0.0f) return glm::vec2(0.0f);
+
+	glm::vec2 p = glm::vec2(normal.x, normal.y) / length;
+	if (normal.z < 0.0f) {
+		// donja polusfera se preklapa preko dijagonala
+		glm::vec2 sign(p.x >= 0.0f ? 1.0f : -1.0f, p.y >= 0.0f ? 1.0f : -1.0f);
+		p = (glm::vec2(1.0f) - glm::abs(glm::vec2(p.y, p.x))) * sign;
+	}
+	return p;
+}
+
+static uint16_t toUnorm16(float value) {
+	return (uint16_t)std::lround(glm::clamp(value, 0.0f, 1.0f) * 65535.0f);
+}
+
+static int16_t toSnorm16(float value) {
+	return (int16_t)std::lround(glm::clamp(value, -1.0f, 1.0f) * 32767.0f);
+}
+
+void packVertices(const Vertex* vertices, size_t count, const PositionQuantization& quantization, PackedVertex* out) {
+	glm::vec3 inverseScale = glm::vec3(1.0f) / quantization.scale;
+
+	for (size_t i = 0; i < count; i++) {
+		const Vertex& vertex = vertices[i];
+		PackedVertex& packed = out[i];
+
+		glm::vec3 position = (vertex.Position - quantization.offset) * inverseScale;
+		packed.position[0] = toUnorm16(position.x);
+		packed.position[1] = toUnorm16(position.y);
+		packed.position[2] = toUnorm16(position.z);
+		packed.position[3] = 0;
+
+		glm::vec2 normal = octahedralEncode(vertex.Normal);
+		packed.normal[0] = toSnorm16(normal.x);
+		packed.normal[1] = toSnorm16(normal.y);
+
+		packed.texCoords[0] = floatToHalf(vertex.TexCoords.x);
+		packed.texCoords[1] = floatToHalf(vertex.TexCoords.y);
+	}
+}
@@ -0,0 +1,42 @@
+#ifndef _MOJ_VERTEX_PACKING_H_
+#define _MOJ_VERTEX_PACKING_H_
+
+#include "glm/glm.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+#include "Bounds.h"
+
+// Kompaktan verteks, 16 bajtova umesto 32:
+//  - pozicija kao 16-bit unorm unutar kutije (PositionQuantization), [3] je samo poravnanje
+//  - normala octahedral kodirana u dva 16-bit snorm broja
+//  - tex. koordinate kao half float
+// Shader (lighting.vs, PACKED_VERTICES) vraca poziciju i normalu; UV GL sam pretvara iz half float-a.
+struct PackedVertex {
+	uint16_t position[4];
+	int16_t normal[2];
+	uint16_t texCoords[2];
+};
+
+static_assert(sizeof(PackedVertex) == 16, "PackedVertex must stay tightly packed");
+
+// pozicija = offset + unorm * scale
+struct PositionQuantization {
+	glm::vec3 offset = glm::vec3(0.0f);
+	glm::vec3 scale = glm::vec3(1.0f);
+
+	static PositionQuantization fromBounds(const AABB& bounds);
+};
+
+// IEEE half float, zaokruzeno na najblizi (ties to even), sa denormalima i inf/NaN
+uint16_t floatToHalf(float value);
+
+// Octahedral mapping of a unit vector to [-1, 1]^2 (the inverse is in lighting.vs).
+glm::vec2 octahedralEncode(const glm::vec3& normal);
+
+struct Vertex;
+
+void packVertices(const Vertex* vertices, size_t count, const PositionQuantization& quantization, PackedVertex* out);
+
+#endif
@@ -0,0 +1,371 @@
+// Headless frame-time benchmark.
+// Renders maps 1/2/3 offscreen along a fixed camera path with a fixed timestep
+// and prints per-map frame time percentiles, draw calls and startup time as JSON.
+//
+//   bench [--frames N] [--warmup N] [--width W] [--height H] [--maps 1,2,3]
+//         [--assets DIR] [--out FILE] [--capture PREFIX] [--raw-textures] [--texture-budget MB] [--lights N] [--deferred]
+//         [--no-program-cache]
+//
+// --capture writes the last frame of every map as PREFIX<map>.ppm, for eyeballing A/B changes.
+// --raw-textures uploads textures uncompressed (A/B against BCn); their levels get their own .raw KTX2 files.
+// --texture-budget caps resident texture memory; TextureCache evicts least recently used textures over it.
+// --lights sets the number of point lights on map 1 (28 by default), for the clustered lighting.
+// --deferred renders through the G-buffer and a full-screen lighting pass instead of forward shading.
+// --no-program-cache compiles every shader program instead of loading linked binaries from cache/.
+
+#include "glad/glad.h"
+#include "glm/glm.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <direct.h>
+#define chdir _chdir
+#else
+#include <unistd.h>
+#endif
+
+#include "HeadlessContext.h"
+#include "Camera.h"
+#include "Scene.h"
+#include "Shader.h"
+#include "RenderStats.h"
+#include "TextureCache.h"
+#include "TextureLoader.h"
+
+#ifndef OPENGL_DEMO_ASSET_DIR
+#define OPENGL_DEMO_ASSET_DIR "."
+#endif
+
+typedef std::chrono::steady_clock Clock;
+
+struct BenchSettings {
+	int frames = 600;
+	int warmup = 60;
+	int width = 1280;
+	int height = 720;
+	std::vector<int> maps = { 1, 2, 3 };
+	std::string assets = OPENGL_DEMO_ASSET_DIR;
+	std::string out;
+	std::string capture;
+	bool rawTextures = false;
+	bool noProgramCache = false;
+	// 0 = bez ogranicenja
+	double textureBudgetMB = 0.0;
+	// point svetla na mapi 1, najmanje 28
+	int lights = 28;
+	RenderPath renderPath = RenderPath::Forward;
+};
+
+struct MapResult {
+	int map;
+	std::vector<double> frameTimes;
+	double drawCalls;
+	double triangles;
+	double meshesDrawn;
+	double meshesCulled;
+	double programChanges;
+	double textureBinds;
+	double vaoBinds;
+	double pointLights;
+	double clusterLightIndices;
+};
+
+static double millisecondsSince(Clock::time_point start) {
+	return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// nearest-rank percentile, sorted must be sorted ascending
+static double percentile(const std::vector<double>& sorted, double p) {
+	if (sorted.empty()) return 0.0;
+	size_t rank = static_cast<size_t>(p / 100.0 * sorted.size() + 0.5);
+	rank = std::min(std::max<size_t>(rank, 1), sorted.size());
+	return sorted[rank - 1];
+}
+
+static bool parseArguments(int argc, char** argv, BenchSettings& settings) {
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		bool hasValue = i + 1 < argc;
+
+		if (arg == "--frames" && hasValue) {
+			settings.frames = std::max(1, atoi(argv[++i]));
+		}
+		else if (arg == "--warmup" && hasValue) {
+			settings.warmup = std::max(0, atoi(argv[++i]));
+		}
+		else if (arg == "--width" && hasValue) {
+			settings.width = std::max(1, atoi(argv[++i]));
+		}
+		else if (arg == "--height" && hasValue) {
+			settings.height = std::max(1, atoi(argv[++i]));
+		}
+		else if (arg == "--maps" && hasValue) {
+			settings.maps.clear();
+			std::stringstream list(argv[++i]);
+			std::string item;
+			while (std::getline(list, item, ',')) {
+				int map = atoi(item.c_str());
+				if (map >= 1 && map <= 3) settings.maps.push_back(map);
+			}
+		}
+		else if (arg == "--assets" && hasValue) {
+			settings.assets = argv[++i];
+		}
+		else if (arg == "--out" && hasValue) {
+			settings.out = argv[++i];
+		}
+		else if (arg == "--capture" && hasValue) {
+			settings.capture = argv[++i];
+		}
+		else if (arg == "--raw-textures") {
+			settings.rawTextures = true;
+		}
+		else if (arg == "--texture-budget" && hasValue) {
+			settings.textureBudgetMB = std::max(0.0, atof(argv[++i]));
+		}
+		else if (arg == "--lights" && hasValue) {
+			settings.lights = atoi(argv[++i]);
+		}
+		else if (arg == "--deferred") {
+			settings.renderPath = RenderPath::Deferred;
+		}
+		else if (arg == "--no-program-cache") {
+			settings.noProgramCache = true;
+		}
+		else {
+			std::cerr << "Unknown argument: " << arg << std::endl;
+			std::cerr << "usage: bench [--frames N] [--warmup N] [--width W] [--height H] [--maps 1,2,3] [--assets DIR] [--out FILE] [--capture PREFIX] [--raw-textures] [--texture-budget MB] [--lights N] [--deferred] [--no-program-cache]" << std::endl;
+			return false;
+		}
+	}
+	return !settings.maps.empty();
+}
+
+// Fixed camera path: slow orbit around the interesting part of each map.
+static void placeCamera(Camera& camera, int map, float time) {
+	float angle = time * 0.25f;
+	if (map == 1) {
+		// helix ide od y = -30 do y = 20
+		glm::vec3 target = glm::vec3(0.0f, -5.0f, 0.0f);
+		camera.lookAt(target + glm::vec3(28.0f * sin(angle), 4.0f, 28.0f * cos(angle)), target);
+	}
+	else {
+		glm::vec3 target = glm::vec3(0.0f, 0.0f, 0.0f);
+		camera.lookAt(target + glm::vec3(12.0f * sin(angle), 3.0f, 12.0f * cos(angle)), target);
+	}
+}
+
+static void renderFrame(Scene& scene, Camera& camera, const HeadlessContext& context, int map, float time) {
+	RenderStats::getInstance().reset();
+	placeCamera(camera, map, time);
+
+	glBindFramebuffer(GL_FRAMEBUFFER, context.framebuffer());
+	glClearColor(0.2f, 0, 0, 1);
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+	scene.draw(map, camera, time, context.width(), context.height(), false, false);
+
+	// glFinish da bi u vreme frame-a usao i GPU, ne samo predaja komandi
+	glFinish();
+}
+
+static void captureFrame(const HeadlessContext& context, const std::string& path) {
+	int width = context.width();
+	int height = context.height();
+	std::vector<unsigned char> pixels(width * height * 3);
+
+	glBindFramebuffer(GL_FRAMEBUFFER, context.framebuffer());
+	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+	glReadPixels(0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, pixels.data());
+
+	std::ofstream file(path, std::ios::binary);
+	file << "P6\n" << width << " " << height << "\n255\n";
+	// OpenGL cita odozdo nagore
+	for (int y = height - 1; y >= 0; y--) {
+		file.write(reinterpret_cast<const char*>(&pixels[y * width * 3]), width * 3);
+	}
+}
+
+static void writeReport(std::ostream& out, const BenchSettings& settings, const std::string& renderer,
+	double contextMs, double sceneLoadMs, double startupMs, double assetsReadyMs, std::vector<MapResult>& results) {
+
+	const double timestep = 1.0 / 60.0;
+
+	out << "{\n";
+	out << "  \"renderer\": \"" << renderer << "\",\n";
+	out << "  \"render_path\": \"" << (settings.renderPath == RenderPath::Deferred ? "deferred" : "forward") << "\",\n";
+	out << "  \"width\": " << settings.width << ",\n";
+	out << "  \"height\": " << settings.height << ",\n";
+	out << "  \"frames\": " << settings.frames << ",\n";
+	out << "  \"warmup_frames\": " << settings.warmup << ",\n";
+	out << "  \"timestep_s\": " << timestep << ",\n";
+	out << "  \"startup_ms\": { \"context\": " << contextMs << ", \"scene_load\": " << sceneLoadMs
+		<< ", \"first_frame\": " << startupMs << ", \"assets_ready\": " << assetsReadyMs << " },\n";
+	const TextureMemoryStats& textures = textureMemoryStats();
+	out << "  \"textures\": { \"count\": " << textures.textures << ", \"compressed\": " << textures.compressed
+		<< ", \"bytes\": " << textures.bytes << " },\n";
+	const ProgramCacheStats& programs = Shader::programCacheStats();
+	out << "  \"programs\": { \"compiled\": " << programs.compiled << ", \"cached\": " << programs.cached
+		<< ", \"rejected\": " << programs.rejected << " },\n";
+	const TextureCache& textureCache = TextureCache::getInstance();
+	out << "  \"texture_residency\": { \"budget_bytes\": " << textureCache.memoryBudget()
+		<< ", \"resident_bytes\": " << textureCache.residentBytes() << ", \"peak_resident_bytes\": " << textureCache.peakResidentBytes()
+		<< ", \"evictions\": " << textureCache.evictions() << ", \"reloads\": " << textureCache.reloads() << " },\n";
+	out << "  \"maps\": [\n";
+
+	for (size_t i = 0; i < results.size(); i++) {
+		MapResult& result = results[i];
+		std::vector<double> sorted = result.frameTimes;
+		std::sort(sorted.begin(), sorted.end());
+
+		double sum = 0.0;
+		for (double t : sorted) sum += t;
+
+		out << "    { \"map\": " << result.map
+			<< ", \"frame_ms\": { \"p50\": " << percentile(sorted, 50.0)
+			<< ", \"p95\": " << percentile(sorted, 95.0)
+			<< ", \"p99\": " << percentile(sorted, 99.0)
+			<< ", \"mean\": " << sum / sorted.size()
+			<< ", \"max\": " << sorted.back() << " }"
+			<< ", \"draw_calls\": " << result.drawCalls
+			<< ", \"triangles\": " << result.triangles
+			<< ", \"meshes_drawn\": " << result.meshesDrawn
+			<< ", \"meshes_culled\": " << result.meshesCulled
+			<< ", \"state_changes\": { \"programs\": " << result.programChanges
+			<< ", \"textures\": " << result.textureBinds
+			<< ", \"vaos\": " << result.vaoBinds << " }"
+			<< ", \"point_lights\": " << result.pointLights
+			<< ", \"cluster_light_indices\": " << result.clusterLightIndices << " }"
+			<< (i + 1 < results.size() ? ",\n" : "\n");
+	}
+
+	out << "  ]\n";
+	out << "}" << std::endl;
+}
+
+int main(int argc, char** argv) {
+	Clock::time_point processStart = Clock::now();
+
+	BenchSettings settings;
+	if (!parseArguments(argc, argv, settings)) {
+		return 2;
+	}
+
+	// Loaderi pisu dnevnik na std::cout; preusmeri ga na stderr da JSON na stdout ostane cist.
+	std::ostream report(std::cout.rdbuf());
+	std::cout.rdbuf(std::cerr.rdbuf());
+
+	// --out se otvara pre chdir, da bi relativna putanja bila relativna na pozivaoca
+	std::ofstream reportFile;
+	if (!settings.out.empty()) {
+		reportFile.open(settings.out);
+		if (!reportFile) {
+			std::cerr << "Cannot open report file: " << settings.out << std::endl;
+			return 2;
+		}
+		report.rdbuf(reportFile.rdbuf());
+	}
+
+	if (!settings.capture.empty()) {
+		settings.capture = std::filesystem::absolute(settings.capture).string();
+	}
+
+	// shaderi, teksture i modeli se ucitavaju relativnim putanjama
+	if (chdir(settings.assets.c_str()) != 0) {
+		std::cerr << "Cannot enter asset directory: " << settings.assets << std::endl;
+		return 2;
+	}
+
+	setTextureCompression(!settings.rawTextures);
+	Shader::setProgramCache(!settings.noProgramCache);
+	TextureCache::getInstance().setMemoryBudget(static_cast<size_t>(settings.textureBudgetMB * 1024 * 1024));
+
+	HeadlessContext context(settings.width, settings.height);
+	if (!context.isValid()) {
+		std::cerr << "Headless OpenGL 3.3 context could not be created." << std::endl;
+		return 1;
+	}
+	double contextMs = millisecondsSince(processStart);
+
+	Clock::time_point loadStart = Clock::now();
+	Scene scene;
+	scene.setHelixLightCount(settings.lights);
+	scene.setRenderPath(settings.renderPath);
+	glFinish();
+	double sceneLoadMs = millisecondsSince(loadStart);
+
+	Camera camera(glm::vec3(0.0f, 0.0f, 10.0f), CAM_FPS);
+	const float timestep = 1.0f / 60.0f;
+
+	renderFrame(scene, camera, context, settings.maps[0], 0.0f);
+	double startupMs = millisecondsSince(processStart);
+
+	// modeli se ucitavaju u pozadini; meri se tek kad su svi gotovi, a do tada se crta kao u prozoru
+	while (!scene.isLoaded()) {
+		renderFrame(scene, camera, context, settings.maps[0], 0.0f);
+	}
+	double assetsReadyMs = millisecondsSince(processStart);
+
+	std::vector<MapResult> results;
+	for (int map : settings.maps) {
+		MapResult result;
+		result.map = map;
+		result.frameTimes.reserve(settings.frames);
+
+		unsigned long long totalDrawCalls = 0, totalTriangles = 0, totalDrawn = 0, totalCulled = 0;
+		unsigned long long totalPrograms = 0, totalTextures = 0, totalVaos = 0;
+		unsigned long long totalLights = 0, totalLightIndices = 0;
+		for (int frame = 0; frame < settings.warmup + settings.frames; frame++) {
+			float time = frame * timestep;
+
+			Clock::time_point frameStart = Clock::now();
+			renderFrame(scene, camera, context, map, time);
+			double frameMs = millisecondsSince(frameStart);
+
+			if (frame >= settings.warmup) {
+				result.frameTimes.push_back(frameMs);
+				totalDrawCalls += RenderStats::getInstance().drawCalls;
+				totalTriangles += RenderStats::getInstance().triangles;
+				totalDrawn += RenderStats::getInstance().meshesDrawn;
+				totalCulled += RenderStats::getInstance().meshesCulled;
+				totalPrograms += RenderStats::getInstance().programChanges;
+				totalTextures += RenderStats::getInstance().textureBinds;
+				totalVaos += RenderStats::getInstance().vaoBinds;
+				totalLights += RenderStats::getInstance().pointLights;
+				totalLightIndices += RenderStats::getInstance().clusterLightIndices;
+			}
+		}
+		result.drawCalls = (double)totalDrawCalls / settings.frames;
+		result.triangles = (double)totalTriangles / settings.frames;
+		result.meshesDrawn = (double)totalDrawn / settings.frames;
+		result.meshesCulled = (double)totalCulled / settings.frames;
+		result.programChanges = (double)totalPrograms / settings.frames;
+		result.textureBinds = (double)totalTextures / settings.frames;
+		result.vaoBinds = (double)totalVaos / settings.frames;
+		result.pointLights = (double)totalLights / settings.frames;
+		result.clusterLightIndices = (double)totalLightIndices / settings.frames;
+
+		if (!settings.capture.empty()) {
+			captureFrame(context, settings.capture + std::to_string(map) + ".ppm");
+		}
+		results.push_back(result);
+	}
+
+	GLenum error = glGetError();
+	if (error != GL_NO_ERROR) {
+		std::cerr << "GL error after benchmark: 0x" << std::hex << error << std::dec << std::endl;
+	}
+
+	writeReport(report, settings, context.rendererName(), contextMs, sceneLoadMs, startupMs, assetsReadyMs, results);
+
+	return error == GL_NO_ERROR ? 0 : 1;
+}
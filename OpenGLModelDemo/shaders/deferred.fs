@@ -0,0 +1,45 @@
+#version 330 core
+
+// Deferred osvetljenje: jednom po pikselu, iz G-buffer-a (gbuffer.glsl), sa istim svetlima i klasterima
+// kao forward shaderi. Cena zavisi od broja piksela i svetala u njihovim klasterima, ne od toga
+// koliko povrsina se preklapa na pikselu.
+
+#include "lights.glsl"
+#include "phong.glsl"
+
+uniform sampler2D gDiffuse;
+uniform sampler2D gSpecular;
+uniform sampler2D gNormal;
+uniform sampler2D gDepth;
+
+// iz NDC nazad u view space
+uniform mat4 inverseProjection;
+// 1 / velicina viewport-a u pikselima
+uniform vec2 pixelSize;
+
+out vec4 FragColor;
+
+void main() {
+	ivec2 pixel = ivec2(gl_FragCoord.xy);
+
+	// pozadinu (dubina 1) je vec odbacio test dubine, GBuffer::resolve()
+	float depth = texelFetch(gDepth, pixel, 0).r;
+
+	vec4 diffuseTex = texelFetch(gDiffuse, pixel, 0);
+	vec4 normal = texelFetch(gNormal, pixel, 0);
+
+	// izvor svetla, bez osvetljenja
+	if (normal.w == 0.0) {
+		FragColor = vec4(diffuseTex.rgb, 1.0f);
+		return;
+	}
+
+	vec4 specularTex = texelFetch(gSpecular, pixel, 0);
+
+	vec4 viewPos = inverseProjection * vec4(gl_FragCoord.xy * pixelSize * 2.0 - 1.0, depth * 2.0 - 1.0, 1.0);
+	vec3 fragPos = viewPos.xyz / viewPos.w;
+
+	// final phong light
+	vec3 phong = calcLighting(normal.xyz, fragPos, gl_FragCoord.xy, diffuseTex, specularTex, specularTex.a * 255.0);
+	FragColor = vec4(phong, 1.0f);
+}
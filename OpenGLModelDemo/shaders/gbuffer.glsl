@@ -0,0 +1,21 @@
+// Izlazi G-buffer prolaza (GBuffer.h), za shadere kompajlirane sa GBUFFER. Svetla racuna deferred.fs.
+//   0: difuzna boja (rgb)
+//   1: specular boja (rgb), shininess / 255 (a)
+//   2: view-space normala (xyz), 1 = osvetljena povrsina, 0 = izvor svetla koji samo ima svoju boju (w)
+// Pozicija se ne pise, deferred.fs je vraca iz dubine.
+
+layout(location = 0) out vec4 GDiffuse;
+layout(location = 1) out vec4 GSpecular;
+layout(location = 2) out vec4 GNormal;
+
+void writeSurface(vec3 normal, vec4 diffuseTex, vec4 specularTex, float shininess) {
+	GDiffuse = vec4(vec3(diffuseTex), 1.0);
+	GSpecular = vec4(vec3(specularTex), shininess / 255.0);
+	GNormal = vec4(normalize(normal), 1.0);
+}
+
+void writeEmissive(vec3 color) {
+	GDiffuse = vec4(color, 1.0);
+	GSpecular = vec4(0.0);
+	GNormal = vec4(0.0);
+}
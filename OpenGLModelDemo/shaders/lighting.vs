@@ -1,10 +1,44 @@
 #version 330 core
 
+#ifdef PACKED_VERTICES
+// PackedVertex: pozicija u [0, 1] unutar kutije modela, octahedral normala, UV iz half float-a
+layout(location = 0) in vec3 aPackedPos;
+layout(location = 1) in vec2 aPackedNormal;
+layout(location = 2) in vec2 aTexCoords;
+
+uniform vec3 positionOffset;
+uniform vec3 positionScale;
+
+vec3 octahedralDecode(vec2 e) {
+	vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+	if (n.z < 0.0) {
+		n.xy = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+	}
+	return normalize(n);
+}
+#else
 layout(location = 0) in vec3 aPos;
 layout(location = 1) in vec3 aNormal;
 layout(location = 2) in vec2 aTexCoords;
+#endif
 
+#ifdef INSTANCED
+// per-instance model matrica (zauzima lokacije 3-6), indeks difuzne teksture
+// i view-space normal matrica, izracunata na CPU-u (TransformKernels)
+layout(location = 3) in mat4 aModel;
+layout(location = 7) in vec4 aInstanceData;
+layout(location = 8) in mat3 aNormalMatrix;
+
+flat out float DiffuseIndex;
+#else
 uniform mat4 model;
+#endif
+#ifdef MATERIAL_LAYERS
+// slojevi difuzne i specular teksture materijala (Mesh::MATERIAL_LAYERS_ATTRIBUTE)
+layout(location = 11) in vec2 aMaterialLayers;
+
+flat out vec2 MaterialLayers;
+#endif
 uniform mat4 view;
 uniform mat4 projection;
 
@@ -16,10 +50,25 @@ out vec3 LightPos;
 out vec2 TexCoords;
 
 void main() {
+#ifdef PACKED_VERTICES
+	vec3 aPos = positionOffset + aPackedPos * positionScale;
+	vec3 aNormal = octahedralDecode(aPackedNormal);
+#endif
+#ifdef INSTANCED
+	mat4 model = aModel;
+	DiffuseIndex = aInstanceData.x;
+#endif
 	FragPos =  vec3(view * model * vec4(aPos, 1.0f));
 	// normal matrix, allows non-uniform scaling
+#ifdef INSTANCED
+	Normal = aNormalMatrix * aNormal;
+#else
 	Normal = mat3(transpose(inverse(view*model))) * aNormal;
+#endif
 	TexCoords = aTexCoords;
+#ifdef MATERIAL_LAYERS
+	MaterialLayers = aMaterialLayers;
+#endif
 
 	gl_Position = projection * vec4(FragPos, 1.0f);
 }
\ No newline at end of file
@@ -0,0 +1,88 @@
+// Svetla za lighting.fs i lightingNoPoints.fs (LightBuffer.h). Directional i spot su u std140 uniform bloku,
+// point svetla u texture buffer-ima, po klasterima pogleda (LightClusters.h).
+// Members are ordered so every float fills the padding after a vec3;
+// the C++ structs in LightBuffer.h must match this layout exactly.
+
+// moraju da se slazu sa LightClusters::TILES_X, TILES_Y i SLICES
+#define CLUSTER_TILES_X 16
+#define CLUSTER_TILES_Y 9
+#define CLUSTER_SLICES 24
+
+// point lights. small, fragments
+struct PointLight {
+	vec3 position;
+	float constant;
+
+	vec3 ambient;
+	float linear;
+
+	vec3 diffuse;
+	float quadratic;
+
+	vec3 specular;
+	// dalje od ovoga svetlo se ne racuna
+	float radius;
+};
+
+// directional light (global light)
+struct DirectionLight {
+	vec3 ambient;
+	vec3 diffuse;
+	vec3 specular;
+
+	vec3 direction;
+};
+
+// flashlight, two cones
+// inner cone is 100% intensity, outer cone fading
+struct SpotLight {
+	vec3 position;
+	float constant;
+
+	vec3 direction;
+	float linear;
+
+	vec3 ambient;
+	float quadratic;
+
+	vec3 diffuse;
+	float innerCosAngle;
+
+	vec3 specular;
+	float outerCosAngle;
+
+	// koristi se za flashlight
+	bool on;
+};
+
+layout(std140) uniform Lights {
+	DirectionLight directionLight;
+	SpotLight spotLight;
+	// xy: plocica po pikselu, zw: sloj dubine = log(dubina) * z + w
+	vec4 clusterScale;
+};
+
+// PointLightData po 4 texela, klaster kao (prvi indeks u clusterLights, broj svetala), indeksi svetala
+uniform samplerBuffer pointLightData;
+uniform usamplerBuffer clusterCells;
+uniform usamplerBuffer clusterLights;
+
+PointLight pointLight(int index) {
+	vec4 t0 = texelFetch(pointLightData, index * 4);
+	vec4 t1 = texelFetch(pointLightData, index * 4 + 1);
+	vec4 t2 = texelFetch(pointLightData, index * 4 + 2);
+	vec4 t3 = texelFetch(pointLightData, index * 4 + 3);
+	return PointLight(t0.xyz, t0.w, t1.xyz, t1.w, t2.xyz, t2.w, t3.xyz, t3.w);
+}
+
+// klaster fragmenta; viewDepth je -z u view space-u
+uvec2 lightCluster(vec2 fragCoord, float viewDepth) {
+	ivec2 tile = min(ivec2(fragCoord * clusterScale.xy), ivec2(CLUSTER_TILES_X - 1, CLUSTER_TILES_Y - 1));
+	int slice = clamp(int(floor(log(viewDepth) * clusterScale.z + clusterScale.w)), 0, CLUSTER_SLICES - 1);
+	return texelFetch(clusterCells, (slice * CLUSTER_TILES_Y + tile.y) * CLUSTER_TILES_X + tile.x).xy;
+}
+
+// index-ti point svetlo klastera
+int clusterLight(uvec2 cluster, uint index) {
+	return int(texelFetch(clusterLights, int(cluster.x + index)).r);
+}
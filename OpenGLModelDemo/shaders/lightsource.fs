@@ -1,11 +1,30 @@
 #version 330 core
 
+#ifdef GBUFFER
+// boja ide u G-buffer kao izvor svetla, deferred.fs je prepisuje bez osvetljenja
+#include "gbuffer.glsl"
+#else
 out vec4 FragColor;
+#endif
 
+#ifdef INSTANCED
+flat in vec3 InstanceColor;
+#else
 uniform vec3 lightColor;
+#endif
 
 void main() {
 
-	FragColor = vec4(lightColor, 1.0f);
+#ifdef INSTANCED
+	vec3 color = InstanceColor;
+#else
+	vec3 color = lightColor;
+#endif
 
-}
\ No newline at end of file
+#ifdef GBUFFER
+	writeEmissive(color);
+#else
+	FragColor = vec4(color, 1.0f);
+#endif
+
+}
@@ -2,11 +2,23 @@
 
 layout(location = 0) in vec3 aPos;
 
+#ifdef INSTANCED
+// per-instance model matrica (lokacije 3-6) i boja svetla
+layout(location = 3) in mat4 aModel;
+layout(location = 7) in vec4 aInstanceData;
+
+flat out vec3 InstanceColor;
+#else
 uniform mat4 model;
+#endif
 uniform mat4 view;
 uniform mat4 projection;
 
 
 void main() {
+#ifdef INSTANCED
+	mat4 model = aModel;
+	InstanceColor = aInstanceData.rgb;
+#endif
 	gl_Position = projection * view * model * vec4(aPos, 1.0f);
 }
\ No newline at end of file
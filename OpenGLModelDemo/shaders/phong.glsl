@@ -0,0 +1,100 @@
+// Phong osvetljenje, zajednicko za forward shadere (lighting.fs, lightingNoPoints.fs) i deferred
+// prolaz (deferred.fs). Ide posle lights.glsl. Sve je u view space-u, kamera je u (0, 0, 0).
+
+vec3 calcPointLight(PointLight light, vec3 normal, vec3 fragPos, vec4 diffuseTex, vec4 specularTex, float shininess) {
+
+	float distance = length(light.position - fragPos);
+	if (distance > light.radius) {
+		return vec3(0.0);
+	}
+	float attenuation = 1.0 / (light.constant + light.linear * distance + light.quadratic * pow(distance, 2));
+
+	vec3 ambient;
+	ambient = light.ambient * vec3(diffuseTex);
+
+	vec3 diffuse;
+	vec3 nNormal = normalize(normal);
+	vec3 directionToLight = normalize(light.position - fragPos);
+	float diffuseComponent = max(dot(directionToLight, nNormal), 0.0);
+	diffuse = light.diffuse * diffuseComponent * vec3(diffuseTex);
+
+	vec3 specular;
+	vec3 directionToCamera = normalize(-fragPos);
+	vec3 perfectRayReflection = reflect(-directionToLight, nNormal);
+	float specularComponent = pow(max(dot(perfectRayReflection, directionToCamera), 0.0), shininess);
+	specular = light.specular * specularComponent * vec3(specularTex);
+
+	vec3 phong = (ambient + diffuse + specular) * attenuation;
+	return phong;
+}
+
+vec3 calcDirectionLight(DirectionLight light, vec3 normal, vec3 fragPos, vec4 diffuseTex, vec4 specularTex, float shininess) {
+	vec3 ambient;
+	ambient = light.ambient * vec3(diffuseTex);
+
+	vec3 diffuse;
+	vec3 nNormal = normalize(normal);
+	vec3 directionToLight = normalize(-light.direction);
+	float diffuseComponent = max(dot(directionToLight, nNormal), 0.0);
+	diffuse = light.diffuse * diffuseComponent * vec3(diffuseTex);
+
+	vec3 specular;
+	vec3 directionToCamera = normalize(-fragPos);
+	vec3 perfectRayReflection = reflect(-directionToLight, nNormal);
+	float specularComponent = pow(max(dot(perfectRayReflection, directionToCamera), 0.0), shininess);
+	specular = light.specular * specularComponent * vec3(specularTex);
+
+	vec3 phong = ambient + diffuse + specular;
+	return phong;
+}
+
+vec3 calcSpotLight(SpotLight light, vec3 normal, vec3 fragPos, vec4 diffuseTex, vec4 specularTex, float shininess) {
+
+	if (light.on == false) {
+		return vec3(0.0);
+	}
+
+	vec3 ambient;
+	ambient = light.ambient * vec3(diffuseTex);
+
+	vec3 diffuse;
+	vec3 nNormal = normalize(normal);
+	vec3 directionToLight = normalize(light.position - fragPos);
+	float diffuseComponent = max(dot(directionToLight, nNormal), 0.0);
+	diffuse = light.diffuse * diffuseComponent * vec3(diffuseTex);
+
+	vec3 specular;
+	vec3 directionToCamera = normalize(-fragPos);
+	vec3 perfectRayReflection = reflect(-directionToLight, nNormal);
+	float specularComponent = pow(max(dot(perfectRayReflection, directionToCamera), 0.0), shininess);
+	specular = light.specular * specularComponent * vec3(specularTex);
+
+	float intensity;
+	float fragAngle = dot(normalize(light.direction), normalize(-directionToLight));
+	float softening = (fragAngle - light.outerCosAngle) / (light.innerCosAngle - light.outerCosAngle);
+	intensity = clamp(softening, 0.0, 1.0);
+
+	float distance = length(light.position - fragPos);
+	float attenuation = 1.0 / (light.constant + light.linear * distance + light.quadratic * distance * distance);
+
+	vec3 phong = (ambient + (diffuse + specular) * intensity) * attenuation;
+	return phong;
+}
+
+// Sva svetla u tacki: directional, point svetla klastera (fragCoord = gl_FragCoord.xy) i flashlight.
+vec3 calcLighting(vec3 normal, vec3 fragPos, vec2 fragCoord, vec4 diffuseTex, vec4 specularTex, float shininess) {
+
+	vec3 directionalLighting = calcDirectionLight(directionLight, normal, fragPos, diffuseTex, specularTex, shininess);
+
+	vec3 pointLighting = vec3(0.0);
+	// samo svetla koja dodiruju klaster ovog fragmenta
+	uvec2 cluster = lightCluster(fragCoord, -fragPos.z);
+	for (uint i = 0u; i < cluster.y; i++) {
+		pointLighting += calcPointLight(pointLight(clusterLight(cluster, i)), normal, fragPos, diffuseTex, specularTex, shininess);
+	}
+
+	vec3 spotLighting = calcSpotLight(spotLight, normal, fragPos, diffuseTex, specularTex, shininess);
+
+	// final phong light
+	return directionalLighting + pointLighting + spotLighting;
+}